@@ -4,6 +4,8 @@
 
 #include <constant/callback.h>
 #include <data/allocator.h>
+#include <data/codec.h>
+#include <data/file.h>
 #include <data/memory.h>
 
 /**
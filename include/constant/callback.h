@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
 /**
  * @file callback.h
  * @brief Store mappings/reducing callbacks.
@@ -165,6 +169,114 @@ namespace algorep
       L_POW,
     };
 
+    ///////////////////////////////////////////////////////////////////////////
+    // PARAMETERIZED MAP KERNELS
+    ///////////////////////////////////////////////////////////////////////////
+
+    /**
+     * @brief Number of parameters sent with a parameterized kernel.
+     */
+    constexpr size_t MAX_PARAMS = 4;
+
+    /**
+     * @brief Map parameterized kernels to integers. Parameters have the
+     * type of the mapped values, and missing ones are 0.
+     */
+    enum MapParamID
+    {
+      // x = p0 * x + p1
+      AFFINE = 0,
+      // x = min(max(x, p0), p1)
+      CLAMP,
+      // x = (x >= p0) ? p1 : p2
+      THRESHOLD,
+      // x = x^p0, a negative exponent gives 1 for integers
+      POWER,
+    };
+
+    /**
+     * @brief Map rolling aggregates to integers. The window of a position
+     * ends on it, and is shorter at the start of the element.
+     */
+    enum RollingID
+    {
+      ROLLING_SUM = 0,
+      // Computed in the type of the values.
+      ROLLING_MEAN,
+      ROLLING_MIN,
+      ROLLING_MAX,
+    };
+
+    namespace
+    {
+      /**
+       * @brief Raise an integer to a power, by squaring.
+       */
+      template <typename T>
+      T
+      raise(T a, T exponent, std::true_type)
+      {
+        T result = 1;
+        for (; exponent > 0; exponent /= 2, a *= a)
+          if (exponent % 2) result *= a;
+        return result;
+      }
+
+      /**
+       * @brief Raise a floating value to a power.
+       */
+      template <typename T>
+      T
+      raise(T a, T exponent, std::false_type)
+      {
+        return std::pow(a, exponent);
+      }
+    }
+
+    /**
+     * @brief Apply a parameterized kernel on values. Each kernel is a
+     * loop without dependencies between values.
+     *
+     * @tparam T Numeric type.
+     * @param kernel_id Kernel to apply (see `MapParamID`).
+     * @param params `MAX_PARAMS` parameters of the kernel.
+     * @param data Values to process in place.
+     * @param nb_values Number of values.
+     *
+     * @return False if the kernel is unknown.
+     */
+    template <typename T>
+    bool
+    mapParams(unsigned int kernel_id, const T* params, T* data,
+              size_t nb_values)
+    {
+      const T p0 = params[0];
+      const T p1 = params[1];
+      const T p2 = params[2];
+      switch (kernel_id)
+      {
+        case MapParamID::AFFINE:
+          for (size_t i = 0; i < nb_values; ++i) data[i] = p0 * data[i] + p1;
+          return true;
+        case MapParamID::CLAMP:
+          for (size_t i = 0; i < nb_values; ++i)
+          {
+            const T a = (data[i] < p0) ? p0 : data[i];
+            data[i] = (a > p1) ? p1 : a;
+          }
+          return true;
+        case MapParamID::THRESHOLD:
+          for (size_t i = 0; i < nb_values; ++i)
+            data[i] = (data[i] >= p0) ? p1 : p2;
+          return true;
+        case MapParamID::POWER:
+          for (size_t i = 0; i < nb_values; ++i)
+            data[i] = raise(data[i], p0, std::is_integral<T>());
+          return true;
+      }
+      return false;
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     // REDUCE CALLBACKS
     ///////////////////////////////////////////////////////////////////////////
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 /**
  * @file constants.h
  * @brief Define constants used in the project.
@@ -17,6 +19,11 @@ namespace algorep
      */
     constexpr static unsigned int ID_LEN = 23;
 
+    /**
+     * @brief Maximum size for a path sent to the slaves.
+     */
+    constexpr static unsigned int PATH_LEN = 256;
+
     /**
      * @brief Code sent in case of failure.
      */
@@ -1,11 +1,24 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <unordered_map>
 #include <vector>
 
 #include <constant/callback.h>
+#include <data/config.h>
+#include <data/file.h>
 #include <data/element.h>
+#include <data/fields.h>
+#include <data/hash_sketch.h>
+#include <data/operation.h>
+#include <data/sketch.h>
+#include <data/statistics.h>
+#include <data/status.h>
+#include <data/summation.h>
+#include <data/table.h>
+#include <data/transfer.h>
+#include <data/zone_map.h>
 
 /**
  * @file allocator.h
@@ -17,6 +30,14 @@
 
 namespace algorep
 {
+  namespace
+  {
+    /**
+     * @brief Contains the node rank, and the bounds of a chunk of data.
+     */
+    using Placement = std::tuple<unsigned int, size_t, size_t>;
+  }
+
   /**
    * @brief Singleton.
    */
@@ -37,9 +58,6 @@ namespace algorep
     }
 
     public:
-    // TODO: add equivalent of malloc / calloc.
-    // For now, you are obliged to use a typed allocation,
-    // it would be nice to only allocate space in bytes.
     /**
      * @brief Reserve shared memory.
      *
@@ -53,6 +71,114 @@ namespace algorep
     Element<T>*
     reserve(size_t nb_elements, const T* elt);
 
+    /**
+     * @brief Reserve shared memory, without sending any data. Slaves only
+     * receive the size of their chunk, and leave its values uninitialized.
+     *
+     * @tparam T Type of element.
+     * @param nb_elements Number of elements to reserve space for.
+     *
+     * @return Wrapping Element on location etc.
+     */
+    template <typename T>
+    Element<T>*
+    reserveUninitialized(size_t nb_elements);
+
+    /**
+     * @brief Reserve shared memory placed as another element: chunks have
+     * the same bounds, on the same slaves. Nothing but the size of the
+     * chunks is sent, and their values are left uninitialized.
+     *
+     * @tparam T Type of element.
+     * @param elt Element whose placement is copied.
+     *
+     * @return Wrapping Element on location etc, nullptr if a slave does
+     * not have the memory.
+     */
+    template <typename T>
+    Element<T>*
+    reserveLike(const BaseElement* elt);
+
+    /**
+     * @brief Reserve shared memory, filled by slaves with a single value.
+     * This is the equivalent of calloc, with any value.
+     *
+     * @tparam T Type of element.
+     * @param nb_elements Number of elements to reserve space for.
+     * @param value Value copied in every element.
+     *
+     * @return Wrapping Element on location etc.
+     */
+    template <typename T>
+    Element<T>*
+    reserveFilled(size_t nb_elements, const T& value);
+
+    /**
+     * @brief Reserve shared memory in bytes. This is the equivalent of
+     * malloc. The result can then be seen as typed using `view`.
+     *
+     * @param nb_bytes Number of bytes to reserve.
+     * @param alignment Every chunk starts on a multiple of this value,
+     * this should be a multiple of the size of the types used in views.
+     *
+     * @return Wrapping Element on location etc.
+     */
+    Element<uint8_t>*
+    reserveBytes(size_t nb_bytes, size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief Reserve shared memory filled from a binary file. Each slave
+     * reads its own part of the file, nothing goes through the master.
+     * The file has to be reachable by every slave.
+     *
+     * @tparam T Type of element.
+     * @param path File to read. It may start with a `FileHeader`, whose
+     * atom size has to match the size of T.
+     * @param offset Index of the first element to read.
+     * @param nb_elements Number of elements to read, 0 to read every
+     * element following the offset.
+     *
+     * @return Wrapping Element on location etc, nullptr if the file can not
+     * be read or is too small.
+     */
+    template <typename T>
+    Element<T>*
+    reserveFromFile(const std::string& path, size_t offset = 0,
+                    size_t nb_elements = 0);
+
+    /**
+     * @brief See the chunks of an element as an array of another type.
+     * Nothing is sent on the network, and the view shares the memory of
+     * `elt`: it is invalidated as soon as `elt` is freed.
+     *
+     * @tparam T Type of element of the view.
+     * @param elt Element to view.
+     *
+     * @return View to free using `free`, nullptr if a chunk of `elt` would
+     * split an element of type T.
+     */
+    template <typename T>
+    Element<T>*
+    view(const BaseElement* elt);
+
+    /**
+     * @brief Allocate a sparse element. Slaves only store the non-zero
+     * values with their positions, and chunks are placed according to
+     * the number of values they store.
+     *
+     * @tparam T Type of element.
+     * @param nb_elements Number of elements, zeros included.
+     * @param indices Positions of the non-zero values, strictly increasing.
+     * @param values Non-zero values, one per position.
+     *
+     * @return Element allocated, nullptr if a position is out of bounds
+     * or if the network is full.
+     */
+    template <typename T>
+    Element<T>*
+    reserveSparse(size_t nb_elements, const std::vector<size_t>& indices,
+                  const T* values);
+
     /**
      * @brief Read shared memory.
      *
@@ -79,6 +205,263 @@ namespace algorep
     bool
     write(const Element<T>* elt, const T* data, size_t nb_elts = 0);
 
+    /**
+     * @brief Read the non-zero values of an element. The chunks of a dense
+     * element are read entirely, and filtered by the master.
+     *
+     * @tparam T Type of element.
+     * @param elt Element to read.
+     * @param indices Filled with the positions of the non-zero values.
+     * @param values Filled with the non-zero values.
+     */
+    template <typename T>
+    void
+    readSparse(const Element<T>* elt, std::vector<size_t>& indices,
+               std::vector<T>& values);
+
+    /**
+     * @brief Allocate records stored as one column per field on the
+     * slaves. The fields of T have to be registered with `ALGOREP_FIELDS`.
+     *
+     * @tparam T Type of record.
+     * @param nb_elements Number of records.
+     * @param records Records to send.
+     *
+     * @return Element allocated, nullptr if the network is full.
+     */
+    template <typename T>
+    Element<T>*
+    reserveColumns(size_t nb_elements, const T* records);
+
+    /**
+     * @brief Read a single field of records stored by columns. Only the
+     * column of the field is sent by the slaves.
+     *
+     * @tparam T Type of record.
+     * @tparam F Type of the field.
+     * @param elt Element to read.
+     * @param member Field to read.
+     *
+     * @return Field of every record, nullptr if the element is not stored
+     * by columns or if the field is not registered.
+     */
+    template <typename T, typename F>
+    F*
+    readField(const Element<T>* elt, F T::*member);
+
+    /**
+     * @brief Allocate a matrix, split between the slaves on whole rows.
+     *
+     * @tparam T Type of element.
+     * @param nb_rows Number of rows.
+     * @param nb_cols Number of values of a row.
+     * @param data Values to send, row after row.
+     * @param layout Policy placing the rows on the slaves.
+     *
+     * @return Matrix allocated, nullptr if the network is full.
+     */
+    template <typename T>
+    Matrix<T>*
+    reserveMatrix(size_t nb_rows, size_t nb_cols, const T* data,
+                  Layout layout = Layout::BALANCED);
+
+    /**
+     * @brief Allocate an empty hash table, having one partition on every
+     * slave. Values are mapped, reduced and read as the field
+     * `&Entry<K, V>::value`, keys must not be mapped.
+     *
+     * @tparam K Integer type of the keys.
+     * @tparam V Type of the values.
+     *
+     * @return Table allocated, nullptr if a slave failed.
+     */
+    template <typename K, typename V>
+    Table<K, V>*
+    reserveTable();
+
+    /**
+     * @brief Insert or replace entries of a table. Keys are grouped by
+     * partition, and each slave receives a single message.
+     *
+     * @tparam K Integer type of the keys.
+     * @tparam V Type of the values.
+     * @param table Table to update.
+     * @param keys Keys to set, the last value of a repeated key is kept.
+     * @param values Value of every key.
+     *
+     * @return False if a slave was full, nothing being inserted in its
+     * partition.
+     */
+    template <typename K, typename V>
+    bool
+    put(Table<K, V>* table, const std::vector<K>& keys,
+        const std::vector<V>& values);
+
+    /**
+     * @brief Look some keys up in a table. Keys are grouped by partition,
+     * and each slave receives a single message.
+     *
+     * @tparam K Integer type of the keys.
+     * @tparam V Type of the values.
+     * @param table Table to read.
+     * @param keys Keys to find.
+     * @param values Filled with the value of every key, V() if missing.
+     * @param found Filled with whether every key is in the table.
+     *
+     * @return Number of keys found.
+     */
+    template <typename K, typename V>
+    size_t
+    get(const Table<K, V>* table, const std::vector<K>& keys,
+        std::vector<V>& values, std::vector<bool>& found);
+
+    /**
+     * @brief Remove entries of a table. Keys are grouped by partition, and
+     * each slave receives a single message.
+     *
+     * @tparam K Integer type of the keys.
+     * @tparam V Type of the values.
+     * @param table Table to update.
+     * @param keys Keys to remove, missing ones being ignored.
+     *
+     * @return Number of entries removed.
+     */
+    template <typename K, typename V>
+    size_t
+    erase(Table<K, V>* table, const std::vector<K>& keys);
+
+    /**
+     * @brief Read some elements of shared memory, given their indices.
+     * A single message is sent to each slave owning one of the elements.
+     *
+     * @tparam T Type of element.
+     * @param elt Where to read.
+     * @param indices Indices of the elements to read.
+     *
+     * @return Pointer on the values, in the order of `indices`, nullptr if
+     * an index is out of bounds.
+     */
+    template <typename T>
+    T*
+    gather(const Element<T>* elt, const std::vector<size_t>& indices);
+
+    /**
+     * @brief Write some elements of shared memory, given their indices.
+     * A single message is sent to each slave owning one of the elements.
+     *
+     * @tparam T Type of element.
+     * @param elt Where to write.
+     * @param indices Indices of the elements to write.
+     * @param values Values to write, in the order of `indices`.
+     *
+     * @return Whether the operation was successul.
+     */
+    template <typename T>
+    bool
+    scatter(const Element<T>* elt, const std::vector<size_t>& indices,
+            const T* values);
+
+    /**
+     * @brief Append elements at the end of shared memory. The last chunk is
+     * grown in place when possible, and the remaining elements are placed
+     * in new chunks on other nodes. Capacities grow geometrically.
+     *
+     * @tparam T Type of element.
+     * @param elt Where to append.
+     * @param data Value(s) to append.
+     * @param nb_elts Number of elements to append from data.
+     *
+     * @return Whether the operation was successul. Nothing is appended
+     * when the network is full.
+     */
+    template <typename T>
+    bool
+    append(Element<T>* elt, const T* data, size_t nb_elts);
+
+    /**
+     * @brief Change the number of elements of shared memory. New elements
+     * are set to zero, and chunks that are not used anymore are freed.
+     *
+     * @tparam T Type of element.
+     * @param elt What to resize.
+     * @param nb_elts New number of elements.
+     *
+     * @return Whether the operation was successul.
+     */
+    template <typename T>
+    bool
+    resize(Element<T>* elt, size_t nb_elts);
+
+    /**
+     * @brief Copy an element into another one. Slaves send their chunks
+     * directly to each other, the master only sends the transfers to do.
+     *
+     * @tparam T Type of element.
+     * @param src What to copy.
+     * @param dst Where to copy, starting at its first element.
+     *
+     * @return Whether the operation was successul, `dst` should be at
+     * least as large as `src`.
+     */
+    template <typename T>
+    bool
+    copy(const Element<T>* src, Element<T>* dst);
+
+    /**
+     * @brief Move the data of an element to new chunks, placed using
+     * the given policy. Slaves send their chunks directly to each other.
+     * The network should have enough free memory to store a second copy
+     * of the element during the operation.
+     *
+     * @param elt What to move.
+     * @param layout Placement policy of the new chunks.
+     *
+     * @return Whether the operation was successul, `elt` is unchanged
+     * otherwise.
+     */
+    bool
+    repartition(BaseElement* elt, Layout layout);
+
+    /**
+     * @brief Save every element in a directory. Each slave writes its own
+     * chunks in a separate file, while the master writes the metadata
+     * of the elements. Only dense elements are saved, sparse and columnar
+     * elements, tables and matrices not being rebuilt by `restore`.
+     *
+     * @param dir Directory reachable by every node, created if needed.
+     *
+     * @return Whether every file has been written, false without writing
+     * anything if an element can not be saved.
+     */
+    bool
+    checkpoint(const std::string& dir);
+
+    /**
+     * @brief Rebuild the elements saved by `checkpoint`, possibly in
+     * another run having the same number of nodes. Each slave maps its
+     * own file, and copies its chunks back.
+     *
+     * @param dir Directory given to `checkpoint`.
+     *
+     * @return Restored elements, in their order of allocation. They can
+     * be typed using `view`, and have to be freed using `free`. Empty on
+     * failure, or if elements are already allocated.
+     */
+    std::vector<BaseElement*>
+    restore(const std::string& dir);
+
+    /**
+     * @brief Move every element that can be stored in fewer chunks. Chunks
+     * are placed on the slaves having the most free memory first, which
+     * also moves data toward the least loaded slaves. Elements keep their
+     * address, but views and prepared operations on moved elements have
+     * to be built again.
+     *
+     * @return Number of moved elements.
+     */
+    size_t
+    rebalance();
+
     /**
      * @brief Free the passed argument and the underlying shared memory.
      *
@@ -94,7 +477,9 @@ namespace algorep
      * @param elt What to map.
      * @param callback_id Callback to use.
      *
-     * @return Pointer to this instance.
+     * @return Pointer to this instance, nullptr if a chunk could not be
+     * mapped, such as a sparse chunk with a callback not keeping zeros.
+     * The other chunks are still mapped.
      */
     template <typename T>
     Allocator*
@@ -114,81 +499,1094 @@ namespace algorep
     T*
     reduce(const Element<T>* elt, unsigned int callback_id, T init_val = 0);
 
-    public:
     /**
-     * @brief Get current memory status per node.
+     * @brief Apply mapping callback on a single field of records stored
+     * by columns.
      *
-     * @return Current available memory per node.
+     * @tparam T Type of record.
+     * @tparam F Type of the field.
+     * @param elt What to map.
+     * @param member Field to map.
+     * @param callback_id Callback to use.
+     *
+     * @return Pointer to this instance, nullptr if a chunk could not be
+     * mapped.
      */
-    inline const std::vector<unsigned long long>&
-    getMemoryStatus() const
-    {
-      return this->memory_per_node_;
-    }
+    template <typename T, typename F>
+    Allocator*
+    mapField(const Element<T>* elt, F T::*member, unsigned int callback_id);
 
     /**
-     * @brief Set the maximum memory per node.
+     * @brief Apply a parameterized kernel on shared memory. Parameters are
+     * sent with the request, so that no callback has to be written per
+     * constant.
      *
-     * @param nb_bytes Maximum number of bytes per node.
+     * @tparam T Type of element.
+     * @param elt What to map.
+     * @param kernel_id Kernel to apply (see `callback::MapParamID`).
+     * @param params Parameters of the kernel, at most `MAX_PARAMS`.
+     *
+     * @return Pointer on the allocator, nullptr if a chunk could not be
+     * mapped: the kernel is unknown, or changes the zeros of a sparse
+     * chunk. The other chunks are still mapped.
      */
-    inline void
-    setMaxMemory(size_t nb_bytes)
-    {
-      this->max_memory_ = nb_bytes;
-    }
+    template <typename T>
+    Allocator*
+    mapParam(const Element<T>* elt, unsigned int kernel_id,
+             const std::vector<T>& params);
 
     /**
-     * @brief Set the number of nodes in the network with an initial amount
-     * of memory.
+     * @brief Apply reducing callback on a single field of records stored
+     * by columns.
      *
-     * @param nb_nodes Number of nodes in the network.
+     * @tparam T Type of record.
+     * @tparam F Type of the field.
+     * @param elt What to reduce.
+     * @param member Field to reduce.
+     * @param callback_id Callback to use.
+     * @param init_val Default value for the accumulator.
+     *
+     * @return Pointer to result value, nullptr if the element is not
+     * stored by columns or if the field is not registered.
      */
-    inline void
-    setNbNodes(int nb_nodes)
-    {
-      this->nb_nodes_ = nb_nodes;
-      for (int i = 0; i < nb_nodes_; ++i)
-        this->memory_per_node_.push_back(this->max_memory_);
-    }
+    template <typename T, typename F>
+    F*
+    reduceField(const Element<T>* elt, F T::*member, unsigned int callback_id,
+                F init_val = 0);
 
     /**
-     * @brief Get the number of nodes in the network.
+     * @brief Compute the count, minimum, maximum, sum, mean and variance
+     * of an element in a single pass. Each slave describes its chunks,
+     * and the master merges their statistics.
      *
-     * @return Number of nodes in the network.
+     * @tparam T Type of element.
+     * @param elt What to describe.
+     *
+     * @return Statistics of the element.
      */
-    inline int
-    getNbNodes() const
-    {
-      return this->nb_nodes_;
-    }
+    template <typename T>
+    Statistics
+    describe(const Element<T>* elt);
 
-    private:
     /**
-     * @brief Constructor.
+     * @brief Compute the statistics of a single field of records stored
+     * by columns.
+     *
+     * @tparam T Type of record.
+     * @tparam F Type of the field.
+     * @param elt What to describe.
+     * @param member Field to describe.
+     *
+     * @return Statistics of the field, with a count of 0 if the element
+     * is not stored by columns or if the field is not registered.
      */
-    Allocator() : nb_nodes_(0), max_memory_(0) {}
+    template <typename T, typename F>
+    Statistics
+    describeField(const Element<T>* elt, F T::*member);
 
-    private:
     /**
-     * @brief Unique instance.
+     * @brief Find the k largest (or smallest) values of an element. Each
+     * slave only sends the k best values of its chunks.
+     *
+     * @tparam T Type of element.
+     * @param elt Where to look.
+     * @param k Number of values to find.
+     * @param indices Filled with the positions of the values.
+     * @param values Filled with the values, the best one first.
+     * @param largest Whether the largest values are looked for.
      */
-    static Allocator* instance_;
+    template <typename T>
+    void
+    topK(const Element<T>* elt, size_t k, std::vector<size_t>& indices,
+         std::vector<T>& values, bool largest = true);
 
-    private:
     /**
-     * @brief Number of nodes in the network.
+     * @brief Summarize the distribution of the values of an element, to
+     * estimate its quantiles. Each slave only sends the sketch of its
+     * chunks.
+     *
+     * @tparam T Type of element.
+     * @param elt What to summarize.
+     * @param accuracy Accuracy of the sketch (see `QuantileSketch`).
+     *
+     * @return Sketch of the values.
      */
-    int nb_nodes_;
+    template <typename T>
+    QuantileSketch
+    sketch(const Element<T>* elt, size_t accuracy = 200);
 
     /**
-     * @brief Maximum usable memory per node.
+     * @brief Estimate the number of distinct values of an integer element.
+     * Each slave only sends the HyperLogLog of its chunks.
+     *
+     * @tparam T Integer type of element.
+     * @param elt Where to count.
+     * @param precision Precision of the sketch (see `HyperLogLog`).
+     *
+     * @return Sketch of the values, see `HyperLogLog::estimate`.
      */
-    size_t max_memory_;
+    template <typename T>
+    HyperLogLog
+    distinctCount(const Element<T>* elt, unsigned int precision = 12);
 
     /**
-     * @brief Current available memory per node.
+     * @brief Build a Bloom filter holding the values of an integer element.
+     * Each slave only sends the filter of its chunks.
+     *
+     * @tparam T Integer type of element.
+     * @param elt Values to hold.
+     * @param false_positive Probability to find a value which is not in
+     * the element.
+     *
+     * @return Filter of the values.
      */
-    std::vector<unsigned long long> memory_per_node_;
+    template <typename T>
+    BloomFilter
+    bloom(const Element<T>* elt, double false_positive = 0.01);
+
+    /**
+     * @brief Test every value of an integer element against a Bloom filter.
+     * The filter is sent to the slaves, which write the result next to
+     * each chunk.
+     *
+     * @tparam T Integer type of element.
+     * @param elt Values to test.
+     * @param filter Filter, built by `bloom` from another element.
+     *
+     * @return Element having the same placement as `elt`, holding 1 where
+     * the value may be in the filter and 0 elsewhere. nullptr if the
+     * element is not dense or if the slaves do not have the memory.
+     */
+    template <typename T>
+    Element<uint8_t>*
+    filter(const Element<T>* elt, const BloomFilter& filter);
+
+    /**
+     * @brief Sum the values of a floating element, with compensated sums
+     * by blocks (see `summation`). The result only depends on the values,
+     * not on the placement of the chunks, and is more accurate than a
+     * reduce.
+     *
+     * @tparam T Either float or double.
+     * @param elt Element to sum.
+     *
+     * @return Sum of the values, computed in double.
+     */
+    template <typename T>
+    T
+    sum(const Element<T>* elt);
+
+    /**
+     * @brief Build the zone map of a dense element: the minimum, the
+     * maximum and the order of every chunk, in a single pass on each
+     * slave.
+     *
+     * @tparam T Type of element.
+     * @param elt Element to describe.
+     *
+     * @return Zone map, describing no chunk if the element is not dense.
+     */
+    template <typename T>
+    ZoneMap<T>
+    zoneMap(const Element<T>* elt);
+
+    /**
+     * @brief Count the values of a dense element in [low, high]. With a
+     * zone map, chunks outside of the range are skipped, chunks inside of
+     * it are counted by the master, and sorted chunks are binary searched.
+     * Other chunks are scanned by their slave.
+     *
+     * @tparam T Type of element.
+     * @param elt Element to query.
+     * @param low Lowest value counted.
+     * @param high Highest value counted.
+     * @param zones Zone map of the element, ignored if it describes other
+     * chunks, nullptr to scan every chunk.
+     *
+     * @return Number of values in the range, 0 if the element is not
+     * dense.
+     */
+    template <typename T>
+    size_t
+    rangeCount(const Element<T>* elt, const T& low, const T& high,
+               const ZoneMap<T>* zones = nullptr);
+
+    /**
+     * @brief Read the values of a dense element in [low, high], skipping
+     * chunks as `rangeCount` does. Only the values in the range are sent
+     * back.
+     *
+     * @tparam T Type of element.
+     * @param elt Element to query.
+     * @param low Lowest value read.
+     * @param high Highest value read.
+     * @param indices Filled with the positions of the values, in order.
+     * @param values Filled with the values.
+     * @param zones Zone map of the element, ignored if it describes other
+     * chunks, nullptr to scan every chunk.
+     */
+    template <typename T>
+    void
+    rangeRead(const Element<T>* elt, const T& low, const T& high,
+              std::vector<size_t>& indices, std::vector<T>& values,
+              const ZoneMap<T>* zones = nullptr);
+
+    /**
+     * @brief Apply a stencil on an element, out[i] being the sum of
+     * weights[k] * elt[i + k - h], with h = weights.size() / 2. Slaves
+     * exchange the h values at the bounds of their chunks directly with
+     * each other, while computing the rest of the chunks, and the master
+     * only waits for the last step. Values outside of the element repeat
+     * the first and the last values.
+     *
+     * @tparam T Type of element.
+     * @param elt Element to read.
+     * @param weights Weights of the stencil, an odd number of them.
+     * @param nb_steps Number of times the stencil is applied.
+     * @param out Element receiving the result, placed as `elt` (see
+     * `reserveLike`), nullptr to write the result in `elt`.
+     *
+     * @return False if an element is not dense, if `out` is not placed as
+     * `elt`, or if a chunk holds less than h values.
+     */
+    template <typename T>
+    bool
+    stencil(const Element<T>* elt, const std::vector<T>& weights,
+            size_t nb_steps = 1, const Element<T>* out = nullptr);
+
+    /**
+     * @brief Compute a rolling aggregate: the value at position i
+     * aggregates the values at [i - window + 1, i], windows being shorter
+     * at the start of the element. Each chunk sends the `window - 1`
+     * values preceding the next chunk to the slave holding it, taken from
+     * its own values and from the ones it received, so that windows may
+     * span several chunks.
+     *
+     * @tparam T Type of element.
+     * @param elt Element to read.
+     * @param window Number of values of a window.
+     * @param kind Aggregate to compute (see `callback::RollingID`).
+     *
+     * @return Element placed as `elt` holding the aggregates, nullptr if
+     * `elt` is not dense, if `window` is 0, or if the network is full.
+     */
+    template <typename T>
+    Element<T>*
+    rolling(const Element<T>* elt, size_t window, unsigned int kind);
+
+    /**
+     * @brief Multiply a matrix by a vector. The vector is read once and
+     * sent once to every slave holding rows, which compute their part of
+     * the result next to their rows.
+     *
+     * @tparam T Type of element.
+     * @param mat Matrix to multiply.
+     * @param vec Vector of `mat->getNbCols()` values.
+     *
+     * @return Result, holding one value per row next to the row, nullptr
+     * if the sizes do not match or if the network is full.
+     */
+    template <typename T>
+    Element<T>*
+    matvec(const Matrix<T>* mat, const Element<T>* vec);
+
+    /**
+     * @brief Multiply the transpose of a matrix by a vector, without moving
+     * the matrix. Slaves receive the values of the vector matching their
+     * rows, and send back a single partial sum each, which the master adds.
+     *
+     * @tparam T Type of element.
+     * @param mat Matrix whose transpose is multiplied.
+     * @param vec Vector of `mat->getNbRows()` values.
+     *
+     * @return Result of `mat->getNbCols()` values, nullptr if the sizes do
+     * not match or if the network is full.
+     */
+    template <typename T>
+    Element<T>*
+    matvecTransposed(const Matrix<T>* mat, const Element<T>* vec);
+
+    /**
+     * @brief Apply a reducing callback on every row of a matrix.
+     *
+     * @tparam T Type of element.
+     * @param mat Matrix to reduce.
+     * @param callback_id Callback to use.
+     * @param init_val Default value for the accumulator of every row.
+     *
+     * @return Result, holding one value per row next to the row, nullptr
+     * if the network is full.
+     */
+    template <typename T>
+    Element<T>*
+    reduceRows(const Matrix<T>* mat, unsigned int callback_id,
+               T init_val = 0);
+
+    public:
+    /**
+     * @brief Prepare a mapping callback on shared memory. The returned
+     * operation can be started many times.
+     *
+     * @tparam T Type of element.
+     * @param elt What to map.
+     * @param callback_id Callback to use.
+     *
+     * @return Prepared operation, to free using `delete`.
+     */
+    template <typename T>
+    Operation*
+    prepareMap(const Element<T>* elt, unsigned int callback_id);
+
+    /**
+     * @brief Prepare a reducing callback on shared memory. The result of
+     * each run is available with `Operation::getResult`.
+     *
+     * @tparam T Type of element.
+     * @param elt What to reduce.
+     * @param callback_id Callback to use.
+     * @param init_val Default value for the accumulator.
+     *
+     * @return Prepared operation, to free using `delete`.
+     */
+    template <typename T>
+    Operation*
+    prepareReduce(const Element<T>* elt, unsigned int callback_id,
+                  T init_val = 0);
+
+    /**
+     * @brief Prepare a write into shared memory. The `data` pointer is read
+     * again at each start, it has to stay valid as long as the operation
+     * is used.
+     *
+     * @tparam T Type of element.
+     * @param elt Where to write.
+     * @param data Value(s) to write.
+     * @param nb_elts Number of elements to write from data.
+     *
+     * @return Prepared operation to free using `delete`, nullptr when
+     * writing too much.
+     */
+    template <typename T>
+    Operation*
+    prepareWrite(const Element<T>* elt, const T* data, size_t nb_elts = 0);
+
+    public:
+    /**
+     * @brief Write an element to a binary file. Each slave writes its own
+     * chunks, the master only creates the file and writes the header.
+     * The file has to be reachable by every slave.
+     *
+     * @tparam T Type of element.
+     * @param elt Element to write.
+     * @param path File to create, replaced if it already exists.
+     * @param header Whether to start the file with a `FileHeader`.
+     *
+     * @return Whether the whole element has been written.
+     */
+    template <typename T>
+    bool
+    writeToFile(const Element<T>* elt, const std::string& path,
+                bool header = true);
+
+    public:
+    /**
+     * @brief Get current memory status per node.
+     *
+     * @return Current available memory per node.
+     */
+    inline const std::vector<unsigned long long>&
+    getMemoryStatus() const
+    {
+      return this->memory_per_node_;
+    }
+
+    /**
+     * @brief Ask every slave for its memory usage. The available memory
+     * per node is updated with the answers.
+     *
+     * @return Memory usage per node.
+     */
+    const std::vector<NodeStatus>&
+    queryMemoryStatus();
+
+    /**
+     * @brief Let the slaves spill their chunks to disk once their maximum
+     * memory is reached. The least recently used chunks are spilled first.
+     *
+     * @param dir Scratch directory, reachable by every slave.
+     * @param disk_bytes Number of bytes each slave can store on disk in
+     * addition to its maximum memory, 0 to disable spilling.
+     *
+     * @return False if a slave can not write in the directory, nothing
+     * is changed then.
+     */
+    bool
+    configureSpill(const std::string& dir, size_t disk_bytes);
+
+    /**
+     * @brief Get the last memory usage reported by each node.
+     *
+     * @return Memory usage per node.
+     */
+    inline const std::vector<NodeStatus>&
+    getNodeStatus() const
+    {
+      return this->status_per_node_;
+    }
+
+    /**
+     * @brief Compress the payloads of `reserve`, `read` and `write`. Each
+     * payload is encoded according to its type, and is still sent raw
+     * when it does not compress well.
+     *
+     * @param nb_bytes Minimum size of a compressed payload, 0 to send
+     * every payload raw.
+     */
+    inline void
+    setCompression(size_t nb_bytes)
+    {
+      this->compress_threshold_ = nb_bytes;
+    }
+
+    /**
+     * @brief Set the maximum memory per node.
+     *
+     * @param nb_bytes Maximum number of bytes per node.
+     */
+    inline void
+    setMaxMemory(size_t nb_bytes)
+    {
+      this->max_memory_ = nb_bytes;
+    }
+
+    /**
+     * @brief Set the number of nodes in the network with an initial amount
+     * of memory.
+     *
+     * @param nb_nodes Number of nodes in the network.
+     */
+    inline void
+    setNbNodes(int nb_nodes)
+    {
+      this->nb_nodes_ = nb_nodes;
+      for (int i = 0; i < nb_nodes_; ++i)
+        this->memory_per_node_.push_back(this->max_memory_);
+      this->status_per_node_.resize(nb_nodes, NodeStatus());
+    }
+
+    /**
+     * @brief Get the number of nodes in the network.
+     *
+     * @return Number of nodes in the network.
+     */
+    inline int
+    getNbNodes() const
+    {
+      return this->nb_nodes_;
+    }
+
+    private:
+    /**
+     * @brief Split an allocation on the nodes.
+     *
+     * @param nb_elements Number of elements to place.
+     * @param atom_size Size of one element.
+     * @param layout Placement policy. By default, nodes are filled one
+     * after another.
+     *
+     * @return Chunks of the allocation, empty if it does not fit.
+     */
+    std::vector<Placement>
+    plan(size_t nb_elements, size_t atom_size,
+         Layout layout = Layout::PACKED) const;
+
+    /**
+     * @brief Split the elements of a file on the nodes.
+     *
+     * @param path File to read.
+     * @param atom_size Size of one element.
+     * @param offset Index of the first element to read.
+     * @param nb_elements Number of elements to read, set to the number of
+     * elements following the offset when 0.
+     * @param file_offset Filled with the position in bytes of the first
+     * element to read.
+     *
+     * @return Chunks of the allocation, empty if the file can not be read.
+     */
+    std::vector<Placement>
+    planFile(const std::string& path, size_t atom_size, size_t offset,
+             size_t& nb_elements, size_t& file_offset) const;
+
+    /**
+     * @brief Ask the slaves to allocate their chunk, and to read it
+     * from a file.
+     *
+     * @param nodes Chunks of the allocation.
+     * @param atom_size Size of one element.
+     * @param path File to read.
+     * @param file_offset Position in bytes of the first element.
+     */
+    void
+    sendFileRead(const std::vector<Placement>& nodes, unsigned int atom_size,
+                 const std::string& path, size_t file_offset);
+
+    /**
+     * @brief Read a chunk compressed by its slave.
+     *
+     * @param id Chunk to read.
+     * @param dest Node owning the chunk.
+     * @param data_type Type of the elements (see `DataType`).
+     * @param atom_size Size of one element.
+     * @param out Filled with the bytes of the chunk.
+     * @param nb_bytes Size of the chunk.
+     *
+     * @return Whether the chunk has been decoded.
+     */
+    bool
+    readPacked(const std::string& id, int dest, unsigned int data_type,
+               unsigned int atom_size, uint8_t* out, size_t nb_bytes);
+
+    /**
+     * @brief Create a file, and ask the slaves to write their chunks in it.
+     *
+     * @param elt Element to write.
+     * @param path File to create.
+     * @param header Header written at the start of the file, nullptr to
+     * write the elements only.
+     *
+     * @return Whether the whole element has been written.
+     */
+    bool
+    sendFileWrite(const BaseElement* elt, const std::string& path,
+                  const FileHeader* header);
+
+    /**
+     * @brief Ask the slaves to allocate their chunk, and to fill it
+     * with a single value.
+     *
+     * @param nodes Chunks of the allocation.
+     * @param atom_size Size of one element.
+     * @param value Value of one element, nullptr to leave the memory
+     * uninitialized.
+     * @param zero Whether to set the memory to zero when there is no value.
+     */
+    void
+    sendFill(const std::vector<Placement>& nodes, unsigned int atom_size,
+             const void* value, bool zero = false);
+
+    /**
+     * @brief Wait for allocation acknowledges, and track the new chunks.
+     * If a slave could not allocate its chunk, the other chunks are freed.
+     *
+     * @param nodes Chunks of the allocation.
+     * @param elt Element receiving the chunks.
+     * @param nb_bytes Size of each chunk, nullptr if chunks store each
+     * of their elements.
+     *
+     * @return Whether every chunk has been allocated.
+     */
+    bool
+    track(const std::vector<Placement>& nodes, BaseElement* elt,
+          const std::vector<size_t>* nb_bytes = nullptr);
+
+    /**
+     * @brief Place and send the chunks of a sparse element.
+     *
+     * @param indices Positions of the non-zero values.
+     * @param values Non-zero values.
+     * @param elt Element receiving the chunks.
+     *
+     * @return Whether every chunk has been allocated.
+     */
+    bool
+    sendSparse(const std::vector<size_t>& indices, const uint8_t* values,
+               BaseElement* elt);
+
+    /**
+     * @brief Read every chunk of a sparse element.
+     *
+     * @param elt Element to read.
+     * @param indices Filled with the positions of the non-zero values.
+     * @param values Filled with the bytes of the non-zero values.
+     */
+    void
+    receiveSparse(const BaseElement* elt, std::vector<size_t>& indices,
+                  std::vector<uint8_t>& values);
+
+    /**
+     * @brief Send mapping callbacks to the chunks of an element, and wait
+     * for the slaves.
+     *
+     * @param elt Element to map.
+     * @param callback_id Callback to use.
+     * @param data_type Type of the mapped values (see `DataType`).
+     * @param column Position of the mapped field in a stored record.
+     * @param record_size Size of a stored record, 0 to map whole chunks.
+     *
+     * @return False if a slave refused to map its chunk.
+     */
+    bool
+    sendMap(const BaseElement* elt, unsigned int callback_id,
+            unsigned int data_type, size_t column, size_t record_size);
+
+    /**
+     * @brief Ask the slaves for the statistics of their chunks, and merge
+     * them.
+     *
+     * @param elt Element to describe.
+     * @param data_type Type of the described values (see `DataType`).
+     * @param column Position of the described field in a stored record.
+     * @param record_size Size of a stored record, 0 to describe whole
+     * chunks.
+     *
+     * @return Statistics of the element.
+     */
+    Statistics
+    sendDescribe(const BaseElement* elt, unsigned int data_type,
+                 size_t column, size_t record_size);
+
+    /**
+     * @brief Ask the slaves for the best values of their chunks.
+     *
+     * @param elt Element to look into.
+     * @param data_type Type of the values (see `DataType`).
+     * @param k Number of values per chunk.
+     * @param largest Whether the largest values are looked for.
+     * @param indices Filled with the positions of the values.
+     * @param values Filled with the bytes of the values.
+     */
+    void
+    receiveTopK(const BaseElement* elt, unsigned int data_type, size_t k,
+                bool largest, std::vector<size_t>& indices,
+                std::vector<uint8_t>& values);
+
+    /**
+     * @brief Ask the slaves for the sketch of their chunks, and merge them.
+     *
+     * @param elt Element to summarize.
+     * @param data_type Type of the values (see `DataType`).
+     * @param accuracy Accuracy of the sketch.
+     *
+     * @return Sketch of the element.
+     */
+    QuantileSketch
+    sendSketch(const BaseElement* elt, unsigned int data_type,
+               size_t accuracy);
+
+    /**
+     * @brief Ask the slaves for the hash sketch of their chunks. The same
+     * layout is used for both sketches.
+     *
+     * @param elt Element to hash.
+     * @param data_type Type of the values (see `DataType`).
+     * @param tag Either `DISTINCT` or `BLOOM`.
+     * @param param Precision of a HyperLogLog, or number of hashes of a
+     * Bloom filter.
+     * @param size Number of bits of a Bloom filter, unused otherwise.
+     *
+     * @return Replies of the slaves, in the order of the chunks.
+     */
+    std::vector<std::vector<uint8_t>>
+    sendHashSketch(const BaseElement* elt, unsigned int data_type, int tag,
+                   uint32_t param, uint64_t size);
+
+    /**
+     * @brief Send a Bloom filter to the slaves, which test the chunks of
+     * an element and allocate the results next to them.
+     *
+     * @param elt Element to test.
+     * @param data_type Type of the values (see `DataType`).
+     * @param filter Filter to test against.
+     * @param mask Element receiving the chunks of results.
+     *
+     * @return Whether every chunk of results has been allocated.
+     */
+    bool
+    sendFilter(const BaseElement* elt, unsigned int data_type,
+               const BloomFilter& filter, BaseElement* mask);
+
+    /**
+     * @brief Ask the slaves for the sums of the blocks of their chunks.
+     * Blocks split between chunks are sent as values, and summed by the
+     * master.
+     *
+     * @param elt Element to sum.
+     * @param data_type Type of the values (see `DataType`).
+     *
+     * @return Sum of the element.
+     */
+    double
+    sendSum(const BaseElement* elt, unsigned int data_type);
+
+    /**
+     * @brief Select the chunks a range query is sent to.
+     *
+     * @tparam T Type of element.
+     * @param elt Element to query.
+     * @param low Lowest value of the range.
+     * @param high Highest value of the range.
+     * @param zones Zone map of the element, or nullptr.
+     * @param read Whether values are read, chunks inside of the range
+     * being then sent the query.
+     * @param chunks Filled with the positions of the chunks to query.
+     * @param flags Filled with the options of every query (see
+     * `range::Flags`).
+     *
+     * @return Number of values of the chunks counted by the master.
+     */
+    template <typename T>
+    size_t
+    selectChunks(const Element<T>* elt, const T& low, const T& high,
+                 const ZoneMap<T>* zones, bool read,
+                 std::vector<size_t>& chunks, std::vector<uint32_t>& flags);
+
+    /**
+     * @brief Send a zone map or range query to the slaves holding some
+     * chunks of an element, and gather their replies.
+     *
+     * @param elt Element to query.
+     * @param tag Either `ZONE_MAP` or `RANGE`.
+     * @param data_type Type of the values (see `DataType`).
+     * @param chunks Positions of the chunks to query.
+     * @param flags Options of the query of every chunk.
+     * @param params Parameters following the header, the bounds of the
+     * range.
+     *
+     * @return Reply of every chunk queried.
+     */
+    std::vector<std::vector<uint8_t>>
+    sendRange(const BaseElement* elt, int tag, unsigned int data_type,
+              const std::vector<size_t>& chunks,
+              const std::vector<uint32_t>& flags,
+              const std::vector<uint8_t>& params);
+
+    /**
+     * @brief Send an operation exchanging halos to the slaves holding an
+     * element. Each slave receives a single message, listing its chunks
+     * with their neighbours, followed by the parameters of the operation.
+     *
+     * @param elt Element to read.
+     * @param out Element receiving the result, placed as `elt`.
+     * @param tag Operation to apply.
+     * @param halo_len Number of values a chunk should at least hold, 0 for
+     * no limit.
+     * @param params Parameters of the operation.
+     *
+     * @return False if an element is not dense, if `out` is not placed as
+     * `elt`, if a chunk is shorter than the halo, or if a slave failed.
+     */
+    bool
+    sendHalo(const BaseElement* elt, const BaseElement* out, int tag,
+             size_t halo_len, const std::vector<uint8_t>& params);
+
+    /**
+     * @brief Send a parameterized kernel to the chunks of an element, and
+     * wait until every chunk is mapped.
+     *
+     * @param elt Element to map.
+     * @param kernel_id Kernel to apply (see `callback::MapParamID`).
+     * @param data_type Type of the mapped values (see `DataType`).
+     * @param params `MAX_PARAMS` parameters, as bytes.
+     * @param nb_bytes Size of params.
+     *
+     * @return False if a slave refused to map its chunk.
+     */
+    bool
+    sendMapParam(const BaseElement* elt, unsigned int kernel_id,
+                 unsigned int data_type, const uint8_t* params,
+                 size_t nb_bytes);
+
+    /**
+     * @brief Chain reducing callbacks through the chunks of an element.
+     *
+     * @tparam T Type of the reduced values.
+     * @param elt Element to reduce.
+     * @param callback_id Callback to use.
+     * @param init_val Default value for the accumulator.
+     * @param column Position of the reduced field in a stored record.
+     * @param record_size Size of a stored record, 0 to reduce whole chunks.
+     *
+     * @return Pointer to result value.
+     */
+    template <typename T>
+    T*
+    sendReduce(const BaseElement* elt, unsigned int callback_id, T init_val,
+               size_t column, size_t record_size);
+
+    /**
+     * @brief Compute where the rows of a matrix are, one placement per
+     * chunk, the bounds being positions of rows.
+     *
+     * @param mat Matrix to place.
+     * @param nb_cols Number of values of a row.
+     *
+     * @return Placement of the rows, empty if a chunk does not hold whole
+     * rows.
+     */
+    std::vector<Placement>
+    planRows(const BaseElement* mat, size_t nb_cols) const;
+
+    /**
+     * @brief Allocate an element holding one value per row of a matrix,
+     * each value being on the slave of its row.
+     *
+     * @tparam T Type of element.
+     * @param mat Matrix whose rows are followed.
+     * @param nb_cols Number of values of a row.
+     *
+     * @return Element allocated, nullptr if the network is full.
+     */
+    template <typename T>
+    Element<T>*
+    reserveRows(const BaseElement* mat, size_t nb_cols);
+
+    /**
+     * @brief Send an operation to the slaves holding the rows of a
+     * matrix, one message per slave, and receive their replies.
+     *
+     * @param mat Matrix to compute on.
+     * @param out Element holding one value per row (see `reserveRows`),
+     * nullptr if the slaves reply with their result.
+     * @param tag Operation to apply.
+     * @param params Parameters of the operation, sent to every slave.
+     * @param rows Values attached to the rows of the matrix, each slave
+     * only receiving the ones of its rows, nullptr if none.
+     * @param atom_size Size of a value attached to a row.
+     * @param replies Filled with the reply of every slave, in the order
+     * of their ranks.
+     *
+     * @return False if a slave failed.
+     */
+    bool
+    sendMatrix(const BaseElement* mat, const BaseElement* out, int tag,
+               const std::vector<uint8_t>& params, const uint8_t* rows,
+               size_t atom_size, std::vector<std::vector<uint8_t>>& replies);
+
+    /**
+     * @brief Send keys to the partitions of a table, one message per
+     * partition, and receive the replies.
+     *
+     * @param table Table to query.
+     * @param tag Operation to apply.
+     * @param key_size Size of a key.
+     * @param value_size Size of a value.
+     * @param keys Keys to send.
+     * @param values Value of every key, nullptr if none is sent.
+     * @param nb_keys Number of keys.
+     * @param groups Filled with the positions of the keys sent to every
+     * partition.
+     * @param replies Filled with the reply of every partition.
+     *
+     * @return False if a partition failed.
+     */
+    bool
+    sendTable(const BaseElement* table, int tag, size_t key_size,
+              size_t value_size, const uint8_t* keys, const uint8_t* values,
+              size_t nb_keys, std::vector<std::vector<size_t>>& groups,
+              std::vector<std::vector<uint8_t>>& replies);
+
+    /**
+     * @brief Follow the number of entries of every partition of a table,
+     * as replied by the slaves.
+     *
+     * @param table Table updated.
+     * @param replies Reply of every partition.
+     *
+     * @return Number of entries matched by the keys sent.
+     */
+    size_t
+    resizeTable(BaseElement* table,
+                const std::vector<std::vector<uint8_t>>& replies);
+
+    /**
+     * @brief Read the column of a field in every chunk of an element.
+     *
+     * @param elt Element to read.
+     * @param column Position of the field in a stored record.
+     * @param field_size Size of the field.
+     * @param record_size Size of a stored record.
+     * @param out Filled with the field of every record.
+     */
+    void
+    receiveColumn(const BaseElement* elt, size_t column, size_t field_size,
+                  size_t record_size, uint8_t* out);
+
+    /**
+     * @brief Wait for the memory usage sent by a slave in a reply.
+     *
+     * @param node Node sending the reply.
+     * @param tag Operation identifier.
+     * @param id Filled with the identifier following the status, if any.
+     *
+     * @return Memory usage of the node.
+     */
+    NodeStatus
+    receiveStatus(int node, int tag, std::string* id = nullptr);
+
+    /**
+     * @brief Update the available memory of a node with the memory usage
+     * it reported. The estimate of the master is only lowered, since
+     * the slave may not have handled every message yet.
+     *
+     * @param node Node reporting its memory usage.
+     * @param status Memory usage of the node.
+     */
+    void
+    update(int node, const NodeStatus& status);
+
+    /**
+     * @brief Send settings to every slave.
+     *
+     * @param config Settings of the slaves.
+     *
+     * @return Whether every slave applied the settings.
+     */
+    bool
+    sendConfig(const NodeConfig& config);
+
+    /**
+     * @brief Free the chunks of an element, and wait for the slaves.
+     *
+     * @param ids Identifiers of the chunks.
+     * @param nodes Node owning each chunk.
+     */
+    void
+    release(const std::vector<std::string>& ids, const std::vector<int>& nodes);
+
+    /**
+     * @brief Send indexed loads or stores to the slaves. Indices are grouped
+     * by slave, and by chunk.
+     *
+     * @param elt Element to access.
+     * @param indices Indices of the elements.
+     * @param values Values to store, nullptr for a load.
+     * @param tag Operation identifier.
+     * @param dests Filled with the node receiving each message.
+     * @param order Filled with the position in `indices` of the elements
+     * handled by each message.
+     *
+     * @return False if an index is out of bounds, nothing is sent then.
+     */
+    bool
+    sendIndexed(const BaseElement* elt, const std::vector<size_t>& indices,
+                const uint8_t* values, int tag, std::vector<int>& dests,
+                std::vector<std::vector<size_t>>& order);
+
+    /**
+     * @brief Copy an element into another one, directly between slaves.
+     *
+     * @param src Element to copy.
+     * @param dst Element receiving the copy.
+     *
+     * @return Whether the operation was successul.
+     */
+    bool
+    transfer(const BaseElement* src, const BaseElement* dst);
+
+    /**
+     * @brief Add elements at the end of an element.
+     *
+     * @param elt Element to grow.
+     * @param data Data of the new elements, nullptr to set them to zero.
+     * @param nb_elts Number of elements to add.
+     *
+     * @return Whether the operation was successul.
+     */
+    bool
+    grow(BaseElement* elt, const uint8_t* data, size_t nb_elts);
+
+    /**
+     * @brief Remove elements at the end of an element.
+     *
+     * @param elt Element to shrink.
+     * @param nb_elts Number of elements to keep.
+     *
+     * @return Whether the operation was successul.
+     */
+    bool
+    shrink(BaseElement* elt, size_t nb_elts);
+
+    /**
+     * @brief Ask a slave to resize one of its chunks, and to copy data
+     * at the end of it.
+     *
+     * @param id Chunk to resize.
+     * @param dest Node owning the chunk.
+     * @param nb_bytes New size of the chunk.
+     * @param capacity Number of bytes to reserve for the chunk.
+     * @param data Data copied at the end of the chunk.
+     * @param data_bytes Size of data.
+     *
+     * @return Whether the operation was successul.
+     */
+    bool
+    sendGrow(const std::string& id, int dest, size_t nb_bytes,
+             size_t capacity, const uint8_t* data, size_t data_bytes);
+
+    private:
+    /**
+     * @brief Constructor.
+     */
+    Allocator()
+        : nb_nodes_(0), max_memory_(0), config_(), compress_threshold_(0),
+          nb_tracked_(0), clock_(0)
+    {
+    }
+
+    private:
+    /**
+     * @brief Unique instance.
+     */
+    static Allocator* instance_;
+
+    private:
+    /**
+     * @brief Number of nodes in the network.
+     */
+    int nb_nodes_;
+
+    /**
+     * @brief Maximum usable memory per node.
+     */
+    size_t max_memory_;
+
+    /**
+     * @brief Settings sent to the slaves.
+     */
+    NodeConfig config_;
+
+    /**
+     * @brief Minimum size of a compressed payload, 0 if payloads are
+     * always sent raw.
+     */
+    size_t compress_threshold_;
+
+    /**
+     * @brief Current available memory per node.
+     */
+    std::vector<unsigned long long> memory_per_node_;
+
+    /**
+     * @brief Last memory usage reported by each node.
+     */
+    std::vector<NodeStatus> status_per_node_;
+
+    /**
+     * @brief Elements owning chunks on the slaves, views excluded, with
+     * their order of allocation.
+     */
+    std::unordered_map<BaseElement*, unsigned long long> elements_;
+
+    /**
+     * @brief Number of elements tracked since the start.
+     */
+    unsigned long long nb_tracked_;
+
+    // TODO: add atomic variable.
+    /**
+     * @brief Clock of write messages, shared by every write.
+     */
+    size_t clock_;
   };
 }  // namespace algorep
 
@@ -1,9 +1,13 @@
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <type_traits>
 
 #include <mpi/mpi.h>
 
 #include <constant/constants.h>
+#include <data/codec.h>
+#include <data/file.h>
 #include <data/tag_data.h>
 #include <message.h>
 
@@ -21,69 +25,234 @@ namespace algorep
   Element<T>*
   Allocator::reserve(size_t nb_elements, const T* elt)
   {
-    size_t nb_bytes = sizeof(T) * nb_elements;
-    nb_bytes = nb_bytes;
-
-    std::vector<std::tuple<unsigned int, size_t, size_t>> nodes;
-    // First, we check if the size of the allocation can fit
-    // on a single node.
-    int i = 0;
-    size_t start_idx = 0;
-    size_t free_elt = nb_elements;
-    for (; i < this->nb_nodes_; ++i)
-    {
-      auto max = (this->memory_per_node_[i] / sizeof(T));
-      if (max < 1) continue;
-
-      if (max >= free_elt)
-      {
-        nodes.push_back(
-            std::make_tuple(i + 1, start_idx, start_idx + free_elt - 1));
-        break;
-      }
-      nodes.push_back(std::make_tuple(i + 1, start_idx, start_idx + max - 1));
-      free_elt -= max;
-      start_idx += max;
-    }
-
+    const auto& nodes = this->plan(nb_elements, sizeof(T));
     if (nodes.size() == 0) return nullptr;
 
     auto* result = new Element<T>(nb_elements);
+    // Compressed payloads are kept until the slaves reply.
+    std::vector<std::vector<uint8_t>> packed(nodes.size());
     // Sends allocation messages to each node containing
     // a part of the data (the data can be on only one node).
-    for (const auto& node : nodes)
+    for (size_t i = 0; i < nodes.size(); ++i)
     {
-      const auto node_id = std::get<0>(node);
-      const auto& lower = std::get<1>(node);
-      const auto& upper = std::get<2>(node);
+      const auto node_id = std::get<0>(nodes[i]);
+      const auto& lower = std::get<1>(nodes[i]);
+      const auto& upper = std::get<2>(nodes[i]);
 
       // Computes the number of bytes to send to the node.
       size_t bytes = sizeof(T) * (upper - lower + 1);
 
       MPI_Request req;
-      message::send<T>(elt + lower, bytes, node_id, TAGS::ALLOCATION, req);
+      if (this->compress_threshold_ && bytes >= this->compress_threshold_)
+      {
+        codec::encode(reinterpret_cast<const uint8_t*>(elt + lower), bytes,
+                      file::HeaderType<T>::value, sizeof(T),
+                      this->compress_threshold_, packed[i]);
+        message::send<uint8_t>(&packed[i][0], packed[i].size(), node_id,
+                               TAGS::ALLOCATION_PACKED, req);
+      }
+      else
+        message::send<T>(elt + lower, bytes, node_id, TAGS::ALLOCATION, req);
     }
 
     // Waits until every allocation is done.
     // Waiting here may give better throughput than just
     // waiting in the previous loop after a call to `send'.
-    for (const auto& node : nodes)
+    if (!this->track(nodes, result))
     {
-      const auto node_id = std::get<0>(node);
-      const auto& lower = std::get<1>(node);
-      const auto& upper = std::get<2>(node);
+      delete result;
+      return nullptr;
+    }
+
+    return result;
+  }
 
-      char* id = nullptr;
-      message::rec_sync(node_id, TAGS::ALLOCATION, &id);
+  template <typename T>
+  Element<T>*
+  Allocator::reserveUninitialized(size_t nb_elements)
+  {
+    const auto& nodes = this->plan(nb_elements, sizeof(T));
+    if (nodes.size() == 0) return nullptr;
 
-      result->addId(std::string(id), std::make_tuple(lower, upper));
+    auto* result = new Element<T>(nb_elements);
+    this->sendFill(nodes, sizeof(T), nullptr);
+    if (!this->track(nodes, result))
+    {
+      delete result;
+      return nullptr;
+    }
 
-      size_t bytes = sizeof(T) * (upper - lower + 1);
-      // TODO: normally, we should check that every allocation
-      // has succeeded.
-      this->memory_per_node_[node_id - 1] -= bytes;
+    return result;
+  }
 
-      if (id != nullptr) delete[] id;
+  template <typename T>
+  Element<T>*
+  Allocator::reserveLike(const BaseElement* elt)
+  {
+    std::vector<Placement> nodes;
+    for (size_t i = 0; i < elt->getIds().size(); ++i)
+    {
+      const auto& bounds = elt->getBounds()[i];
+      nodes.emplace_back(elt->getIntIds()[i], std::get<0>(bounds),
+                         std::get<1>(bounds));
+    }
+    if (nodes.size() == 0) return nullptr;
+
+    auto* result = new Element<T>(elt->getNbValues());
+    this->sendFill(nodes, sizeof(T), nullptr);
+    if (!this->track(nodes, result))
+    {
+      delete result;
+      return nullptr;
+    }
+
+    return result;
+  }
+
+  template <typename T>
+  Element<T>*
+  Allocator::reserveFilled(size_t nb_elements, const T& value)
+  {
+    static_assert(sizeof(T) <= 64, "filling value should fit in 64 bytes");
+
+    const auto& nodes = this->plan(nb_elements, sizeof(T));
+    if (nodes.size() == 0) return nullptr;
+
+    auto* result = new Element<T>(nb_elements);
+    this->sendFill(nodes, sizeof(T), &value);
+    if (!this->track(nodes, result))
+    {
+      delete result;
+      return nullptr;
+    }
+
+    return result;
+  }
+
+  template <typename T>
+  Element<T>*
+  Allocator::reserveFromFile(const std::string& path, size_t offset,
+                             size_t nb_elements)
+  {
+    size_t file_offset = 0;
+    const auto& nodes =
+        this->planFile(path, sizeof(T), offset, nb_elements, file_offset);
+    if (nodes.size() == 0) return nullptr;
+
+    auto* result = new Element<T>(nb_elements);
+    this->sendFileRead(nodes, sizeof(T), path, file_offset);
+    if (!this->track(nodes, result))
+    {
+      delete result;
+      return nullptr;
+    }
+
+    return result;
+  }
+
+  template <typename T>
+  Element<T>*
+  Allocator::reserveSparse(size_t nb_elements,
+                           const std::vector<size_t>& indices, const T* values)
+  {
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      if (indices[i] >= nb_elements) return nullptr;
+      if (i && indices[i] <= indices[i - 1]) return nullptr;
+    }
+
+    auto* result = new Element<T>(nb_elements, false, Storage::SPARSE);
+    if (!this->sendSparse(indices, (const uint8_t*)values, result))
+    {
+      delete result;
+      return nullptr;
+    }
+
+    return result;
+  }
+
+  template <typename T>
+  Element<T>*
+  Allocator::reserveColumns(size_t nb_elements, const T* records)
+  {
+    static_assert(fields::Fields<T>::registered,
+                  "fields should be registered with ALGOREP_FIELDS");
+
+    const size_t record_size = fields::recordSize(fields::layout<T>());
+    const auto& nodes = this->plan(nb_elements, record_size);
+    if (nodes.size() == 0) return nullptr;
+
+    auto* result =
+        new Element<T>(nb_elements, false, Storage::COLUMNS, record_size);
+    // Columns are kept until the slaves reply.
+    std::vector<std::vector<uint8_t>> columns(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      const auto node_id = std::get<0>(nodes[i]);
+      const auto& lower = std::get<1>(nodes[i]);
+      const auto& upper = std::get<2>(nodes[i]);
+
+      // Each chunk stores the columns of its own records.
+      const size_t count = upper - lower + 1;
+      columns[i].resize(count * record_size);
+      if (count) fields::toColumns(records + lower, count, &columns[i][0]);
+
+      MPI_Request req;
+      message::send<uint8_t>(columns[i].data(), columns[i].size(), node_id,
+                             TAGS::ALLOCATION, req);
+    }
+
+    if (!this->track(nodes, result))
+    {
+      delete result;
+      return nullptr;
+    }
+
+    return result;
+  }
+
+  template <typename T>
+  bool
+  Allocator::writeToFile(const Element<T>* elt, const std::string& path,
+                         bool header)
+  {
+    FileHeader file_header;
+    std::memcpy(file_header.magic, file::MAGIC, sizeof(file::MAGIC));
+    file_header.data_type = file::HeaderType<T>::value;
+    file_header.atom_size = sizeof(T);
+    file_header.nb_values = elt->getNbValues();
+
+    return this->sendFileWrite(elt, path, (header) ? &file_header : nullptr);
+  }
+
+  template <typename T>
+  Element<T>*
+  Allocator::view(const BaseElement* elt)
+  {
+    const size_t atom_size = elt->getAtomSize();
+    const auto& ids = elt->getIds();
+    const auto& bounds = elt->getBounds();
+
+    if (!elt->isDense()) return nullptr;
+    if ((elt->getNbValues() * atom_size) % sizeof(T) != 0) return nullptr;
+
+    auto* result =
+        new Element<T>((elt->getNbValues() * atom_size) / sizeof(T), true);
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      size_t lower = std::get<0>(bounds[i]) * atom_size;
+      size_t upper = (std::get<1>(bounds[i]) + 1) * atom_size;
+
+      // The chunk would split an element, the slave would be unable
+      // to process it on its own.
+      if (lower % sizeof(T) != 0 || upper % sizeof(T) != 0)
+      {
+        delete result;
+        return nullptr;
+      }
+
+      result->addId(ids[i],
+                    std::make_tuple(lower / sizeof(T), upper / sizeof(T) - 1));
     }
 
     return result;
@@ -93,6 +262,18 @@ namespace algorep
   T*
   Allocator::read(const Element<T>* elt)
   {
+    // Only the non-zero values of a sparse element are sent.
+    if (elt->isSparse())
+    {
+      std::vector<size_t> indices;
+      std::vector<uint8_t> values;
+      this->receiveSparse(elt, indices, values);
+
+      auto* result = new T[elt->getNbValues()]();
+      for (size_t i = 0; i < indices.size(); ++i)
+        std::memcpy(result + indices[i], &values[i * sizeof(T)], sizeof(T));
+      return result;
+    }
     auto* result = new T[elt->getNbValues()];
 
     const auto& ids = elt->getIds();
@@ -105,6 +286,37 @@ namespace algorep
       // int dest = getRankFromId(id);
       const int dest = elt->getIntIds()[i];
 
+      const auto& lower_bound = std::get<0>(bound);
+      size_t count = (std::get<1>(bound) - lower_bound) + 1;
+
+      // Records are rebuilt from the columns of the chunk.
+      if (elt->isColumnar())
+      {
+        MPI_Request req;
+        message::send(id, dest, TAGS::READ, req);
+
+        uint8_t* read = nullptr;
+        message::rec_sync<uint8_t>(dest, TAGS::READ, &read);
+        fields::fromColumns(read, count, result + lower_bound);
+
+        delete[] read;
+        continue;
+      }
+
+      // The chunk is decoded directly at its place.
+      if (this->compress_threshold_ &&
+          count * sizeof(T) >= this->compress_threshold_)
+      {
+        auto* out = reinterpret_cast<uint8_t*>(result + lower_bound);
+        if (!this->readPacked(id, dest, file::HeaderType<T>::value,
+                              sizeof(T), out, count * sizeof(T)))
+        {
+          delete[] result;
+          return nullptr;
+        }
+        continue;
+      }
+
       // Asks the `dest' slave for a read.
       MPI_Request req;
       message::send(id, dest, TAGS::READ, req);
@@ -113,9 +325,6 @@ namespace algorep
       T* read = nullptr;
       message::rec_sync<T>(dest, TAGS::READ, &read);
 
-      const auto& lower_bound = std::get<0>(bound);
-      size_t count = (std::get<1>(bound) - lower_bound) + 1;
-
       // Copies the array from it's lower bound index.
       std::memcpy(result + lower_bound, read, count * sizeof(T));
 
@@ -129,10 +338,7 @@ namespace algorep
   bool
   Allocator::write(const Element<T>* elt, const T* data, size_t nb_elts)
   {
-    // TODO: add atomic variable.
-    static size_t CLOCK = 0;
-
-    if (nb_elts > elt->getNbValues()) return false;
+    if (!elt->isDense() || nb_elts > elt->getNbValues()) return false;
     nb_elts = (nb_elts == 0) ? elt->getNbValues() : nb_elts;
 
     const auto& ids = elt->getIds();
@@ -142,6 +348,7 @@ namespace algorep
     // TODO: When data are to large, send a PRE_WRITE message
     // to avoid making a huge copy.
     std::vector<std::vector<uint8_t>> formatted(ids.size());
+    std::vector<int> tags(ids.size(), TAGS::WRITE);
     for (unsigned int i = 0; i < ids.size() && nb_elts > 0; ++i)
     {
       const auto& id = ids[i];
@@ -160,14 +367,24 @@ namespace algorep
       // Builds a new array to send, laying the data as follow:
       //    N bytes      22 bytes   sizeof (size_t)
       // [...Data...]   [...ID...]   [..Clock..]
-      formatted[i].reserve(data_bytes + sizeof(size_t) + constant::ID_LEN);
-      // Copies the `data' pointer to `formatted'
-      std::memcpy(&formatted[i][0], data + lower, data_bytes);
+      // The data may be compressed, and start with a `CodecHeader'.
+      auto& buffer = formatted[i];
+      const auto* bytes = reinterpret_cast<const uint8_t*>(data + lower);
+      if (this->compress_threshold_ && data_bytes >= this->compress_threshold_)
+      {
+        codec::encode(bytes, data_bytes, file::HeaderType<T>::value,
+                      sizeof(T), this->compress_threshold_, buffer);
+        tags[i] = TAGS::WRITE_PACKED;
+      }
+      else
+        buffer.assign(bytes, bytes + data_bytes);
+
       // Copies the id at the end. The ID will never be more than 22 char.
-      std::memset(&formatted[i][0] + data_bytes, 0, constant::ID_LEN);
-      std::memcpy(&formatted[i][0] + data_bytes, id.c_str(), id.length());
+      const size_t offset = buffer.size();
+      buffer.resize(offset + constant::ID_LEN + sizeof(size_t), 0);
+      std::memcpy(&buffer[offset], id.c_str(), id.length());
       // Copies the clock at the end of the data
-      std::memcpy(&formatted[i][0] + data_bytes + constant::ID_LEN, &CLOCK,
+      std::memcpy(&buffer[offset + constant::ID_LEN], &this->clock_,
                   sizeof(size_t));
 
       nb_elts -= sub_nb_values;
@@ -181,14 +398,14 @@ namespace algorep
       // The data are splitted linearly on clusters. If we find
       // a cluster that does not need data, we can safely assume
       // that the next ones are in the same state.
-      if (data.capacity() == 0) break;
+      if (data.empty()) break;
 
       // const int dest = getRankFromId(ids[i]);
       const int dest = elt->getIntIds()[i];
 
       // Asks the slave `dest' for a write.
       MPI_Request req;
-      message::send<uint8_t>(&data[0], data.capacity(), dest, TAGS::WRITE, req);
+      message::send<uint8_t>(&data[0], data.size(), dest, tags[i], req);
     }
 
     // This part is super important. If we return directly,
@@ -198,7 +415,7 @@ namespace algorep
     for (size_t i = 0; i < ids.size(); ++i)
     {
       const auto& data = formatted[i];
-      if (data.capacity() == 0) break;
+      if (data.empty()) break;
 
       // const int dest = getRankFromId(ids[i]);
       const int dest = elt->getIntIds()[i];
@@ -212,44 +429,777 @@ namespace algorep
       if (!status) return false;
     }
 
-    CLOCK++;
+    this->clock_++;
     return true;
   }
 
   template <typename T>
-  Allocator*
-  Allocator::map(const Element<T>* elt, unsigned int callback_id)
+  void
+  Allocator::readSparse(const Element<T>* elt, std::vector<size_t>& indices,
+                        std::vector<T>& values)
   {
-    static constexpr int DATA_TYPE = callback::ElementType<T>::value;
-    const auto& ids = elt->getIds();
-    for (size_t i = 0; i < ids.size(); ++i)
+    indices.clear();
+    values.clear();
+    if (elt->isSparse())
     {
-      const int dest = elt->getIntIds()[i];
+      std::vector<uint8_t> bytes;
+      this->receiveSparse(elt, indices, bytes);
+      values.resize(indices.size());
+      if (bytes.size()) std::memcpy(&values[0], &bytes[0], bytes.size());
+      return;
+    }
 
-      std::string id = ids[i] + "-" + std::to_string(callback_id);
-      id += "-" + std::to_string(DATA_TYPE);
+    T* dense = this->read<T>(elt);
+    if (dense == nullptr) return;
+    for (size_t i = 0; i < elt->getNbValues(); ++i)
+    {
+      if (dense[i] == T(0)) continue;
+      indices.push_back(i);
+      values.push_back(dense[i]);
+    }
+    delete[] dense;
+  }
+
+  template <typename T, typename F>
+  F*
+  Allocator::readField(const Element<T>* elt, F T::*member)
+  {
+    const size_t record_size = fields::recordSize(fields::layout<T>());
+    const size_t column = fields::findColumn(member);
+    if (!elt->isColumnar() || column == record_size) return nullptr;
+
+    auto* result = new F[elt->getNbValues()];
+    this->receiveColumn(elt, column, sizeof(F), record_size,
+                        reinterpret_cast<uint8_t*>(result));
+    return result;
+  }
+
+  template <typename T>
+  Matrix<T>*
+  Allocator::reserveMatrix(size_t nb_rows, size_t nb_cols, const T* data,
+                           Layout layout)
+  {
+    if (nb_cols == 0) return nullptr;
 
+    // Rows are planned as atoms, so that no row is split.
+    auto nodes = this->plan(nb_rows, nb_cols * sizeof(T), layout);
+    if (nodes.size() == 0) return nullptr;
+
+    auto* result = new Matrix<T>(nb_rows, nb_cols);
+    for (auto& node : nodes)
+    {
+      std::get<1>(node) *= nb_cols;
+      std::get<2>(node) = (std::get<2>(node) + 1) * nb_cols - 1;
+
+      const auto& lower = std::get<1>(node);
+      const auto& upper = std::get<2>(node);
       MPI_Request req;
-      message::send(id, dest, TAGS::MAP, req);
+      message::send<T>(data + lower, sizeof(T) * (upper - lower + 1),
+                       std::get<0>(node), TAGS::ALLOCATION, req);
     }
 
-    for (size_t i = 0; i < ids.size(); ++i)
+    if (!this->track(nodes, result))
     {
-      const int dest = elt->getIntIds()[i];
+      delete result;
+      return nullptr;
+    }
+
+    return result;
+  }
 
+  template <typename K, typename V>
+  Table<K, V>*
+  Allocator::reserveTable()
+  {
+    static_assert(std::is_integral<K>::value && sizeof(K) <= sizeof(uint64_t),
+                  "keys of a table should be integers");
+
+    // Partitions start empty, their upper bound being before their lower
+    // one.
+    std::vector<Placement> nodes;
+    for (int node = 1; node <= this->nb_nodes_; ++node)
+      nodes.emplace_back(node, 0, (size_t)-1);
+
+    auto* result = new Table<K, V>();
+    this->sendFill(nodes, result->getAtomSize(), nullptr);
+    if (!this->track(nodes, result))
+    {
+      delete result;
+      return nullptr;
+    }
+
+    return result;
+  }
+
+  template <typename K, typename V>
+  bool
+  Allocator::put(Table<K, V>* table, const std::vector<K>& keys,
+                 const std::vector<V>& values)
+  {
+    if (keys.size() != values.size()) return false;
+    if (keys.empty()) return true;
+
+    std::vector<std::vector<size_t>> groups;
+    std::vector<std::vector<uint8_t>> replies;
+    bool success = this->sendTable(
+        table, TAGS::TABLE_PUT, sizeof(K), sizeof(V),
+        reinterpret_cast<const uint8_t*>(&keys[0]),
+        reinterpret_cast<const uint8_t*>(&values[0]), keys.size(), groups,
+        replies);
+    this->resizeTable(table, replies);
+
+    return success;
+  }
+
+  template <typename K, typename V>
+  size_t
+  Allocator::get(const Table<K, V>* table, const std::vector<K>& keys,
+                 std::vector<V>& values, std::vector<bool>& found)
+  {
+    values.assign(keys.size(), V());
+    found.assign(keys.size(), false);
+    if (keys.empty()) return 0;
+
+    std::vector<std::vector<size_t>> groups;
+    std::vector<std::vector<uint8_t>> replies;
+    this->sendTable(table, TAGS::TABLE_GET, sizeof(K), sizeof(V),
+                    reinterpret_cast<const uint8_t*>(&keys[0]), nullptr,
+                    keys.size(), groups, replies);
+
+    // Replies lay out like this, after their header:
+    //  N * sizeof (uint8_t)   N * sizeof (V)
+    // [.......Found......]   [...Values...]
+    size_t nb_found = 0;
+    for (size_t p = 0; p < groups.size(); ++p)
+    {
+      const auto& group = groups[p];
+      if (group.empty()) continue;
+      const uint8_t* flags = &replies[p][table::REPLY_HEADER];
+      const uint8_t* data = flags + group.size();
+      for (size_t i = 0; i < group.size(); ++i)
+      {
+        if (!flags[i]) continue;
+        found[group[i]] = true;
+        std::memcpy(&values[group[i]], data + i * sizeof(V), sizeof(V));
+        ++nb_found;
+      }
+    }
+
+    return nb_found;
+  }
+
+  template <typename K, typename V>
+  size_t
+  Allocator::erase(Table<K, V>* table, const std::vector<K>& keys)
+  {
+    if (keys.empty()) return 0;
+
+    std::vector<std::vector<size_t>> groups;
+    std::vector<std::vector<uint8_t>> replies;
+    this->sendTable(table, TAGS::TABLE_ERASE, sizeof(K), sizeof(V),
+                    reinterpret_cast<const uint8_t*>(&keys[0]), nullptr,
+                    keys.size(), groups, replies);
+
+    return this->resizeTable(table, replies);
+  }
+
+  template <typename T>
+  T*
+  Allocator::gather(const Element<T>* elt, const std::vector<size_t>& indices)
+  {
+    std::vector<int> dests;
+    std::vector<std::vector<size_t>> order;
+    if (!this->sendIndexed(elt, indices, nullptr, TAGS::GATHER, dests, order))
+      return nullptr;
+
+    auto* result = new T[indices.size()];
+    for (size_t i = 0; i < dests.size(); ++i)
+    {
+      // Values are received in the order they were asked for.
+      T* read = nullptr;
+      message::rec_sync<T>(dests[i], TAGS::GATHER, &read);
+
+      const auto& positions = order[i];
+      for (size_t j = 0; j < positions.size(); ++j)
+        result[positions[j]] = read[j];
+
+      delete[] read;
+    }
+
+    return result;
+  }
+
+  template <typename T>
+  bool
+  Allocator::scatter(const Element<T>* elt, const std::vector<size_t>& indices,
+                     const T* values)
+  {
+    std::vector<int> dests;
+    std::vector<std::vector<size_t>> order;
+    if (!this->sendIndexed(elt, indices, (const uint8_t*)values, TAGS::SCATTER,
+                           dests, order))
+      return false;
+
+    bool success = true;
+    for (const auto& dest : dests)
+    {
       uint8_t status = 0;
-      message::rec_sync_ack(dest, TAGS::MAP, status);
+      message::rec_sync_ack(dest, TAGS::SCATTER, status);
+      success = success && (status == constant::SUCCESS);
     }
 
+    return success;
+  }
+
+  template <typename T>
+  bool
+  Allocator::copy(const Element<T>* src, Element<T>* dst)
+  {
+    if (src->getNbValues() > dst->getNbValues()) return false;
+
+    return this->transfer(src, dst);
+  }
+
+  template <typename T>
+  bool
+  Allocator::append(Element<T>* elt, const T* data, size_t nb_elts)
+  {
+    if (elt->isView() || !elt->isDense()) return false;
+    if (nb_elts == 0) return true;
+
+    return this->grow(elt, (const uint8_t*)data, nb_elts);
+  }
+
+  template <typename T>
+  bool
+  Allocator::resize(Element<T>* elt, size_t nb_elts)
+  {
+    if (elt->isView() || !elt->isDense()) return false;
+
+    if (nb_elts > elt->getNbValues())
+      return this->grow(elt, nullptr, nb_elts - elt->getNbValues());
+
+    return this->shrink(elt, nb_elts);
+  }
+
+  template <typename T>
+  Allocator*
+  Allocator::map(const Element<T>* elt, unsigned int callback_id)
+  {
+    if (!this->sendMap(elt, callback_id, callback::ElementType<T>::value, 0,
+                       0))
+      return nullptr;
+    return this;
+  }
+
+  template <typename T>
+  Allocator*
+  Allocator::mapParam(const Element<T>* elt, unsigned int kernel_id,
+                      const std::vector<T>& params)
+  {
+    // Missing parameters are 0.
+    T block[callback::MAX_PARAMS] = {};
+    std::copy_n(params.begin(), std::min(params.size(), callback::MAX_PARAMS),
+                block);
+
+    if (!this->sendMapParam(elt, kernel_id, callback::ElementType<T>::value,
+                            reinterpret_cast<const uint8_t*>(block),
+                            sizeof(block)))
+      return nullptr;
     return this;
   }
 
   template <typename T>
   T*
   Allocator::reduce(const Element<T>* elt, unsigned int callback_id, T init_val)
+  {
+    return this->sendReduce(elt, callback_id, init_val, 0, 0);
+  }
+
+  template <typename T, typename F>
+  Allocator*
+  Allocator::mapField(const Element<T>* elt, F T::*member,
+                      unsigned int callback_id)
+  {
+    const size_t record_size = fields::recordSize(fields::layout<T>());
+    const size_t column = fields::findColumn(member);
+    if (!elt->isColumnar() || column == record_size) return this;
+
+    if (!this->sendMap(elt, callback_id, callback::ElementType<F>::value,
+                       column, record_size))
+      return nullptr;
+    return this;
+  }
+
+  template <typename T, typename F>
+  F*
+  Allocator::reduceField(const Element<T>* elt, F T::*member,
+                         unsigned int callback_id, F init_val)
+  {
+    const size_t record_size = fields::recordSize(fields::layout<T>());
+    const size_t column = fields::findColumn(member);
+    if (!elt->isColumnar() || column == record_size) return nullptr;
+
+    return this->sendReduce(elt, callback_id, init_val, column, record_size);
+  }
+
+  template <typename T>
+  Statistics
+  Allocator::describe(const Element<T>* elt)
+  {
+    return this->sendDescribe(elt, callback::ElementType<T>::value, 0, 0);
+  }
+
+  template <typename T, typename F>
+  Statistics
+  Allocator::describeField(const Element<T>* elt, F T::*member)
+  {
+    const size_t record_size = fields::recordSize(fields::layout<T>());
+    const size_t column = fields::findColumn(member);
+    if (!elt->isColumnar() || column == record_size) return Statistics();
+
+    return this->sendDescribe(elt, callback::ElementType<F>::value, column,
+                              record_size);
+  }
+
+  template <typename T>
+  void
+  Allocator::topK(const Element<T>* elt, size_t k,
+                  std::vector<size_t>& indices, std::vector<T>& values,
+                  bool largest)
+  {
+    indices.clear();
+    values.clear();
+    if (k == 0) return;
+
+    std::vector<size_t> candidates;
+    std::vector<uint8_t> bytes;
+    this->receiveTopK(elt, callback::ElementType<T>::value, k, largest,
+                      candidates, bytes);
+
+    // Keeps the best candidates, the first position wins on equal values.
+    std::vector<std::pair<T, size_t>> best(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+      std::memcpy(&best[i].first, &bytes[i * sizeof(T)], sizeof(T));
+      best[i].second = candidates[i];
+    }
+    const size_t nb_best = std::min(k, best.size());
+    std::partial_sort(
+        best.begin(), best.begin() + nb_best, best.end(),
+        [largest](const std::pair<T, size_t>& a,
+                  const std::pair<T, size_t>& b) {
+          if (a.first != b.first)
+            return (largest) ? a.first > b.first : a.first < b.first;
+          return a.second < b.second;
+        });
+
+    for (size_t i = 0; i < nb_best; ++i)
+    {
+      values.push_back(best[i].first);
+      indices.push_back(best[i].second);
+    }
+  }
+
+  template <typename T>
+  QuantileSketch
+  Allocator::sketch(const Element<T>* elt, size_t accuracy)
+  {
+    return this->sendSketch(elt, callback::ElementType<T>::value, accuracy);
+  }
+
+  template <typename T>
+  HyperLogLog
+  Allocator::distinctCount(const Element<T>* elt, unsigned int precision)
+  {
+    static_assert(std::is_integral<T>::value, "values should be integers");
+
+    HyperLogLog result(precision);
+    const auto& replies =
+        this->sendHashSketch(elt, callback::ElementType<T>::value,
+                             TAGS::DISTINCT, precision, 0);
+    for (const auto& reply : replies)
+    {
+      HyperLogLog partial(precision);
+      if (partial.deserialize(reply.data(), reply.size()))
+        result.merge(partial);
+    }
+
+    return result;
+  }
+
+  template <typename T>
+  BloomFilter
+  Allocator::bloom(const Element<T>* elt, double false_positive)
+  {
+    static_assert(std::is_integral<T>::value, "values should be integers");
+
+    auto result = BloomFilter::create(elt->getNbValues(), false_positive);
+    const auto& replies = this->sendHashSketch(
+        elt, callback::ElementType<T>::value, TAGS::BLOOM,
+        result.getNbHashes(), result.getNbBits());
+    for (const auto& reply : replies)
+    {
+      BloomFilter partial;
+      if (partial.deserialize(reply.data(), reply.size()))
+        result.merge(partial);
+    }
+
+    return result;
+  }
+
+  template <typename T>
+  Element<uint8_t>*
+  Allocator::filter(const Element<T>* elt, const BloomFilter& filter)
+  {
+    static_assert(std::is_integral<T>::value, "values should be integers");
+
+    if (!elt->isDense()) return nullptr;
+
+    auto* result = new Element<uint8_t>(elt->getNbValues());
+    if (!this->sendFilter(elt, callback::ElementType<T>::value, filter,
+                          result))
+    {
+      delete result;
+      return nullptr;
+    }
+
+    return result;
+  }
+
+  template <typename T>
+  T
+  Allocator::sum(const Element<T>* elt)
+  {
+    static_assert(std::is_floating_point<T>::value,
+                  "values should be float or double");
+
+    return this->sendSum(elt, callback::ElementType<T>::value);
+  }
+
+  template <typename T>
+  ZoneMap<T>
+  Allocator::zoneMap(const Element<T>* elt)
+  {
+    ZoneMap<T> result(elt);
+    if (!elt->isDense()) return result;
+
+    std::vector<size_t> chunks(elt->getIds().size());
+    for (size_t i = 0; i < chunks.size(); ++i) chunks[i] = i;
+    const auto& replies =
+        this->sendRange(elt, TAGS::ZONE_MAP, callback::ElementType<T>::value,
+                        chunks, std::vector<uint32_t>(chunks.size(), 0), {});
+
+    // Replies lay out like this:
+    //  sizeof (uint64_t)  sizeof (uint64_t)  sizeof (T)  sizeof (T)
+    // [...NB_VALUES...]   [....Sorted....]   [..Min..]   [..Max..]
+    for (const auto& reply : replies)
+    {
+      uint64_t header[2];
+      typename ZoneMap<T>::Zone zone;
+      std::memcpy(header, &reply[0], sizeof(header));
+      std::memcpy(&zone.min, &reply[sizeof(header)], sizeof(T));
+      std::memcpy(&zone.max, &reply[sizeof(header) + sizeof(T)], sizeof(T));
+      zone.nb_values = header[0];
+      zone.sorted = header[1];
+      result.add(zone);
+    }
+
+    return result;
+  }
+
+  template <typename T>
+  size_t
+  Allocator::rangeCount(const Element<T>* elt, const T& low, const T& high,
+                        const ZoneMap<T>* zones)
+  {
+    if (!elt->isDense() || high < low) return 0;
+
+    std::vector<size_t> chunks;
+    std::vector<uint32_t> flags;
+    size_t count =
+        this->selectChunks(elt, low, high, zones, false, chunks, flags);
+    if (chunks.empty()) return count;
+
+    const T limits[2] = {low, high};
+    const auto* bytes = reinterpret_cast<const uint8_t*>(limits);
+    const auto& replies =
+        this->sendRange(elt, TAGS::RANGE, callback::ElementType<T>::value,
+                        chunks, flags,
+                        std::vector<uint8_t>(bytes, bytes + sizeof(limits)));
+    for (const auto& reply : replies)
+    {
+      uint64_t nb_values = 0;
+      std::memcpy(&nb_values, &reply[0], sizeof(uint64_t));
+      count += nb_values;
+    }
+
+    return count;
+  }
+
+  template <typename T>
+  void
+  Allocator::rangeRead(const Element<T>* elt, const T& low, const T& high,
+                       std::vector<size_t>& indices, std::vector<T>& values,
+                       const ZoneMap<T>* zones)
+  {
+    indices.clear();
+    values.clear();
+    if (!elt->isDense() || high < low) return;
+
+    std::vector<size_t> chunks;
+    std::vector<uint32_t> flags;
+    this->selectChunks(elt, low, high, zones, true, chunks, flags);
+    if (chunks.empty()) return;
+
+    const T limits[2] = {low, high};
+    const auto* bytes = reinterpret_cast<const uint8_t*>(limits);
+    const auto& replies =
+        this->sendRange(elt, TAGS::RANGE, callback::ElementType<T>::value,
+                        chunks, flags,
+                        std::vector<uint8_t>(bytes, bytes + sizeof(limits)));
+
+    // Replies lay out like this, sorted chunks sending no positions:
+    //  sizeof (uint64_t)  sizeof (uint64_t)  N * sizeof (uint64_t)   N * T
+    // [.......N.......]   [.....First.....]  [.....Positions.....]  [Values]
+    for (size_t i = 0; i < replies.size(); ++i)
+    {
+      uint64_t header[2];
+      std::memcpy(header, &replies[i][0], sizeof(header));
+      const bool sorted = flags[i] & range::SORTED;
+      const uint8_t* positions = &replies[i][0] + range::REPLY_HEADER;
+      const uint8_t* data =
+          positions + ((sorted) ? 0 : header[0] * sizeof(uint64_t));
+
+      const size_t lower = std::get<0>(elt->getBounds()[chunks[i]]);
+      const size_t offset = values.size();
+      values.resize(offset + header[0]);
+      if (header[0]) std::memcpy(&values[offset], data, header[0] * sizeof(T));
+      for (uint64_t j = 0; j < header[0]; ++j)
+      {
+        uint64_t position = header[1] + j;
+        if (!sorted)
+          std::memcpy(&position, positions + j * sizeof(uint64_t),
+                      sizeof(uint64_t));
+        indices.push_back(lower + position);
+      }
+    }
+  }
+
+  template <typename T>
+  size_t
+  Allocator::selectChunks(const Element<T>* elt, const T& low, const T& high,
+                          const ZoneMap<T>* zones, bool read,
+                          std::vector<size_t>& chunks,
+                          std::vector<uint32_t>& flags)
+  {
+    const bool zoned = zones && zones->describes(elt);
+    size_t counted = 0;
+    for (size_t i = 0; i < elt->getBounds().size(); ++i)
+    {
+      uint32_t options = (read) ? range::READ : 0;
+      if (zoned)
+      {
+        const auto& zone = zones->getZones()[i];
+        if (zone.nb_values == 0 || zone.max < low || high < zone.min)
+          continue;
+
+        // Chunks inside of the range are counted without their slave.
+        if (!read && zone.min >= low && zone.max <= high)
+        {
+          counted += zone.nb_values;
+          continue;
+        }
+        if (zone.sorted) options |= range::SORTED;
+      }
+
+      chunks.push_back(i);
+      flags.push_back(options);
+    }
+
+    return counted;
+  }
+
+  template <typename T>
+  bool
+  Allocator::stencil(const Element<T>* elt, const std::vector<T>& weights,
+                     size_t nb_steps, const Element<T>* out)
+  {
+    if (weights.size() % 2 == 0) return false;
+
+    // Parameters lay out like this:
+    //  sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t)   N * sizeof (T)
+    // [...DataType...]   [..NB_WEIGHTS..]   [...NB_STEPS...]   [..Weights..]
+    const uint32_t header[2] = {callback::ElementType<T>::value,
+                                (uint32_t)weights.size()};
+    const uint64_t steps = nb_steps;
+    std::vector<uint8_t> params(sizeof(header) + sizeof(steps) +
+                                weights.size() * sizeof(T));
+    std::memcpy(&params[0], header, sizeof(header));
+    std::memcpy(&params[sizeof(header)], &steps, sizeof(steps));
+    std::memcpy(&params[sizeof(header) + sizeof(steps)], &weights[0],
+                weights.size() * sizeof(T));
+
+    return this->sendHalo(elt, (out) ? out : elt, TAGS::STENCIL,
+                          weights.size() / 2, params);
+  }
+
+  template <typename T>
+  Element<T>*
+  Allocator::rolling(const Element<T>* elt, size_t window, unsigned int kind)
+  {
+    if (window == 0 || !elt->isDense()) return nullptr;
+
+    auto* result = this->reserveLike<T>(elt);
+    if (result == nullptr) return nullptr;
+
+    // Parameters lay out like this:
+    //  sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t)
+    // [...DataType...]   [.....KIND.....]   [....WINDOW....]
+    const uint32_t header[2] = {callback::ElementType<T>::value, kind};
+    const uint64_t nb_values = window;
+    std::vector<uint8_t> params(sizeof(header) + sizeof(nb_values));
+    std::memcpy(&params[0], header, sizeof(header));
+    std::memcpy(&params[sizeof(header)], &nb_values, sizeof(nb_values));
+
+    // Halos are gathered over as many chunks as needed, so chunks of any
+    // length are accepted.
+    if (!this->sendHalo(elt, result, TAGS::ROLLING, 0, params))
+    {
+      this->free(result);
+      return nullptr;
+    }
+
+    return result;
+  }
+
+  template <typename T>
+  Element<T>*
+  Allocator::matvec(const Matrix<T>* mat, const Element<T>* vec)
+  {
+    const size_t nb_cols = mat->getNbCols();
+    if (!vec->isDense() || vec->getNbValues() != nb_cols) return nullptr;
+
+    auto* result = this->reserveRows<T>(mat, nb_cols);
+    if (result == nullptr) return nullptr;
+
+    // Parameters lay out like this:
+    //  sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t)  M * sizeof (T)
+    // [...DataType...]   [....Unused....]   [.....NB_COLS....]  [..Vector..]
+    const uint32_t header[2] = {callback::ElementType<T>::value, 0};
+    const uint64_t cols = nb_cols;
+    std::vector<uint8_t> params(sizeof(header) + sizeof(cols) +
+                                nb_cols * sizeof(T));
+    std::memcpy(&params[0], header, sizeof(header));
+    std::memcpy(&params[sizeof(header)], &cols, sizeof(cols));
+    T* values = this->read(vec);
+    std::memcpy(&params[sizeof(header) + sizeof(cols)], values,
+                nb_cols * sizeof(T));
+    delete[] values;
+
+    std::vector<std::vector<uint8_t>> replies;
+    if (!this->sendMatrix(mat, result, TAGS::MATVEC, params, nullptr, 0,
+                          replies))
+    {
+      this->free(result);
+      return nullptr;
+    }
+
+    return result;
+  }
+
+  template <typename T>
+  Element<T>*
+  Allocator::matvecTransposed(const Matrix<T>* mat, const Element<T>* vec)
+  {
+    const size_t nb_cols = mat->getNbCols();
+    if (!vec->isDense() || vec->getNbValues() != mat->getNbRows())
+      return nullptr;
+
+    // Parameters lay out like this:
+    //  sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t)
+    // [...DataType...]   [....Unused....]   [.....NB_COLS....]
+    const uint32_t header[2] = {callback::ElementType<T>::value, 0};
+    const uint64_t cols = nb_cols;
+    std::vector<uint8_t> params(sizeof(header) + sizeof(cols));
+    std::memcpy(&params[0], header, sizeof(header));
+    std::memcpy(&params[sizeof(header)], &cols, sizeof(cols));
+
+    // Every slave only receives the values of the vector facing its rows.
+    T* values = this->read(vec);
+    std::vector<std::vector<uint8_t>> replies;
+    bool success = this->sendMatrix(
+        mat, nullptr, TAGS::MATVEC_TRANSPOSED, params,
+        reinterpret_cast<const uint8_t*>(values), sizeof(T), replies);
+    delete[] values;
+    if (!success) return nullptr;
+
+    // Partial sums are added in the order of the slaves.
+    std::vector<T> sums(nb_cols, 0);
+    for (const auto& reply : replies)
+    {
+      const T* partial = reinterpret_cast<const T*>(&reply[0]);
+      for (size_t i = 0; i < nb_cols; ++i) sums[i] += partial[i];
+    }
+
+    return this->reserve<T>(nb_cols, &sums[0]);
+  }
+
+  template <typename T>
+  Element<T>*
+  Allocator::reduceRows(const Matrix<T>* mat, unsigned int callback_id,
+                        T init_val)
+  {
+    const size_t nb_cols = mat->getNbCols();
+    auto* result = this->reserveRows<T>(mat, nb_cols);
+    if (result == nullptr) return nullptr;
+
+    // Parameters lay out like this:
+    //  sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t)  sizeof (T)
+    // [...DataType...]   [..CALLBACK_ID..]  [.....NB_COLS....]  [..Init..]
+    const uint32_t header[2] = {callback::ElementType<T>::value, callback_id};
+    const uint64_t cols = nb_cols;
+    std::vector<uint8_t> params(sizeof(header) + sizeof(cols) + sizeof(T));
+    std::memcpy(&params[0], header, sizeof(header));
+    std::memcpy(&params[sizeof(header)], &cols, sizeof(cols));
+    std::memcpy(&params[sizeof(header) + sizeof(cols)], &init_val, sizeof(T));
+
+    std::vector<std::vector<uint8_t>> replies;
+    if (!this->sendMatrix(mat, result, TAGS::REDUCE_ROWS, params, nullptr, 0,
+                          replies))
+    {
+      this->free(result);
+      return nullptr;
+    }
+
+    return result;
+  }
+
+  template <typename T>
+  Element<T>*
+  Allocator::reserveRows(const BaseElement* mat, size_t nb_cols)
+  {
+    const auto& nodes = this->planRows(mat, nb_cols);
+    if (nodes.size() == 0) return nullptr;
+
+    auto* result = new Element<T>(mat->getNbValues() / nb_cols);
+    this->sendFill(nodes, sizeof(T), nullptr);
+    if (!this->track(nodes, result))
+    {
+      delete result;
+      return nullptr;
+    }
+
+    return result;
+  }
+
+  template <typename T>
+  T*
+  Allocator::sendReduce(const BaseElement* elt, unsigned int callback_id,
+                        T init_val, size_t column, size_t record_size)
   {
     static constexpr unsigned int UINT_LEN = sizeof(unsigned int);
-    static constexpr unsigned int DATA_LEN = 2 * UINT_LEN + 64;
+    static constexpr unsigned int DATA_LEN = 4 * UINT_LEN + 64;
     const auto& ids = elt->getIds();
 
     if (ids.size() == 0) return nullptr;
@@ -275,8 +1225,10 @@ namespace algorep
     }
 
     // Sends the data with this layout:
-    //  64 bytes       sizeof (uint)      sizeof (uint)        N
-    // [ACCUMULATOR] [...DATA_TYPE...] [...CALLBACK_ID...]  [nodes]
+    //  64 bytes       sizeof (uint)      sizeof (uint)      2 * sizeof (uint)
+    // [ACCUMULATOR] [...DATA_TYPE...] [...CALLBACK_ID...] [COLUMN, RECORD]
+    //   N
+    // [nodes]
     size_t nb_bytes = DATA_LEN + nodes_list.length() + 1;
     std::vector<uint8_t> data(nb_bytes);
 
@@ -284,9 +1236,12 @@ namespace algorep
     std::memset(&data[0], 0, 64);
     std::memcpy(&data[0], &init_val, sizeof(T));
     // Copies data type
+    const unsigned int column_info[2] = {(unsigned int)column,
+                                         (unsigned int)record_size};
     std::memcpy(&data[0] + 64, &callback::ElementType<T>::value, UINT_LEN);
     std::memcpy(&data[0] + 64 + UINT_LEN, &callback_id, UINT_LEN);
-    std::memcpy(&data[0] + 64 + 2 * UINT_LEN, nodes_list.c_str(),
+    std::memcpy(&data[0] + 64 + 2 * UINT_LEN, column_info, 2 * UINT_LEN);
+    std::memcpy(&data[0] + DATA_LEN, nodes_list.c_str(),
                 nodes_list.length() + 1);
 
     // Sends message to first node of the list.
@@ -300,4 +1255,154 @@ namespace algorep
     return read;
   }
 
+  template <typename T>
+  Operation*
+  Allocator::prepareMap(const Element<T>* elt, unsigned int callback_id)
+  {
+    static constexpr int DATA_TYPE = callback::ElementType<T>::value;
+    const auto& ids = elt->getIds();
+
+    auto* op = new Operation();
+    op->headers_.resize(ids.size());
+    op->sends_.resize(ids.size());
+    op->recvs_.resize(ids.size());
+    op->acks_.resize(ids.size(), constant::FAIL);
+
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      const int dest = elt->getIntIds()[i];
+
+      // The message is exactly the one sent by `map', it is simply
+      // built once.
+      std::string id = ids[i] + "-" + std::to_string(callback_id);
+      id += "-" + std::to_string(DATA_TYPE);
+
+      auto& header = op->headers_[i];
+      header.assign(id.c_str(), id.c_str() + id.length() + 1);
+
+      MPI_Send_init(&header[0], header.size(), MPI_BYTE, dest, TAGS::MAP,
+                    MPI_COMM_WORLD, &op->sends_[i]);
+      MPI_Recv_init(&op->acks_[i], 1, MPI_BYTE, dest, TAGS::MAP,
+                    MPI_COMM_WORLD, &op->recvs_[i]);
+    }
+
+    return op;
+  }
+
+  template <typename T>
+  Operation*
+  Allocator::prepareReduce(const Element<T>* elt, unsigned int callback_id,
+                           T init_val)
+  {
+    static constexpr unsigned int UINT_LEN = sizeof(unsigned int);
+    static constexpr unsigned int DATA_LEN = 4 * UINT_LEN + 64;
+    const auto& ids = elt->getIds();
+
+    if (ids.size() == 0) return nullptr;
+
+    const int dest = elt->getIntIds()[0];
+    const int last = elt->getIntIds()[ids.size() - 1];
+
+    std::string nodes_list;
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      if (i == ids.size() - 1)
+        nodes_list += ids[i];
+      else
+        nodes_list += ids[i] + "-";
+    }
+
+    auto* op = new Operation();
+    op->headers_.resize(1);
+    op->sends_.resize(1);
+    op->recvs_.resize(1);
+    op->result_.resize(sizeof(T));
+
+    // Same layout as `reduce', whole chunks are reduced:
+    //  64 bytes       sizeof (uint)      sizeof (uint)      2 * sizeof (uint)
+    // [ACCUMULATOR] [...DATA_TYPE...] [...CALLBACK_ID...] [COLUMN, RECORD]
+    //   N
+    // [nodes]
+    // Slaves never modify the sent buffer, the initial accumulator
+    // is thus the same at each start.
+    auto& data = op->headers_[0];
+    data.resize(DATA_LEN + nodes_list.length() + 1, 0);
+    std::memcpy(&data[0], &init_val, sizeof(T));
+    std::memcpy(&data[0] + 64, &callback::ElementType<T>::value, UINT_LEN);
+    std::memcpy(&data[0] + 64 + UINT_LEN, &callback_id, UINT_LEN);
+    std::memcpy(&data[0] + DATA_LEN, nodes_list.c_str(),
+                nodes_list.length() + 1);
+
+    MPI_Send_init(&data[0], data.size(), MPI_BYTE, dest, TAGS::REDUCE,
+                  MPI_COMM_WORLD, &op->sends_[0]);
+    MPI_Recv_init(&op->result_[0], sizeof(T), MPI_BYTE, last, TAGS::REDUCE,
+                  MPI_COMM_WORLD, &op->recvs_[0]);
+
+    return op;
+  }
+
+  template <typename T>
+  Operation*
+  Allocator::prepareWrite(const Element<T>* elt, const T* data,
+                          size_t nb_elts)
+  {
+    static constexpr int HEADER_LEN = constant::ID_LEN + sizeof(size_t);
+
+    if (!elt->isDense() || nb_elts > elt->getNbValues()) return nullptr;
+    nb_elts = (nb_elts == 0) ? elt->getNbValues() : nb_elts;
+
+    const auto& ids = elt->getIds();
+    const auto& bounds = elt->getBounds();
+
+    auto* op = new Operation();
+    op->clock_ = &this->clock_;
+    for (size_t i = 0; i < ids.size() && nb_elts > 0; ++i)
+    {
+      const auto& id = ids[i];
+      const auto& lower = std::get<0>(bounds[i]);
+      const auto& upper = std::get<1>(bounds[i]);
+
+      size_t sub_nb_values = std::min(upper - lower + 1, nb_elts);
+      nb_elts -= sub_nb_values;
+
+      // The ID and the clock are stored in a small header. The clock
+      // is updated by `Operation::start'.
+      op->headers_.emplace_back(HEADER_LEN, 0);
+      auto& header = op->headers_.back();
+      std::memcpy(&header[0], id.c_str(), id.length());
+
+      // Instead of copying the data after each update, we describe the
+      // message with a datatype pointing directly to the user data:
+      //    N bytes      22 bytes   sizeof (size_t)
+      // [...Data...]   [...ID...]   [..Clock..]
+      int lengths[2] = {(int)(sub_nb_values * sizeof(T)), HEADER_LEN};
+      MPI_Aint displacements[2];
+      MPI_Get_address(data + lower, &displacements[0]);
+      MPI_Get_address(&header[0], &displacements[1]);
+      MPI_Datatype types[2] = {MPI_BYTE, MPI_BYTE};
+
+      MPI_Datatype type;
+      MPI_Type_create_struct(2, lengths, displacements, types, &type);
+      MPI_Type_commit(&type);
+      op->types_.push_back(type);
+
+      const int dest = elt->getIntIds()[i];
+      op->sends_.emplace_back();
+      op->recvs_.emplace_back();
+      MPI_Send_init(MPI_BOTTOM, 1, type, dest, TAGS::WRITE, MPI_COMM_WORLD,
+                    &op->sends_.back());
+    }
+
+    // Acknowledges are stored once every request has been created,
+    // the vector is never resized afterwards.
+    op->acks_.resize(op->recvs_.size(), constant::FAIL);
+    for (size_t i = 0; i < op->recvs_.size(); ++i)
+    {
+      MPI_Recv_init(&op->acks_[i], 1, MPI_BYTE, elt->getIntIds()[i],
+                    TAGS::WRITE, MPI_COMM_WORLD, &op->recvs_[i]);
+    }
+
+    return op;
+  }
+
 }  // namespace algorep
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <constant/constants.h>
+
+/**
+ * @file checkpoint.h
+ * @brief Describes the files of a checkpoint. The master writes the
+ * metadata of every element, and each slave writes its own chunks in a
+ * separate file. Every structure is written as is.
+ * @author David Peicho, Sarasvati Moutoucomarapoulé
+ * @version 1.0
+ * @date 2017-12-21
+ */
+
+namespace algorep
+{
+  namespace checkpoint
+  {
+    /**
+     * @brief First bytes of every checkpoint file.
+     */
+    constexpr static char MAGIC[8] = {'A', 'L', 'G', 'O', 'C', 'K', 'P', 1};
+
+    /**
+     * @brief Get the file written by a node in a checkpoint directory.
+     *
+     * @param dir Checkpoint directory.
+     * @param rank Rank of the node, 0 for the master.
+     *
+     * @return Path of the file.
+     */
+    inline std::string
+    getPath(const std::string& dir, int rank)
+    {
+      if (rank == 0) return dir + "/master.ckpt";
+      return dir + "/rank_" + std::to_string(rank) + ".ckpt";
+    }
+
+    /**
+     * @brief Header of the file of the master, followed by each element.
+     */
+    struct MasterHeader
+    {
+      char magic[8];
+      uint64_t nb_nodes;
+      uint64_t clock;
+      uint64_t nb_elements;
+    };
+
+    /**
+     * @brief Metadata of an element, followed by its chunks.
+     */
+    struct ElementRecord
+    {
+      uint64_t nb_values;
+      uint64_t capacity;
+      uint32_t atom_size;
+      uint32_t nb_chunks;
+      uint64_t storage;
+    };
+
+    /**
+     * @brief Chunk of an element, as seen by the master.
+     */
+    struct BoundRecord
+    {
+      char id[constant::ID_LEN];
+      uint64_t lower;
+      uint64_t upper;
+    };
+
+    /**
+     * @brief Header of the file of a slave, followed by the table
+     * of its chunks.
+     */
+    struct SlaveHeader
+    {
+      char magic[8];
+      uint64_t next_id;
+      uint64_t nb_chunks;
+    };
+
+    /**
+     * @brief Chunk of a slave, with its write history. The bytes of the
+     * chunk are stored at `offset`, which is aligned on a page.
+     */
+    struct ChunkRecord
+    {
+      char id[constant::ID_LEN];
+      uint64_t size;
+      uint64_t capacity;
+      uint64_t offset;
+      uint64_t old_clock;
+      uint64_t new_clock;
+      int64_t old_size;
+      int64_t new_size;
+      uint64_t sparse;
+      uint64_t nb_values;
+    };
+  }  // namespace checkpoint
+}  // namespace algorep
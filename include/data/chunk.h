@@ -0,0 +1,278 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @file chunk.h
+ * @brief Describes the storage of a chunk on a slave. A chunk is either
+ * kept in RAM, or spilled to a memory-mapped file when the slave is full.
+ * @author David Peicho, Sarasvati Moutoucomarapoulé
+ * @version 1.0
+ * @date 2017-12-21
+ */
+
+namespace algorep
+{
+  /**
+   * @brief Allocator leaving new values uninitialized when a vector grows,
+   * instead of setting them to zero.
+   *
+   * @tparam T Type of the values.
+   */
+  template <typename T>
+  struct UninitializedAllocator : std::allocator<T>
+  {
+    template <typename U>
+    struct rebind
+    {
+      using other = UninitializedAllocator<U>;
+    };
+
+    using std::allocator<T>::allocator;
+
+    template <typename U>
+    void
+    construct(U* ptr) noexcept(std::is_nothrow_default_constructible<U>::value)
+    {
+      ::new (static_cast<void*>(ptr)) U;
+    }
+
+    template <typename U, typename... Args>
+    void
+    construct(U* ptr, Args&&... args)
+    {
+      ::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+    }
+  };
+
+  /**
+   * @brief Bytes of a chunk, with the interface of `std::vector<uint8_t>`.
+   * Once spilled, the bytes live in an unlinked file mapped in memory:
+   * pages are read back by the kernel when they are accessed.
+   */
+  class Chunk
+  {
+    public:
+    /**
+     * @brief Bytes kept in RAM.
+     */
+    using Bytes = std::vector<uint8_t, UninitializedAllocator<uint8_t>>;
+
+    public:
+    /**
+     * @brief Constructor. The chunk is empty, and kept in RAM.
+     */
+    Chunk() : fd_{-1}, map_{nullptr}, size_{0}, capacity_{0}
+    {
+    }
+
+    /**
+     * @brief Destructor. Unmaps the file of a spilled chunk.
+     */
+    ~Chunk();
+
+    /**
+     * @brief Move constructor.
+     *
+     * @param other Chunk to move, left empty.
+     */
+    Chunk(Chunk&& other);
+
+    /**
+     * @brief Move assignment.
+     *
+     * @param other Chunk to move, left empty.
+     *
+     * @return This chunk.
+     */
+    Chunk&
+    operator=(Chunk&& other);
+
+    Chunk(const Chunk&) = delete;
+    Chunk&
+    operator=(const Chunk&) = delete;
+
+    public:
+    /**
+     * @brief Change the number of bytes of the chunk.
+     *
+     * @param nb_bytes New size.
+     * @param zero Whether new bytes are set to zero. Otherwise, they are
+     * left uninitialized.
+     *
+     * @throw std::bad_alloc if the memory or the file can not grow.
+     */
+    void
+    resize(size_t nb_bytes, bool zero = true);
+
+    /**
+     * @brief Reserve memory for the chunk, without changing its size.
+     *
+     * @param nb_bytes Number of bytes to reserve.
+     *
+     * @throw std::bad_alloc if the memory or the file can not grow.
+     */
+    void
+    reserve(size_t nb_bytes);
+
+    /**
+     * @brief Free the bytes of the chunk, and put it back in RAM.
+     */
+    void
+    clear();
+
+    /**
+     * @brief Move the bytes of the chunk to a file. The file is removed
+     * as soon as it is mapped, so that it does not outlive the slave.
+     *
+     * @param path File to create.
+     *
+     * @return Whether the chunk has been spilled.
+     */
+    bool
+    spill(const std::string& path);
+
+    /**
+     * @brief Move the bytes of a spilled chunk back to RAM.
+     *
+     * @return Whether the chunk is in RAM.
+     */
+    bool
+    load();
+
+    /**
+     * @brief Give the kernel a hint on how a spilled chunk is accessed.
+     * Nothing is done for a chunk in RAM.
+     *
+     * @param advice Advice given to `madvise`, such as MADV_SEQUENTIAL.
+     */
+    void
+    advise(int advice) const;
+
+    public:
+    /**
+     * @brief Check whether the chunk is backed by a file.
+     *
+     * @return True if the chunk is spilled.
+     */
+    inline bool
+    isSpilled() const
+    {
+      return this->fd_ != -1;
+    }
+
+    /**
+     * @brief Get the size of the chunk.
+     *
+     * @return Number of bytes.
+     */
+    inline size_t
+    size() const
+    {
+      return (this->isSpilled()) ? this->size_ : this->ram_.size();
+    }
+
+    /**
+     * @brief Get the capacity of the chunk.
+     *
+     * @return Number of bytes reserved, in RAM or on disk.
+     */
+    inline size_t
+    capacity() const
+    {
+      return (this->isSpilled()) ? this->capacity_ : this->ram_.capacity();
+    }
+
+    /**
+     * @brief Get the bytes of the chunk.
+     *
+     * @return Pointer to the first byte.
+     */
+    inline uint8_t*
+    data()
+    {
+      return (this->isSpilled()) ? this->map_ : this->ram_.data();
+    }
+
+    /**
+     * @brief Get the bytes of the chunk as const.
+     *
+     * @return Pointer to the first byte.
+     */
+    inline const uint8_t*
+    data() const
+    {
+      return (this->isSpilled()) ? this->map_ : this->ram_.data();
+    }
+
+    /**
+     * @brief Get a byte of the chunk.
+     *
+     * @param i Position of the byte.
+     *
+     * @return Byte at position i.
+     */
+    inline uint8_t&
+    operator[](size_t i)
+    {
+      return this->data()[i];
+    }
+
+    /**
+     * @brief Get a byte of the chunk as const.
+     *
+     * @param i Position of the byte.
+     *
+     * @return Byte at position i.
+     */
+    inline const uint8_t&
+    operator[](size_t i) const
+    {
+      return this->data()[i];
+    }
+
+    private:
+    /**
+     * @brief Map the file of a spilled chunk with a new capacity.
+     *
+     * @param capacity Number of bytes to map.
+     *
+     * @return Whether the file has been mapped.
+     */
+    bool
+    remap(size_t capacity);
+
+    private:
+    /**
+     * @brief Bytes of the chunk, when it is kept in RAM.
+     */
+    Bytes ram_;
+
+    /**
+     * @brief Descriptor of the file of a spilled chunk, -1 otherwise.
+     */
+    int fd_;
+
+    /**
+     * @brief Mapping of the file of a spilled chunk.
+     */
+    uint8_t* map_;
+
+    /**
+     * @brief Size of a spilled chunk.
+     */
+    size_t size_;
+
+    /**
+     * @brief Size of the file of a spilled chunk.
+     */
+    size_t capacity_;
+  };
+}  // namespace algorep
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file codec.h
+ * @brief Describes the compression of the payloads sent between the master
+ * and the slaves. A compressed payload starts with a header, telling the
+ * receiver how to decode it.
+ * @author David Peicho, Sarasvati Moutoucomarapoulé
+ * @version 1.0
+ * @date 2017-12-21
+ */
+
+namespace algorep
+{
+  namespace codec
+  {
+    /**
+     * @brief Encoding of a payload.
+     */
+    enum Codec
+    {
+      // Bytes are sent as is.
+      RAW = 0,
+      // Differences between consecutive integers, as zigzag varints.
+      DELTA_VARINT,
+      // Bytes grouped by position in the element, then compressed with LZ.
+      SHUFFLE_LZ,
+      // Runs of zero bytes are replaced by their length.
+      ZERO_RLE
+    };
+
+    /**
+     * @brief Header of a compressed payload. It is sent as is.
+     */
+    struct CodecHeader
+    {
+      /**
+       * @brief Encoding of the payload, see `Codec`.
+       */
+      uint8_t codec;
+
+      /**
+       * @brief Type of the elements (see `DataType`).
+       */
+      uint8_t data_type;
+
+      /**
+       * @brief Size of one element.
+       */
+      uint16_t atom_size;
+
+      /**
+       * @brief Unused, keeps `raw_size` aligned.
+       */
+      uint32_t reserved;
+
+      /**
+       * @brief Number of bytes once decoded.
+       */
+      uint64_t raw_size;
+    };
+
+    /**
+     * @brief Compress bytes, choosing the encoding from the type of the
+     * elements. Payloads smaller than `threshold`, or not compressing well
+     * enough on a sample, are sent raw.
+     *
+     * @param data Bytes to compress.
+     * @param nb_bytes Size of data.
+     * @param data_type Type of the elements (see `DataType`).
+     * @param atom_size Size of one element.
+     * @param threshold Minimum size of a compressed payload.
+     * @param out Filled with the header, followed by the encoded bytes.
+     */
+    void
+    encode(const uint8_t* data, size_t nb_bytes, unsigned int data_type,
+           unsigned int atom_size, size_t threshold,
+           std::vector<uint8_t>& out);
+
+    /**
+     * @brief Read the header of a compressed payload.
+     *
+     * @param data Compressed payload.
+     * @param nb_bytes Size of data.
+     * @param header Filled with the header.
+     *
+     * @return Whether the payload starts with a valid header.
+     */
+    bool
+    readHeader(const uint8_t* data, size_t nb_bytes, CodecHeader& header);
+
+    /**
+     * @brief Decompress a payload.
+     *
+     * @param data Compressed payload, starting with its header.
+     * @param nb_bytes Size of data.
+     * @param out Filled with the decoded bytes.
+     * @param out_bytes Size of out, which has to be the decoded size.
+     *
+     * @return Whether the payload has been decoded.
+     */
+    bool
+    decode(const uint8_t* data, size_t nb_bytes, uint8_t* out,
+           size_t out_bytes);
+  }  // namespace codec
+}  // namespace algorep
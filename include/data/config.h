@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+
+#include <constant/constants.h>
+
+/**
+ * @file config.h
+ * @brief Describes the settings sent by the master to every slave.
+ * @author David Peicho, Sarasvati Moutoucomarapoulé
+ * @version 1.0
+ * @date 2017-12-21
+ */
+
+namespace algorep
+{
+  /**
+   * @brief Settings of a slave. It is sent as is in CONFIG messages.
+   */
+  struct NodeConfig
+  {
+    /**
+     * @brief Number of bytes a slave can store on disk in addition to its
+     * maximum memory. 0 disables spilling.
+     */
+    size_t disk_budget;
+
+    /**
+     * @brief Directory receiving the files of spilled chunks.
+     */
+    char scratch_dir[constant::PATH_LEN];
+  };
+}  // namespace algorep
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdlib>
+#include <string>
 #include <tuple>
 #include <unordered_map>
+#include <vector>
 
 /**
  * @file element.h
@@ -31,6 +35,19 @@ namespace algorep
     }
   }
 
+  /**
+   * @brief Storage of the values of an element in its chunks.
+   */
+  enum Storage
+  {
+    // Values are stored one after the other.
+    DENSE = 0,
+    // Only the non-zero values are stored, after their positions.
+    SPARSE,
+    // Records are stored as one column per field.
+    COLUMNS
+  };
+
   /**
    * @brief This class allows us to make type-erasure when freing a variable
    * of type Element<T>.
@@ -43,16 +60,20 @@ namespace algorep
      *
      * @param nb_values Number of elements in data.
      * @param atom_size Size of one element.
+     * @param view Whether the element only views chunks owned by another.
+     * @param storage Storage of the values in the chunks.
      */
-    BaseElement(size_t nb_values, unsigned int atom_size)
-        : nb_values_{nb_values}, atom_size_{atom_size}
+    BaseElement(size_t nb_values, unsigned int atom_size, bool view = false,
+                Storage storage = Storage::DENSE)
+        : nb_values_{nb_values}, atom_size_{atom_size}, view_{view},
+          storage_{storage}, capacity_{0}
     {
     }
 
     /**
-     * @brief Destructor.
+     * @brief Destructor. Elements are freed through their base class.
      */
-    ~BaseElement(){};
+    virtual ~BaseElement(){};
 
     public:
     /**
@@ -67,6 +88,105 @@ namespace algorep
       this->bounds_.push_back(bounds);
       this->ids_.push_back(id);
       this->int_ids_.push_back(getRankFromId(id));
+      this->capacity_ = std::get<1>(bounds) - std::get<0>(bounds) + 1;
+    }
+
+    /**
+     * @brief Stop tracking the last chunk of data.
+     */
+    inline void
+    removeLast()
+    {
+      const auto& bounds = this->bounds_.back();
+      this->nb_values_ -= std::get<1>(bounds) - std::get<0>(bounds) + 1;
+
+      this->bounds_.pop_back();
+      this->ids_.pop_back();
+      this->int_ids_.pop_back();
+
+      // Previous chunks are always full.
+      if (this->bounds_.size())
+      {
+        const auto& last = this->bounds_.back();
+        this->capacity_ = std::get<1>(last) - std::get<0>(last) + 1;
+      }
+      else
+        this->capacity_ = 0;
+    }
+
+    /**
+     * @brief Change the number of elements in the last chunk of data.
+     *
+     * @param nb_values Number of elements in the last chunk.
+     */
+    inline void
+    resizeLast(size_t nb_values)
+    {
+      auto& bounds = this->bounds_.back();
+      this->nb_values_ -= std::get<1>(bounds) - std::get<0>(bounds) + 1;
+      this->nb_values_ += nb_values;
+      std::get<1>(bounds) = std::get<0>(bounds) + nb_values - 1;
+    }
+
+    /**
+     * @brief Change the number of elements of any chunk, following chunks
+     * being moved after it.
+     *
+     * @param index Position of the chunk.
+     * @param nb_values Number of elements in the chunk.
+     */
+    inline void
+    resizeChunk(size_t index, size_t nb_values)
+    {
+      auto& bounds = this->bounds_[index];
+      const size_t delta = nb_values - (std::get<1>(bounds) -
+                                        std::get<0>(bounds) + 1);
+      this->nb_values_ += delta;
+      std::get<1>(bounds) += delta;
+      for (size_t i = index + 1; i < this->bounds_.size(); ++i)
+      {
+        std::get<0>(this->bounds_[i]) += delta;
+        std::get<1>(this->bounds_[i]) += delta;
+      }
+      if (index + 1 == this->bounds_.size()) this->capacity_ = nb_values;
+    }
+
+    /**
+     * @brief Exchange the chunks of two elements. This is used when data
+     * are moved to new chunks.
+     *
+     * @param other Element to exchange chunks with.
+     */
+    inline void
+    swapChunks(BaseElement& other)
+    {
+      std::swap(this->bounds_, other.bounds_);
+      std::swap(this->ids_, other.ids_);
+      std::swap(this->int_ids_, other.int_ids_);
+      std::swap(this->capacity_, other.capacity_);
+    }
+
+    /**
+     * @brief Set the number of elements in data.
+     *
+     * @param nb_values Number of elements.
+     */
+    inline void
+    setNbValues(size_t nb_values)
+    {
+      this->nb_values_ = nb_values;
+    }
+
+    /**
+     * @brief Set the number of elements the last chunk can hold without
+     * being reallocated.
+     *
+     * @param capacity Number of elements.
+     */
+    inline void
+    setCapacity(size_t capacity)
+    {
+      this->capacity_ = capacity;
     }
 
     public:
@@ -81,6 +201,28 @@ namespace algorep
       return this->bounds_;
     }
 
+    /**
+     * @brief Find the chunk containing a given element, using a binary
+     * search over the bounds.
+     *
+     * @param index Index of the element.
+     *
+     * @return Position of the chunk, or the number of chunks if the
+     * index is out of bounds.
+     */
+    inline size_t
+    findChunk(size_t index) const
+    {
+      if (index >= this->nb_values_) return this->bounds_.size();
+
+      auto it = std::upper_bound(
+          this->bounds_.begin(), this->bounds_.end(), index,
+          [](size_t i, const std::tuple<size_t, size_t>& bound) {
+            return i < std::get<0>(bound);
+          });
+      return (it - this->bounds_.begin()) - 1;
+    }
+
     /**
      * @brief Get nodes identifiers where the data is.
      *
@@ -125,6 +267,90 @@ namespace algorep
       return this->atom_size_;
     }
 
+    /**
+     * @brief Get the number of elements the last chunk can hold.
+     *
+     * @return Capacity of the last chunk.
+     */
+    inline size_t
+    getCapacity() const
+    {
+      return this->capacity_;
+    }
+
+    /**
+     * @brief Check whether the element is a view on another element.
+     * Freeing a view never frees the memory of the slaves.
+     *
+     * @return Whether the element is a view.
+     */
+    inline bool
+    isView() const
+    {
+      return this->view_;
+    }
+
+    /**
+     * @brief Get the storage of the values in the chunks.
+     *
+     * @return Storage of the element.
+     */
+    inline Storage
+    getStorage() const
+    {
+      return this->storage_;
+    }
+
+    /**
+     * @brief Check whether the chunks store every value, one after the
+     * other. Other elements are read, mapped and reduced, but can not be
+     * written, viewed, resized nor copied.
+     *
+     * @return Whether the element is dense.
+     */
+    inline bool
+    isDense() const
+    {
+      return this->storage_ == Storage::DENSE;
+    }
+
+    /**
+     * @brief Check whether the chunks of the element only store the
+     * non-zero values, with their positions.
+     *
+     * @return Whether the element is sparse.
+     */
+    inline bool
+    isSparse() const
+    {
+      return this->storage_ == Storage::SPARSE;
+    }
+
+    /**
+     * @brief Check whether the chunks of the element store one column
+     * per field of the records (see `ALGOREP_FIELDS`).
+     *
+     * @return Whether the element is stored by columns.
+     */
+    inline bool
+    isColumnar() const
+    {
+      return this->storage_ == Storage::COLUMNS;
+    }
+
+    /**
+     * @brief Check whether the element is only described by its chunks, so
+     * that `restore` rebuilds it. Sparse and columnar elements, and
+     * subclasses keeping their own metadata, are not.
+     *
+     * @return Whether the element can be saved by `checkpoint`.
+     */
+    virtual bool
+    isCheckpointable() const
+    {
+      return this->isDense();
+    }
+
     protected:
     /**
      * @brief Number of element.
@@ -136,6 +362,22 @@ namespace algorep
      */
     unsigned int atom_size_;
 
+    /**
+     * @brief Whether the chunks are owned by another element.
+     */
+    bool view_;
+
+    /**
+     * @brief Storage of the values in the chunks.
+     */
+    Storage storage_;
+
+    /**
+     * @brief Number of elements the last chunk can hold. Only the last
+     * chunk can be grown, the previous ones are always full.
+     */
+    size_t capacity_;
+
     /**
      * @brief Bounds of chunks of data on each node.
      */
@@ -167,7 +409,84 @@ namespace algorep
      * @brief Constructor.
      *
      * @param nb_values Number of elements in data.
+     * @param view Whether the element only views chunks owned by another.
+     * @param storage Storage of the values in the chunks.
+     * @param atom_size Bytes of one element in the chunks, sizeof (T)
+     * if 0.
+     */
+    Element(size_t nb_values, bool view = false,
+            Storage storage = Storage::DENSE, unsigned int atom_size = 0)
+        : BaseElement(nb_values, (atom_size) ? atom_size : sizeof(T), view,
+                      storage)
+    {
+    }
+  };
+
+  /**
+   * @brief Element holding a matrix, stored row after row. Chunks always
+   * hold whole rows, so that slaves compute on rows without exchanging
+   * values.
+   *
+   * @tparam T
+   */
+  template <typename T>
+  class Matrix : public Element<T>
+  {
+    public:
+    /**
+     * @brief Constructor.
+     *
+     * @param nb_rows Number of rows.
+     * @param nb_cols Number of values of a row.
+     */
+    Matrix(size_t nb_rows, size_t nb_cols)
+        : Element<T>(nb_rows * nb_cols), nb_rows_{nb_rows}, nb_cols_{nb_cols}
+    {
+    }
+
+    public:
+    /**
+     * @brief Get the number of rows.
+     *
+     * @return Number of rows.
+     */
+    inline size_t
+    getNbRows() const
+    {
+      return this->nb_rows_;
+    }
+
+    /**
+     * @brief Get the number of values of a row.
+     *
+     * @return Number of columns.
+     */
+    inline size_t
+    getNbCols() const
+    {
+      return this->nb_cols_;
+    }
+
+    /**
+     * @brief Matrices are not saved, their shape being lost by `restore`.
+     *
+     * @return False.
+     */
+    bool
+    isCheckpointable() const override
+    {
+      return false;
+    }
+
+    protected:
+    /**
+     * @brief Number of rows.
+     */
+    size_t nb_rows_;
+
+    /**
+     * @brief Number of values of a row.
      */
-    Element(size_t nb_values) : BaseElement(nb_values, sizeof(T)) {}
+    size_t nb_cols_;
   };
 }
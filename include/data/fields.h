@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @file fields.h
+ * @brief Describes the fields of user records. Records of a registered type
+ * are stored on the slaves as one column per field, so that a single field
+ * can be read, mapped or reduced without touching the others.
+ * @author David Peicho, Sarasvati Moutoucomarapoulé
+ * @version 1.0
+ * @date 2017-12-21
+ */
+
+/**
+ * @brief Register the fields of a record type. It has to be used in the
+ * global namespace, and lists pointers to the members to store:
+ * `ALGOREP_FIELDS(Student, &Student::age, &Student::grade)`.
+ */
+#define ALGOREP_FIELDS(Type, ...)                                   \
+  namespace algorep                                                 \
+  {                                                                 \
+    namespace fields                                                \
+    {                                                               \
+      template <>                                                   \
+      struct Fields<Type>                                           \
+      {                                                             \
+        static const bool registered = true;                        \
+        static decltype(std::make_tuple(__VA_ARGS__)) members()     \
+        {                                                           \
+          return std::make_tuple(__VA_ARGS__);                      \
+        }                                                           \
+      };                                                            \
+    }                                                               \
+  }
+
+namespace algorep
+{
+  namespace fields
+  {
+    /**
+     * @brief Field of a record.
+     */
+    struct Field
+    {
+      /**
+       * @brief Position of the field in the record.
+       */
+      size_t offset;
+
+      /**
+       * @brief Size of the field.
+       */
+      size_t size;
+    };
+
+    /**
+     * @brief Fields of a record type, specialized by `ALGOREP_FIELDS`.
+     *
+     * @tparam T Type of record.
+     */
+    template <typename T>
+    struct Fields
+    {
+      static const bool registered = false;
+    };
+
+    namespace
+    {
+      template <typename T, typename M>
+      Field
+      makeField(M T::*member)
+      {
+        const T record{};
+        const auto* base = reinterpret_cast<const uint8_t*>(&record);
+        const auto* field = reinterpret_cast<const uint8_t*>(&(record.*member));
+        return Field{(size_t)(field - base), sizeof(M)};
+      }
+
+      template <typename T, typename Tuple, size_t... I>
+      std::vector<Field>
+      makeLayout(const Tuple& members, std::index_sequence<I...>)
+      {
+        return {makeField<T>(std::get<I>(members))...};
+      }
+
+      template <typename T>
+      std::vector<Field>
+      makeLayout(std::true_type)
+      {
+        const auto& members = Fields<T>::members();
+        using Members = typename std::decay<decltype(members)>::type;
+        return makeLayout<T>(
+            members,
+            std::make_index_sequence<std::tuple_size<Members>::value>());
+      }
+
+      template <typename T>
+      std::vector<Field>
+      makeLayout(std::false_type)
+      {
+        return {};
+      }
+    }
+
+    /**
+     * @brief Get the fields of a record type, in the order of their
+     * columns. Types which are not registered have no field.
+     *
+     * @tparam T Type of record.
+     *
+     * @return Fields of the record.
+     */
+    template <typename T>
+    std::vector<Field>
+    layout()
+    {
+      using Registered = std::integral_constant<bool, Fields<T>::registered>;
+      return makeLayout<T>(Registered());
+    }
+
+    /**
+     * @brief Get the number of bytes of a record once stored by columns,
+     * which does not include the padding of the record.
+     *
+     * @param fields Fields of the record.
+     *
+     * @return Size of a record in the chunks.
+     */
+    inline size_t
+    recordSize(const std::vector<Field>& fields)
+    {
+      size_t size = 0;
+      for (const auto& field : fields) size += field.size;
+      return size;
+    }
+
+    /**
+     * @brief Find the column of a member in a stored record.
+     *
+     * @tparam T Type of record.
+     * @tparam M Type of the member.
+     * @param member Member to find.
+     *
+     * @return Position of the member in a stored record, or the size of
+     * the stored record if the member is not registered.
+     */
+    template <typename T, typename M>
+    size_t
+    findColumn(M T::*member)
+    {
+      const auto& field = makeField(member);
+      size_t column = 0;
+      for (const auto& f : layout<T>())
+      {
+        if (f.offset == field.offset && f.size == field.size) return column;
+        column += f.size;
+      }
+      return column;
+    }
+
+    /**
+     * @brief Store records as one column per field. Each column holds the
+     * field of every record, one after the other.
+     *
+     * @tparam T Type of record.
+     * @param records Records to store.
+     * @param nb_records Number of records.
+     * @param out Filled with the columns, `nb_records * recordSize` bytes.
+     */
+    template <typename T>
+    void
+    toColumns(const T* records, size_t nb_records, uint8_t* out)
+    {
+      const auto* in = reinterpret_cast<const uint8_t*>(records);
+      for (const auto& field : layout<T>())
+      {
+        for (size_t i = 0; i < nb_records; ++i)
+          std::memcpy(out + i * field.size, in + i * sizeof(T) + field.offset,
+                      field.size);
+        out += nb_records * field.size;
+      }
+    }
+
+    /**
+     * @brief Rebuild records stored as one column per field.
+     *
+     * @tparam T Type of record.
+     * @param in Columns of the records.
+     * @param nb_records Number of records.
+     * @param records Filled with the records.
+     */
+    template <typename T>
+    void
+    fromColumns(const uint8_t* in, size_t nb_records, T* records)
+    {
+      auto* out = reinterpret_cast<uint8_t*>(records);
+      for (const auto& field : layout<T>())
+      {
+        for (size_t i = 0; i < nb_records; ++i)
+          std::memcpy(out + i * sizeof(T) + field.offset, in + i * field.size,
+                      field.size);
+        in += nb_records * field.size;
+      }
+    }
+  }  // namespace fields
+}  // namespace algorep
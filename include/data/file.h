@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <constant/callback.h>
+
+/**
+ * @file file.h
+ * @brief Describes the binary files read and written directly by the slaves.
+ * A file is a flat array of elements, optionally preceded by a header.
+ * @author David Peicho, Sarasvati Moutoucomarapoulé
+ * @version 1.0
+ * @date 2017-12-21
+ */
+
+namespace algorep
+{
+  /**
+   * @brief Optional header of a binary file, describing the elements
+   * following it. It is written as is in the file.
+   */
+  struct FileHeader
+  {
+    /**
+     * @brief Always `file::MAGIC`, used to detect the header.
+     */
+    char magic[8];
+
+    /**
+     * @brief Type of the elements (see `DataType`), `DataType::END` when
+     * it is not a handled type.
+     */
+    uint32_t data_type;
+
+    /**
+     * @brief Size of one element.
+     */
+    uint32_t atom_size;
+
+    /**
+     * @brief Number of elements following the header.
+     */
+    uint64_t nb_values;
+  };
+
+  namespace file
+  {
+    /**
+     * @brief First bytes of a file starting with a header.
+     */
+    constexpr static char MAGIC[8] = {'A', 'L', 'G', 'O', 'R', 'E', 'P', 1};
+
+    /**
+     * @brief Define the type written in the header of a file. Types
+     * without callbacks are written as `DataType::END`.
+     *
+     * @tparam T Type of element.
+     */
+    template <typename T, typename = void>
+    struct HeaderType
+    {
+      static const uint32_t value = DataType::END;
+    };
+
+    template <typename T>
+    struct HeaderType<T, decltype((void)callback::ElementType<T>::value)>
+    {
+      static const uint32_t value = callback::ElementType<T>::value;
+    };
+
+    /**
+     * @brief Read the header of a file.
+     *
+     * @param path File to read.
+     * @param header Filled with the header.
+     * @param size Filled with the size of the file.
+     *
+     * @return Whether the file starts with a header. False is also
+     * returned when the file can not be opened, `size` is 0 then.
+     */
+    bool
+    readHeader(const std::string& path, FileHeader& header, size_t& size);
+
+    /**
+     * @brief Read bytes of a file, using MPI-IO.
+     *
+     * @param path File to read.
+     * @param offset Position of the first byte to read.
+     * @param out Filled with the bytes.
+     * @param nb_bytes Number of bytes to read.
+     *
+     * @return Whether every byte has been read.
+     */
+    bool
+    read(const std::string& path, size_t offset, uint8_t* out,
+         size_t nb_bytes);
+
+    /**
+     * @brief Write bytes in an existing file, using MPI-IO.
+     *
+     * @param path File to write.
+     * @param offset Position of the first byte to write.
+     * @param data Bytes to write.
+     * @param nb_bytes Number of bytes to write.
+     *
+     * @return Whether every byte has been written.
+     */
+    bool
+    write(const std::string& path, size_t offset, const uint8_t* data,
+          size_t nb_bytes);
+  }  // namespace file
+}  // namespace algorep
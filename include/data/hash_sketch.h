@@ -0,0 +1,286 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file hash_sketch.h
+ * @brief Describes sketches built from the hashes of integer keys: a
+ * HyperLogLog counting distinct keys, and a Bloom filter testing whether
+ * a key belongs to a set. Both are merged across slaves.
+ * @author David Peicho, Sarasvati Moutoucomarapoulé
+ * @version 1.0
+ * @date 2017-12-21
+ */
+
+namespace algorep
+{
+  namespace hashing
+  {
+    /**
+     * @brief Number of keys hashed at once. Hashes of a block do not
+     * depend on each other, and are computed before updating the sketch.
+     */
+    constexpr size_t BLOCK = 256;
+
+    /**
+     * @brief Hash a key, using the finalizer of MurmurHash3.
+     *
+     * @param key Key to hash.
+     *
+     * @return Hash of the key.
+     */
+    inline uint64_t
+    hash(uint64_t key)
+    {
+      key ^= key >> 33;
+      key *= 0xff51afd7ed558ccdULL;
+      key ^= key >> 33;
+      key *= 0xc4ceb9fe1a85ec53ULL;
+      key ^= key >> 33;
+      return key;
+    }
+
+    /**
+     * @brief Hash a block of keys.
+     *
+     * @tparam T Integer type of the keys.
+     * @param keys Keys to hash.
+     * @param nb_keys Number of keys, at most `BLOCK`.
+     * @param out Filled with the hashes.
+     */
+    template <typename T>
+    inline void
+    hashBlock(const T* keys, size_t nb_keys, uint64_t* out)
+    {
+      for (size_t i = 0; i < nb_keys; ++i) out[i] = hash((uint64_t)keys[i]);
+    }
+  }  // namespace hashing
+
+  /**
+   * @brief HyperLogLog, estimating the number of distinct keys. The error
+   * is about 1.04 / sqrt(2^precision).
+   */
+  class HyperLogLog
+  {
+    public:
+    /**
+     * @brief Constructor.
+     *
+     * @param precision Number of bits indexing the registers, between 4
+     * and 16. The sketch uses 2^precision bytes.
+     */
+    explicit HyperLogLog(unsigned int precision = 12);
+
+    public:
+    /**
+     * @brief Add a hashed key.
+     *
+     * @param hash Hash of the key (see `hashing::hash`).
+     */
+    inline void
+    add(uint64_t hash)
+    {
+      const uint64_t index = hash >> (64 - this->precision_);
+      // A guard bit bounds the rank when the remaining bits are zeros.
+      const uint64_t rest = (hash << this->precision_) |
+                            (uint64_t(1) << (this->precision_ - 1));
+      const uint8_t rank = __builtin_clzll(rest) + 1;
+      if (rank > this->registers_[index]) this->registers_[index] = rank;
+    }
+
+    /**
+     * @brief Add the keys of another sketch, with the same precision.
+     *
+     * @param other Sketch to merge.
+     *
+     * @return Whether the sketches could be merged.
+     */
+    bool
+    merge(const HyperLogLog& other);
+
+    /**
+     * @brief Estimate the number of distinct keys.
+     *
+     * @return Estimated number of distinct keys.
+     */
+    double
+    estimate() const;
+
+    /**
+     * @brief Write the sketch, so that it can be sent.
+     *
+     * @param out Filled with the sketch.
+     */
+    void
+    serialize(std::vector<uint8_t>& out) const;
+
+    /**
+     * @brief Read a sketch written by `serialize`.
+     *
+     * @param data Written sketch.
+     * @param nb_bytes Size of data.
+     *
+     * @return Whether the sketch has been read.
+     */
+    bool
+    deserialize(const uint8_t* data, size_t nb_bytes);
+
+    private:
+    /**
+     * @brief Number of bits indexing the registers.
+     */
+    unsigned int precision_;
+
+    /**
+     * @brief Largest rank seen by each register.
+     */
+    std::vector<uint8_t> registers_;
+  };
+
+  /**
+   * @brief Bloom filter, testing whether a key belongs to a set. Keys
+   * added are always found, other keys are found with a small probability.
+   */
+  class BloomFilter
+  {
+    public:
+    /**
+     * @brief Constructor.
+     *
+     * @param nb_bits Number of bits of the filter, rounded to 64.
+     * @param nb_hashes Number of bits set per key.
+     */
+    BloomFilter(size_t nb_bits = 64, unsigned int nb_hashes = 1);
+
+    /**
+     * @brief Build a filter sized for a number of keys.
+     *
+     * @param nb_keys Number of keys expected.
+     * @param false_positive Probability to find a key which is not in
+     * the set.
+     *
+     * @return Empty filter.
+     */
+    static BloomFilter
+    create(size_t nb_keys, double false_positive);
+
+    public:
+    /**
+     * @brief Add a hashed key.
+     *
+     * @param hash Hash of the key (see `hashing::hash`).
+     */
+    inline void
+    add(uint64_t hash)
+    {
+      const size_t nb_bits = this->bits_.size() * 64;
+      uint64_t h = hash;
+      const uint64_t step = (hash >> 32 | hash << 32) | 1;
+      for (unsigned int i = 0; i < this->nb_hashes_; ++i, h += step)
+      {
+        const size_t bit = h % nb_bits;
+        this->bits_[bit / 64] |= uint64_t(1) << (bit % 64);
+      }
+    }
+
+    /**
+     * @brief Test whether a hashed key may belong to the set.
+     *
+     * @param hash Hash of the key (see `hashing::hash`).
+     *
+     * @return False if the key is not in the set.
+     */
+    inline bool
+    contains(uint64_t hash) const
+    {
+      const size_t nb_bits = this->bits_.size() * 64;
+      uint64_t h = hash;
+      const uint64_t step = (hash >> 32 | hash << 32) | 1;
+      for (unsigned int i = 0; i < this->nb_hashes_; ++i, h += step)
+      {
+        const size_t bit = h % nb_bits;
+        if (!(this->bits_[bit / 64] & (uint64_t(1) << (bit % 64))))
+          return false;
+      }
+      return true;
+    }
+
+    /**
+     * @brief Test whether a key may belong to the set.
+     *
+     * @param key Key to test.
+     *
+     * @return False if the key is not in the set.
+     */
+    inline bool
+    containsKey(uint64_t key) const
+    {
+      return this->contains(hashing::hash(key));
+    }
+
+    /**
+     * @brief Add the keys of another filter, with the same size.
+     *
+     * @param other Filter to merge.
+     *
+     * @return Whether the filters could be merged.
+     */
+    bool
+    merge(const BloomFilter& other);
+
+    /**
+     * @brief Write the filter, so that it can be sent.
+     *
+     * @param out Filled with the filter.
+     */
+    void
+    serialize(std::vector<uint8_t>& out) const;
+
+    /**
+     * @brief Read a filter written by `serialize`.
+     *
+     * @param data Written filter.
+     * @param nb_bytes Size of data.
+     *
+     * @return Whether the filter has been read.
+     */
+    bool
+    deserialize(const uint8_t* data, size_t nb_bytes);
+
+    public:
+    /**
+     * @brief Get the number of bits of the filter.
+     *
+     * @return Number of bits.
+     */
+    inline size_t
+    getNbBits() const
+    {
+      return this->bits_.size() * 64;
+    }
+
+    /**
+     * @brief Get the number of bits set per key.
+     *
+     * @return Number of hashes.
+     */
+    inline unsigned int
+    getNbHashes() const
+    {
+      return this->nb_hashes_;
+    }
+
+    private:
+    /**
+     * @brief Number of bits set per key.
+     */
+    unsigned int nb_hashes_;
+
+    /**
+     * @brief Bits of the filter.
+     */
+    std::vector<uint64_t> bits_;
+  };
+}  // namespace algorep
@@ -1,9 +1,16 @@
 #pragma once
 
+#include <list>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include <data/checkpoint.h>
+#include <data/chunk.h>
+#include <data/config.h>
+#include <data/status.h>
+#include <data/table.h>
+
 /**
  * @file memory.h
  * @brief Encapsluates data regarding variable stores on a single slave.
@@ -27,17 +34,114 @@ namespace algorep
    */
   class Memory
   {
+    public:
+    /**
+     * @brief Constructor.
+     *
+     * @param max_memory Maximum number of bytes of chunks kept in RAM,
+     * 0 for no limit.
+     */
+    Memory(size_t max_memory = 0)
+        : max_memory_{max_memory}, disk_budget_{0}, next_id_{0}
+    {
+    }
+
     public:
     /**
      * @brief Allocate space in memory for some data.
      *
      * @param node_rank Rank of the node where is allocated the data.
      * @param nb_bytes Number of bytes requested.
+     * @param zero Whether the bytes are set to zero. Otherwise, they are
+     * left uninitialized, for callers writing all of them.
      *
-     * @return Data identifier.
+     * @return Data identifier, empty if the memory could not be allocated.
      */
     std::string
-    reserve(int node_rank, int nb_bytes);
+    reserve(int node_rank, size_t nb_bytes, bool zero = true);
+
+    /**
+     * @brief Change the size and the capacity of a chunk.
+     *
+     * @param id Chunk to resize.
+     * @param nb_bytes New size of the chunk.
+     * @param capacity Number of bytes to reserve for the chunk.
+     *
+     * @return Whether the chunk could be resized.
+     */
+    bool
+    resize(const std::string& id, size_t nb_bytes, size_t capacity);
+
+    /**
+     * @brief Write every chunk and its write history in a file.
+     *
+     * @param path File to create.
+     *
+     * @return Whether the file has been written.
+     */
+    bool
+    checkpoint(const std::string& path) const;
+
+    /**
+     * @brief Read the chunks written by `checkpoint`. The file is mapped,
+     * and chunks are copied following the usual memory limits.
+     *
+     * @param path File to read.
+     *
+     * @return Whether every chunk has been restored. Nothing is restored
+     * if the memory is not empty.
+     */
+    bool
+    restore(const std::string& path);
+
+    /**
+     * @brief Apply the settings sent by the master.
+     *
+     * @param config Settings of the slave.
+     *
+     * @return False if the scratch directory can not be written.
+     */
+    bool
+    configure(const NodeConfig& config);
+
+    /**
+     * @brief Get a chunk about to be entirely accessed. A spilled chunk
+     * is moved back to RAM if colder chunks can be spilled in its place,
+     * otherwise it is accessed from its file.
+     *
+     * @param id Chunk to get.
+     * @param sequential Whether the chunk is read from start to end.
+     *
+     * @return Chunk queried.
+     */
+    Chunk&
+    fetch(const std::string& id, bool sequential = false);
+
+    /**
+     * @brief Measure the memory used by the slave.
+     *
+     * @param success Status reported with the measure.
+     *
+     * @return Current memory usage.
+     */
+    NodeStatus
+    getStatus(bool success = true) const;
+
+    /**
+     * @brief Get the number of bytes reserved for chunks.
+     *
+     * @return Number of bytes, spare capacity included.
+     */
+    size_t
+    getUsed() const;
+
+    /**
+     * @brief Get the number of bytes of chunks spilled to disk.
+     *
+     * @return Number of bytes, spare capacity included.
+     */
+    size_t
+    getSpilled() const;
 
     /**
      * @brief Release all data.
@@ -53,6 +157,59 @@ namespace algorep
     void
     release(const std::string& id);
 
+    /**
+     * @brief Mark a chunk as sparse. Its bytes are the positions of its
+     * non-zero values as `uint64_t`, followed by the values.
+     *
+     * @param id Chunk storing non-zero values only.
+     * @param nb_values Number of values of the chunk, zeros included.
+     */
+    inline void
+    setSparse(const std::string& id, size_t nb_values)
+    {
+      this->sparse_[id] = nb_values;
+    }
+
+    /**
+     * @brief Check whether a chunk only stores its non-zero values.
+     *
+     * @param id Chunk to check.
+     *
+     * @return True if the chunk is sparse.
+     */
+    inline bool
+    isSparse(const std::string& id) const
+    {
+      return this->sparse_.count(id) != 0;
+    }
+
+    /**
+     * @brief Get the number of values of a sparse chunk.
+     *
+     * @param id Sparse chunk.
+     *
+     * @return Number of values, zeros included.
+     */
+    inline size_t
+    getSparseSize(const std::string& id) const
+    {
+      return this->sparse_.at(id);
+    }
+
+    /**
+     * @brief Get the index of a partition of a table. It is empty until
+     * built from the column of keys, and dropped with the partition.
+     *
+     * @param id Partition of a table.
+     *
+     * @return Index of the partition.
+     */
+    inline TableIndex&
+    getTableIndex(const std::string& id)
+    {
+      return this->tables_[id];
+    }
+
     public:
     /**
      * @brief Get specific data.
@@ -61,9 +218,10 @@ namespace algorep
      *
      * @return Data queried.
      */
-    inline std::vector<uint8_t>&
+    inline Chunk&
     get(const std::string& id)
     {
+      this->touch(id);
       return this->data_[id];
     }
 
@@ -74,7 +232,7 @@ namespace algorep
      *
      * @return Data queried.
      */
-    inline const std::vector<uint8_t>&
+    inline const Chunk&
     getConst(const std::string& id) const
     {
       return this->data_.at(id);
@@ -92,15 +250,101 @@ namespace algorep
     }
 
     private:
+    /**
+     * @brief Allocate a chunk with a given identifier.
+     *
+     * @param id Identifier of the chunk.
+     * @param nb_bytes Size of the chunk.
+     * @param capacity Number of bytes to reserve for the chunk.
+     * @param zero Whether the bytes are set to zero.
+     *
+     * @return Whether the chunk has been allocated.
+     */
+    bool
+    place(const std::string& id, size_t nb_bytes, size_t capacity,
+          bool zero = true);
+
+    /**
+     * @brief Mark a chunk as the most recently used one.
+     *
+     * @param id Chunk used.
+     */
+    void
+    touch(const std::string& id);
+
+    /**
+     * @brief Spill the least recently used chunks, until some bytes
+     * can be added in RAM.
+     *
+     * @param nb_bytes Number of bytes to add in RAM.
+     * @param id Chunk which must not be spilled.
+     *
+     * @return Whether there is enough room in RAM.
+     */
+    bool
+    makeRoom(size_t nb_bytes, const std::string& id);
+
+    /**
+     * @brief Spill a chunk in the scratch directory.
+     *
+     * @param id Chunk to spill.
+     *
+     * @return Whether the chunk has been spilled.
+     */
+    bool
+    spill(const std::string& id);
+
+    private:
+    /**
+     * @brief Maximum number of bytes of chunks kept in RAM, 0 for no limit.
+     */
+    size_t max_memory_;
+
+    /**
+     * @brief Number of bytes of chunks stored on disk in addition to
+     * `max_memory_`.
+     */
+    size_t disk_budget_;
+
+    /**
+     * @brief Directory receiving the files of spilled chunks.
+     */
+    std::string scratch_dir_;
+
+    /**
+     * @brief Counter used to build the identifier of the next chunk.
+     */
+    unsigned long long next_id_;
+
     /**
      * @brief Store data associated with its identifier.
      */
-    std::unordered_map<std::string, std::vector<uint8_t>> data_;
+    std::unordered_map<std::string, Chunk> data_;
+
+    /**
+     * @brief Chunks from the most recently used to the least recently used.
+     */
+    std::list<std::string> lru_;
+
+    /**
+     * @brief Position of each chunk in `lru_`.
+     */
+    std::unordered_map<std::string, std::list<std::string>::iterator> lru_pos_;
 
     /**
      * @brief This history map is used when dealing with messages
      * that can be wrongly ordered, because of the asynchronous sending.
      */
     std::unordered_map<std::string, std::tuple<Pack, Pack>> history_;
+
+    /**
+     * @brief Number of values of each sparse chunk, zeros included.
+     */
+    std::unordered_map<std::string, size_t> sparse_;
+
+    /**
+     * @brief Index of each partition of a table held by the slave.
+     */
+    std::unordered_map<std::string, TableIndex> tables_;
   };
 }  // namespace algorep
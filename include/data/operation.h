@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <mpi/mpi.h>
+
+/**
+ * @file operation.h
+ * @brief Describes a prepared operation. A prepared operation is built once
+ * on an Element, and can then be started many times without rebuilding
+ * messages. It is backed by MPI persistent requests.
+ * @author David Peicho, Sarasvati Moutoucomarapoulé
+ * @version 1.0
+ * @date 2017-12-21
+ */
+
+namespace algorep
+{
+  /**
+   * @brief Set of persistent requests built by the Allocator.
+   * The instance is given to the user, who has to free it using `delete`
+   * once it is not used anymore, and before calling `algorep::finalize`.
+   */
+  class Operation
+  {
+    friend class Allocator;
+
+    public:
+    /**
+     * @brief Destructor. Frees the persistent requests.
+     */
+    ~Operation();
+
+    public:
+    /**
+     * @brief Start every request of the operation. The previous start
+     * has to be completed using `wait` before calling it again.
+     */
+    void
+    start();
+
+    /**
+     * @brief Wait until the operation is complete.
+     *
+     * @return Whether every slave acknowledged a success.
+     */
+    bool
+    wait();
+
+    public:
+    /**
+     * @brief Get the result of the last completed operation. This is only
+     * relevant for a reduce operation.
+     *
+     * @tparam T Type of element.
+     *
+     * @return Pointer on the result, owned by the operation.
+     */
+    template <typename T>
+    inline const T*
+    getResult() const
+    {
+      return (const T*)&this->result_[0];
+    }
+
+    private:
+    /**
+     * @brief Constructor. Only the Allocator can build an operation.
+     */
+    Operation() : clock_{nullptr} {}
+
+    private:
+    /**
+     * @brief Persistent requests sending the messages to the slaves.
+     */
+    std::vector<MPI_Request> sends_;
+
+    /**
+     * @brief Persistent requests receiving acknowledges or results.
+     */
+    std::vector<MPI_Request> recvs_;
+
+    /**
+     * @brief Messages built once, and sent at each start.
+     */
+    std::vector<std::vector<uint8_t>> headers_;
+
+    /**
+     * @brief Datatypes describing messages scattered in memory.
+     */
+    std::vector<MPI_Datatype> types_;
+
+    /**
+     * @brief Acknowledges received from slaves.
+     */
+    std::vector<uint8_t> acks_;
+
+    /**
+     * @brief Result of a reduce.
+     */
+    std::vector<uint8_t> result_;
+
+    /**
+     * @brief Clock shared with the Allocator, used by write operations.
+     * It is incremented at each start.
+     */
+    size_t* clock_;
+  };
+}  // namespace algorep
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file sketch.h
+ * @brief Describes a mergeable summary of the distribution of values, used
+ * to estimate quantiles without sending every value to the master.
+ * @author David Peicho, Sarasvati Moutoucomarapoulé
+ * @version 1.0
+ * @date 2017-12-21
+ */
+
+namespace algorep
+{
+  /**
+   * @brief Quantile sketch, in the style of KLL. Values are kept in levels,
+   * a value of level h standing for 2^h values. When a level is full, it is
+   * sorted and one value out of two goes to the next level. The rank error
+   * is about the number of values divided by `accuracy`.
+   */
+  class QuantileSketch
+  {
+    public:
+    /**
+     * @brief Constructor.
+     *
+     * @param accuracy Number of values kept by the top level, the sketch
+     * keeps about three times this number.
+     */
+    explicit QuantileSketch(size_t accuracy = 200);
+
+    public:
+    /**
+     * @brief Add copies of a value.
+     *
+     * @param value Value to add.
+     * @param count Number of copies.
+     */
+    void
+    add(double value, uint64_t count = 1);
+
+    /**
+     * @brief Add the values summarized by another sketch.
+     *
+     * @param other Sketch to merge.
+     */
+    void
+    merge(const QuantileSketch& other);
+
+    /**
+     * @brief Estimate a quantile.
+     *
+     * @param q Rank of the quantile, between 0 and 1 (0.5 for the median).
+     *
+     * @return Estimated value, 0 if the sketch is empty.
+     */
+    double
+    quantile(double q) const;
+
+    /**
+     * @brief Write the sketch, so that it can be sent.
+     *
+     * @param out Filled with the sketch.
+     */
+    void
+    serialize(std::vector<uint8_t>& out) const;
+
+    /**
+     * @brief Read a sketch written by `serialize`.
+     *
+     * @param data Written sketch.
+     * @param nb_bytes Size of data.
+     *
+     * @return Whether the sketch has been read.
+     */
+    bool
+    deserialize(const uint8_t* data, size_t nb_bytes);
+
+    public:
+    /**
+     * @brief Get the number of values added to the sketch.
+     *
+     * @return Number of values.
+     */
+    inline uint64_t
+    getCount() const
+    {
+      return this->count_;
+    }
+
+    /**
+     * @brief Get the number of values kept by the sketch.
+     *
+     * @return Number of kept values.
+     */
+    size_t
+    getSize() const;
+
+    private:
+    /**
+     * @brief Get the number of values a level can hold before being
+     * compacted. Lower levels hold fewer values.
+     *
+     * @param level Level of the sketch.
+     *
+     * @return Capacity of the level.
+     */
+    size_t
+    capacity(size_t level) const;
+
+    /**
+     * @brief Compact every full level into the next one.
+     */
+    void
+    compress();
+
+    private:
+    /**
+     * @brief Number of values kept by the top level.
+     */
+    size_t accuracy_;
+
+    /**
+     * @brief Number of values added to the sketch.
+     */
+    uint64_t count_;
+
+    /**
+     * @brief Values of each level.
+     */
+    std::vector<std::vector<double>> levels_;
+
+    /**
+     * @brief Whether compactions keep odd positions. It alternates, so
+     * that compactions do not always favor the same values.
+     */
+    bool odd_;
+  };
+}  // namespace algorep
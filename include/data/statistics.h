@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file statistics.h
+ * @brief Describes the statistics of an element, computed by the slaves on
+ * their chunks and merged by the master.
+ * @author David Peicho, Sarasvati Moutoucomarapoulé
+ * @version 1.0
+ * @date 2017-12-21
+ */
+
+namespace algorep
+{
+  /**
+   * @brief Statistics of a set of values. It is sent as is in the replies
+   * to DESCRIBE messages.
+   */
+  struct Statistics
+  {
+    /**
+     * @brief Number of values.
+     */
+    uint64_t count;
+
+    /**
+     * @brief Smallest value, 0 if there is no value.
+     */
+    double min;
+
+    /**
+     * @brief Largest value, 0 if there is no value.
+     */
+    double max;
+
+    /**
+     * @brief Sum of the values.
+     */
+    double sum;
+
+    /**
+     * @brief Mean of the values.
+     */
+    double mean;
+
+    /**
+     * @brief Sum of the squared differences to the mean.
+     */
+    double m2;
+
+    /**
+     * @brief Get the variance of the values.
+     *
+     * @param sample Whether the values are a sample of a population,
+     * the sum is then divided by `count - 1`.
+     *
+     * @return Variance of the values, 0 if there are not enough values.
+     */
+    inline double
+    variance(bool sample = false) const
+    {
+      const uint64_t div = (sample) ? this->count - 1 : this->count;
+      return (this->count > (sample ? 1u : 0u)) ? this->m2 / div : 0;
+    }
+  };
+
+  namespace statistics
+  {
+    /**
+     * @brief Merge the statistics of two sets of values, using the
+     * parallel formula of Chan et al., which stays accurate when the
+     * sets have very different sizes or means.
+     *
+     * @param a Statistics receiving the merge.
+     * @param b Statistics to merge.
+     */
+    inline void
+    merge(Statistics& a, const Statistics& b)
+    {
+      if (b.count == 0) return;
+      if (a.count == 0)
+      {
+        a = b;
+        return;
+      }
+
+      const double count = a.count + b.count;
+      const double delta = b.mean - a.mean;
+      a.m2 += b.m2 + delta * delta * a.count * b.count / count;
+      a.mean += delta * b.count / count;
+      a.count += b.count;
+      a.sum += b.sum;
+      a.min = std::min(a.min, b.min);
+      a.max = std::max(a.max, b.max);
+    }
+  }  // namespace statistics
+}  // namespace algorep
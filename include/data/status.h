@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file status.h
+ * @brief Describes the memory of a slave, as reported by the slave itself.
+ * @author David Peicho, Sarasvati Moutoucomarapoulé
+ * @version 1.0
+ * @date 2017-12-21
+ */
+
+namespace algorep
+{
+  /**
+   * @brief Memory usage of a slave. It is sent as is in the replies to
+   * ALLOCATION, FREE, GROW, STATUS, CONFIG and table messages.
+   */
+  struct NodeStatus
+  {
+    /**
+     * @brief Whether the operation succeeded (see `constant::SUCCESS`).
+     */
+    uint8_t status;
+
+    /**
+     * @brief Number of chunks stored on the slave.
+     */
+    size_t nb_chunks;
+
+    /**
+     * @brief Number of bytes reserved for chunks, spare capacity included.
+     * This is the value compared to the maximum memory of the slave.
+     */
+    size_t used;
+
+    /**
+     * @brief Number of bytes of chunks spilled to disk, included in `used`.
+     */
+    size_t spilled;
+
+    /**
+     * @brief Number of bytes reserved but not used by chunks.
+     */
+    size_t slack;
+
+    /**
+     * @brief Resident memory of the slave process, in bytes.
+     */
+    size_t resident;
+
+    /**
+     * @brief Free bytes kept by the allocator of the slave process, which
+     * gives an idea of the fragmentation of its heap.
+     */
+    size_t arena_free;
+  };
+}  // namespace algorep
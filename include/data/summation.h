@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file summation.h
+ * @brief Describes the reproducible summation of floating values. Values are
+ * summed by blocks aligned on their global positions, so that the result
+ * does not depend on how the element is split between slaves.
+ * @author David Peicho, Sarasvati Moutoucomarapoulé
+ * @version 1.0
+ * @date 2017-12-21
+ */
+
+namespace algorep
+{
+  namespace summation
+  {
+    /**
+     * @brief Number of values of a block. Block b holds the values at
+     * positions [b * BLOCK, (b + 1) * BLOCK).
+     */
+    constexpr size_t BLOCK = 1024;
+
+    /**
+     * @brief Number of independent sums inside a block. Value i of a block
+     * goes to lane i % LANES.
+     */
+    constexpr size_t LANES = 8;
+
+    /**
+     * @brief Add a value to a compensated sum (Neumaier).
+     *
+     * @param sum Running sum.
+     * @param comp Running compensation, the rounding errors of `sum`.
+     * @param value Value to add.
+     */
+    inline void
+    add(double& sum, double& comp, double value)
+    {
+      const double t = sum + value;
+      comp += (std::abs(sum) >= std::abs(value)) ? (sum - t) + value
+                                                 : (value - t) + sum;
+      sum = t;
+    }
+
+    /**
+     * @brief Sum a block of values. Lanes are independent, which shortens
+     * the chain of dependent additions, and are combined in a fixed order.
+     *
+     * @param values Values of the block.
+     * @param nb_values Number of values, at most `BLOCK`.
+     * @param out Filled with the sum of the block and its compensation,
+     * kept apart so that large values cancelling each other do not round
+     * the small ones.
+     */
+    inline void
+    block(const double* values, size_t nb_values, double* out)
+    {
+      double sums[LANES] = {0};
+      double comps[LANES] = {0};
+
+      size_t i = 0;
+      for (; i + LANES <= nb_values; i += LANES)
+      {
+        for (size_t j = 0; j < LANES; ++j)
+          add(sums[j], comps[j], values[i + j]);
+      }
+      for (size_t j = 0; i + j < nb_values; ++j)
+        add(sums[j], comps[j], values[i + j]);
+
+      out[0] = 0;
+      out[1] = 0;
+      for (size_t j = 0; j < LANES; ++j) add(out[0], out[1], sums[j]);
+      for (size_t j = 0; j < LANES; ++j) out[1] += comps[j];
+    }
+
+    /**
+     * @brief Sum the blocks, in the order of the blocks.
+     *
+     * @param blocks Sum and compensation of every block of an element.
+     *
+     * @return Sum of the element.
+     */
+    inline double
+    combine(const std::vector<double>& blocks)
+    {
+      double sum = 0;
+      double comp = 0;
+      for (size_t i = 0; i + 1 < blocks.size(); i += 2)
+      {
+        add(sum, comp, blocks[i]);
+        comp += blocks[i + 1];
+      }
+      return sum + comp;
+    }
+  }  // namespace summation
+}  // namespace algorep
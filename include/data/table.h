@@ -0,0 +1,224 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+#include <data/element.h>
+#include <data/fields.h>
+#include <data/hash_sketch.h>
+#include <data/status.h>
+
+/**
+ * @file table.h
+ * @brief Describes distributed hash tables. Keys are hash-partitioned to
+ * the slaves, each one storing its entries as one column of keys and one
+ * column of values, indexed by an open-addressing table.
+ * @author David Peicho, Sarasvati Moutoucomarapoulé
+ * @version 1.0
+ * @date 2017-12-21
+ */
+
+namespace algorep
+{
+  /**
+   * @brief Entry of a table.
+   *
+   * @tparam K Integer type of the keys.
+   * @tparam V Type of the values.
+   */
+  template <typename K, typename V>
+  struct Entry
+  {
+    K key;
+    V value;
+  };
+
+  namespace fields
+  {
+    /**
+     * @brief Entries are stored as a column of keys and a column of
+     * values, so that values are mapped and reduced as a field.
+     */
+    template <typename K, typename V>
+    struct Fields<Entry<K, V>>
+    {
+      static const bool registered = true;
+      static std::tuple<K Entry<K, V>::*, V Entry<K, V>::*>
+      members()
+      {
+        return std::make_tuple(&Entry<K, V>::key, &Entry<K, V>::value);
+      }
+    };
+  }  // namespace fields
+
+  namespace table
+  {
+    /**
+     * @brief Size of the header of the replies of the slaves: the status,
+     * the number of entries of the partition, and the number of keys
+     * matched, as `uint64_t`, followed by the memory status of the slave.
+     */
+    constexpr size_t REPLY_HEADER = 3 * sizeof(uint64_t) + sizeof(NodeStatus);
+
+    /**
+     * @brief Get the bits of a key, on the master as on the slaves, which
+     * only know the size of the keys.
+     *
+     * @param key Key to read.
+     * @param key_size Size of the key, at most 8 bytes.
+     *
+     * @return Key, zero-extended.
+     */
+    inline uint64_t
+    keyBits(const void* key, size_t key_size)
+    {
+      uint64_t bits = 0;
+      std::memcpy(&bits, key, key_size);
+      return bits;
+    }
+
+    /**
+     * @brief Get the partition of a key. The high bits of the hash are
+     * used, the low ones indexing the table of the partition.
+     *
+     * @param bits Key, see `keyBits`.
+     * @param nb_partitions Number of partitions.
+     *
+     * @return Position of the partition.
+     */
+    inline size_t
+    partition(uint64_t bits, size_t nb_partitions)
+    {
+      return (hashing::hash(bits) >> 32) % nb_partitions;
+    }
+  }  // namespace table
+
+  /**
+   * @brief Element holding a hash table, one partition per slave. Entries
+   * are not ordered, and their positions change with every `put` and
+   * `erase`.
+   *
+   * @tparam K Integer type of the keys.
+   * @tparam V Type of the values.
+   */
+  template <typename K, typename V>
+  class Table : public Element<Entry<K, V>>
+  {
+    public:
+    /**
+     * @brief Constructor, for an empty table.
+     */
+    Table()
+        : Element<Entry<K, V>>(0, false, Storage::COLUMNS,
+                               sizeof(K) + sizeof(V))
+    {
+    }
+  };
+
+  /**
+   * @brief Open-addressing index of the entries of a partition, mapping a
+   * key to the position of its entry in the columns. Slots are probed
+   * linearly, and keep the key so that probing never reads the columns.
+   */
+  class TableIndex
+  {
+    public:
+    /**
+     * @brief Position of a missing key.
+     */
+    static constexpr uint64_t NONE = UINT64_MAX;
+
+    public:
+    /**
+     * @brief Index the keys of a partition.
+     *
+     * @param keys Column of keys.
+     * @param key_size Size of a key.
+     * @param nb_keys Number of keys.
+     */
+    void
+    build(const uint8_t* keys, size_t key_size, size_t nb_keys);
+
+    /**
+     * @brief Find the entry of a key.
+     *
+     * @param key Key to find, see `table::keyBits`.
+     *
+     * @return Position of the entry, `NONE` if the key is missing.
+     */
+    uint64_t
+    find(uint64_t key) const;
+
+    /**
+     * @brief Set the position of the entry of a key, adding the key if it
+     * is missing.
+     *
+     * @param key Key to set.
+     * @param position Position of its entry.
+     */
+    void
+    set(uint64_t key, uint64_t position);
+
+    /**
+     * @brief Remove a key. Following slots are shifted back, so that no
+     * tombstone slows down later probes.
+     *
+     * @param key Key to remove.
+     */
+    void
+    erase(uint64_t key);
+
+    /**
+     * @brief Get the number of keys.
+     *
+     * @return Number of keys.
+     */
+    inline size_t
+    size() const
+    {
+      return this->nb_keys_;
+    }
+
+    private:
+    /**
+     * @brief Key and position of its entry.
+     */
+    struct Slot
+    {
+      uint64_t key;
+      uint64_t position;
+    };
+
+    /**
+     * @brief Find the slot of a key, or the empty slot ending its probe.
+     *
+     * @param key Key to find.
+     *
+     * @return Position of the slot.
+     */
+    size_t
+    probe(uint64_t key) const;
+
+    /**
+     * @brief Reallocate the slots, keeping the load under one half.
+     *
+     * @param nb_slots Number of slots, a power of 2.
+     */
+    void
+    rehash(size_t nb_slots);
+
+    private:
+    /**
+     * @brief Slots, an empty one having the position `NONE`.
+     */
+    std::vector<Slot> slots_;
+
+    /**
+     * @brief Number of keys.
+     */
+    size_t nb_keys_ = 0;
+  };
+}  // namespace algorep
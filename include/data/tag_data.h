@@ -21,6 +21,40 @@ namespace algorep
     FREE,
     MAP,
     REDUCE,
+    ALLOCATION_FILL,
+    GROW,
+    GATHER,
+    SCATTER,
+    COPY,
+    STATUS,
+    CONFIG,
+    ALLOCATION_FILE,
+    FILE_WRITE,
+    CHECKPOINT,
+    RESTORE,
+    ALLOCATION_PACKED,
+    READ_PACKED,
+    WRITE_PACKED,
+    ALLOCATION_SPARSE,
+    READ_COLUMN,
+    DESCRIBE,
+    TOP_K,
+    SKETCH,
+    DISTINCT,
+    BLOOM,
+    FILTER,
+    SUM,
+    MAP_PARAM,
+    STENCIL,
+    MATVEC,
+    MATVEC_TRANSPOSED,
+    REDUCE_ROWS,
+    ROLLING,
+    TABLE_PUT,
+    TABLE_GET,
+    TABLE_ERASE,
+    ZONE_MAP,
+    RANGE,
     QUIT
   };
 }  // namespace algorep
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <constant/constants.h>
+
+/**
+ * @file transfer.h
+ * @brief Describes data moved directly from a slave to another one. The
+ * master only computes the transfers, and sends them to the slaves.
+ * @author David Peicho, Sarasvati Moutoucomarapoulé
+ * @version 1.0
+ * @date 2017-12-21
+ */
+
+namespace algorep
+{
+  /**
+   * @brief Policy used to place the chunks of an element on the slaves.
+   */
+  enum Layout
+  {
+    // Fills the slaves one after another, as `reserve` does.
+    PACKED = 0,
+    // Splits the element evenly between the slaves.
+    BALANCED,
+    // Fills the slaves having the most free memory first, giving the
+    // fewest number of chunks.
+    FEWEST
+  };
+
+  /**
+   * @brief Fragment of a chunk to copy into another chunk. This is sent
+   * as is in messages.
+   */
+  struct Transfer
+  {
+    /**
+     * @brief Rank of the node sending the fragment.
+     */
+    int src;
+
+    /**
+     * @brief Rank of the node receiving the fragment.
+     */
+    int dst;
+
+    /**
+     * @brief Tag of the message, unique in a set of transfers.
+     */
+    int tag;
+
+    /**
+     * @brief Identifier of the source chunk.
+     */
+    char src_id[constant::ID_LEN];
+
+    /**
+     * @brief Offset in bytes of the fragment in the source chunk.
+     */
+    size_t src_offset;
+
+    /**
+     * @brief Identifier of the destination chunk.
+     */
+    char dst_id[constant::ID_LEN];
+
+    /**
+     * @brief Offset in bytes of the fragment in the destination chunk.
+     */
+    size_t dst_offset;
+
+    /**
+     * @brief Size of the fragment.
+     */
+    size_t nb_bytes;
+  };
+
+  /**
+   * @brief Chunk exchanging its boundary values (halos) with the chunks
+   * holding the neighbouring ranges of an element. This is sent as is in
+   * messages.
+   */
+  struct Halo
+  {
+    /**
+     * @brief Rank of the node holding the previous chunk, 0 if none.
+     */
+    int left;
+
+    /**
+     * @brief Rank of the node holding the next chunk, 0 if none.
+     */
+    int right;
+
+    /**
+     * @brief Position of the chunk in the element.
+     */
+    int index;
+
+    /**
+     * @brief Identifier of the chunk read.
+     */
+    char src_id[constant::ID_LEN];
+
+    /**
+     * @brief Identifier of the chunk receiving the result, which may be
+     * the chunk read.
+     */
+    char dst_id[constant::ID_LEN];
+  };
+
+  /**
+   * @brief Chunk of a matrix, holding whole rows, on which a slave
+   * computes. This is sent as is in messages.
+   */
+  struct MatrixBlock
+  {
+    /**
+     * @brief Identifier of the chunk of the matrix.
+     */
+    char src_id[constant::ID_LEN];
+
+    /**
+     * @brief Identifier of the chunk receiving one value per row, empty
+     * if the result is sent back to the master.
+     */
+    char dst_id[constant::ID_LEN];
+
+    /**
+     * @brief Number of rows of the chunk.
+     */
+    uint64_t nb_rows;
+  };
+
+  /**
+   * @brief Get the tag of a halo received by a chunk.
+   *
+   * @param index Position of the receiving chunk in the element.
+   * @param from_right Whether the halo comes from the next chunk.
+   *
+   * @return Tag of the message, MPI only guarantees tags up to 32767.
+   */
+  inline int
+  haloTag(int index, bool from_right)
+  {
+    return (2 * index + from_right) % 32767;
+  }
+}  // namespace algorep
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <data/element.h>
+
+/**
+ * @file zone_map.h
+ * @brief Describes zone maps: the minimum, the maximum and the order of
+ * every chunk of an element, used by range queries to skip the chunks
+ * outside of a range, and to binary search the sorted ones.
+ * @author David Peicho, Sarasvati Moutoucomarapoulé
+ * @version 1.0
+ * @date 2017-12-21
+ */
+
+namespace algorep
+{
+  namespace range
+  {
+    /**
+     * @brief Options of a range query sent to a slave.
+     */
+    enum Flags
+    {
+      // The chunk is sorted, and is binary searched.
+      SORTED = 1,
+      // Values in the range are sent back, not only counted.
+      READ = 2,
+    };
+
+    /**
+     * @brief Size of the header of the replies of the slaves: the number
+     * of values, and the position of the first one in a sorted chunk, as
+     * `uint64_t`.
+     */
+    constexpr size_t REPLY_HEADER = 2 * sizeof(uint64_t);
+  }  // namespace range
+
+  /**
+   * @brief Zone map of an element. It describes the values when it was
+   * built, and is built again after they change. Chunks added, removed or
+   * moved are detected, and the map is then ignored.
+   *
+   * @tparam T Type of element.
+   */
+  template <typename T>
+  class ZoneMap
+  {
+    public:
+    /**
+     * @brief Values of a chunk.
+     */
+    struct Zone
+    {
+      T min;
+      T max;
+      size_t nb_values;
+      bool sorted;
+    };
+
+    public:
+    /**
+     * @brief Constructor, for an element having no zone yet.
+     *
+     * @param elt Element described.
+     */
+    ZoneMap(const BaseElement* elt = nullptr)
+    {
+      if (elt == nullptr) return;
+
+      this->ids_ = elt->getIds();
+      this->bounds_ = elt->getBounds();
+    }
+
+    public:
+    /**
+     * @brief Add the zone of the next chunk.
+     *
+     * @param zone Values of the chunk.
+     */
+    inline void
+    add(const Zone& zone)
+    {
+      this->zones_.push_back(zone);
+    }
+
+    /**
+     * @brief Check whether the map describes the chunks of an element.
+     *
+     * @param elt Element to check.
+     *
+     * @return False if the map was built for other chunks.
+     */
+    inline bool
+    describes(const BaseElement* elt) const
+    {
+      return this->zones_.size() == this->bounds_.size() &&
+             this->ids_ == elt->getIds() && this->bounds_ == elt->getBounds();
+    }
+
+    /**
+     * @brief Check whether the whole element is sorted: every chunk is
+     * sorted, and starts after the end of the previous ones.
+     *
+     * @return Whether the element is sorted.
+     */
+    bool
+    isSorted() const
+    {
+      const Zone* previous = nullptr;
+      for (const auto& zone : this->zones_)
+      {
+        if (zone.nb_values == 0) continue;
+        if (!zone.sorted) return false;
+        if (previous && zone.min < previous->max) return false;
+        previous = &zone;
+      }
+      return true;
+    }
+
+    /**
+     * @brief Get the zone of every chunk.
+     *
+     * @return Zones, in the order of the chunks.
+     */
+    inline const std::vector<Zone>&
+    getZones() const
+    {
+      return this->zones_;
+    }
+
+    private:
+    /**
+     * @brief Identifiers of the chunks described.
+     */
+    std::vector<std::string> ids_;
+
+    /**
+     * @brief Bounds of the chunks described.
+     */
+    std::vector<std::tuple<size_t, size_t>> bounds_;
+
+    /**
+     * @brief Zone of every chunk.
+     */
+    std::vector<Zone> zones_;
+  };
+}  // namespace algorep
@@ -5,134 +5,2598 @@ namespace algorep
 {
   namespace
   {
+    /**
+     * @brief Communicator used by slaves to send data to each other.
+     * It is separated from the default one, so that slaves never
+     * receive these messages while waiting for a new operation.
+     */
+    MPI_Comm peer_comm = MPI_COMM_NULL;
+
+    void
+    setPack(size_t clock, int size, std::tuple<size_t, int>& out)
+    {
+      std::get<0>(out) = clock;
+      std::get<1>(out) = size;
+    }
+
+    /**
+     * @brief Send the memory status of the slave to the master, followed
+     * by an identifier.
+     *
+     * @param memory Memory of the slave.
+     * @param tag Operation identifier.
+     * @param success Whether the operation succeeded.
+     * @param id Identifier sent after the status, can be empty.
+     */
+    void
+    sendStatus(const Memory& memory, int tag, bool success,
+               const std::string& id = std::string())
+    {
+      // Sends the data with this layout:
+      //  sizeof (NodeStatus)    N
+      // [.....STATUS.....]   [.ID.]
+      std::vector<uint8_t> reply(sizeof(NodeStatus) + id.length() + 1, 0);
+      NodeStatus status = memory.getStatus(success);
+      std::memcpy(&reply[0], &status, sizeof(NodeStatus));
+      std::memcpy(&reply[0] + sizeof(NodeStatus), id.c_str(), id.length());
+
+      message::send_sync<uint8_t>(&reply[0], reply.size(), 0, tag);
+    }
+
+    /**
+     * @brief Insert or replace entries of a partition. New keys are added
+     * at the end of the columns, which are resized once.
+     *
+     * @param memory Memory of the slave.
+     * @param id Partition to update.
+     * @param index Index of the partition.
+     * @param sizes Size of a key and of a value.
+     * @param keys Keys to set.
+     * @param values Value of every key.
+     * @param nb_keys Number of keys.
+     * @param header Filled with the status, the number of entries and the
+     * number of entries added.
+     */
+    void
+    putEntries(Memory& memory, const std::string& id, TableIndex& index,
+               const uint32_t* sizes, const uint8_t* keys,
+               const uint8_t* values, size_t nb_keys, uint64_t* header)
+    {
+      const size_t key_size = sizes[0];
+      const size_t value_size = sizes[1];
+      const size_t record_size = key_size + value_size;
+      auto* chunk = &memory.fetch(id, true);
+      const size_t nb_records = chunk->size() / record_size;
+
+      // New keys are given the positions following the entries.
+      std::vector<uint64_t> positions(nb_keys);
+      std::vector<uint64_t> added;
+      for (size_t i = 0; i < nb_keys; ++i)
+      {
+        const uint64_t bits = table::keyBits(keys + i * key_size, key_size);
+        positions[i] = index.find(bits);
+        if (positions[i] != TableIndex::NONE) continue;
+
+        positions[i] = nb_records + added.size();
+        index.set(bits, positions[i]);
+        added.push_back(bits);
+      }
+
+      const size_t total = nb_records + added.size();
+      header[1] = nb_records;
+      if (added.size())
+      {
+        // The capacity grows geometrically when the slave has room.
+        const size_t bytes = total * record_size;
+        if (!memory.resize(id, bytes, std::max(bytes, 2 * chunk->capacity())) &&
+            !memory.resize(id, bytes, bytes))
+        {
+          for (const auto& bits : added) index.erase(bits);
+          header[0] = constant::FAIL;
+          return;
+        }
+
+        // Values move after the longer column of keys.
+        chunk = &memory.fetch(id, true);
+        uint8_t* data = chunk->data();
+        std::memmove(data + total * key_size, data + nb_records * key_size,
+                     nb_records * value_size);
+      }
+
+      uint8_t* data = chunk->data();
+      for (size_t i = 0; i < nb_keys; ++i)
+      {
+        std::memcpy(data + positions[i] * key_size, keys + i * key_size,
+                    key_size);
+        std::memcpy(data + total * key_size + positions[i] * value_size,
+                    values + i * value_size, value_size);
+      }
+
+      header[0] = constant::SUCCESS;
+      header[1] = total;
+      header[2] = added.size();
+    }
+
+    /**
+     * @brief Remove entries of a partition. The last entry takes the place
+     * of a removed one, and the columns are shrunk once.
+     *
+     * @param memory Memory of the slave.
+     * @param id Partition to update.
+     * @param index Index of the partition.
+     * @param sizes Size of a key and of a value.
+     * @param keys Keys to remove.
+     * @param nb_keys Number of keys.
+     * @param header Filled with the status, the number of entries and the
+     * number of entries removed.
+     */
+    void
+    eraseEntries(Memory& memory, const std::string& id, TableIndex& index,
+                 const uint32_t* sizes, const uint8_t* keys, size_t nb_keys,
+                 uint64_t* header)
+    {
+      const size_t key_size = sizes[0];
+      const size_t value_size = sizes[1];
+      auto& chunk = memory.fetch(id, true);
+      const size_t nb_records = chunk.size() / (key_size + value_size);
+      uint8_t* data = chunk.data();
+      uint8_t* values = data + nb_records * key_size;
+
+      size_t count = nb_records;
+      for (size_t i = 0; i < nb_keys; ++i)
+      {
+        const uint64_t bits = table::keyBits(keys + i * key_size, key_size);
+        const uint64_t position = index.find(bits);
+        if (position == TableIndex::NONE) continue;
+
+        index.erase(bits);
+        if (position != --count)
+        {
+          std::memcpy(data + position * key_size, data + count * key_size,
+                      key_size);
+          std::memcpy(values + position * value_size,
+                      values + count * value_size, value_size);
+          index.set(table::keyBits(data + position * key_size, key_size),
+                    position);
+        }
+      }
+
+      // Values move after the shorter column of keys.
+      if (count != nb_records)
+      {
+        std::memmove(data + count * key_size, values, count * value_size);
+        memory.resize(id, count * (key_size + value_size), 0);
+      }
+
+      header[0] = constant::SUCCESS;
+      header[1] = count;
+      header[2] = nb_records - count;
+    }
+
+    void
+    onTable(MPI_Status& status, Memory& memory)
+    {
+      // Retrieves the request from the master.
+      // The request lays out like this:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t)
+      // [...ID...]  [...KeySize...]    [..ValueSize..]    [.......N.......]
+      //  N * K     N * V
+      // [Keys]   [Values]
+      const int tag = status.MPI_TAG;
+      uint8_t* request = nullptr;
+      int bytes = 0;
+      message::rec_sync<uint8_t>(0, tag, status, &bytes, &request);
+
+      const std::string id((const char*)request);
+      uint32_t sizes[2];
+      uint64_t nb_keys = 0;
+      std::memcpy(sizes, request + constant::ID_LEN, sizeof(sizes));
+      std::memcpy(&nb_keys, request + constant::ID_LEN + sizeof(sizes),
+                  sizeof(uint64_t));
+      const uint8_t* keys =
+          request + constant::ID_LEN + sizeof(sizes) + sizeof(uint64_t);
+      const size_t record_size = sizes[0] + sizes[1];
+
+      auto& index = memory.getTableIndex(id);
+      auto& chunk = memory.fetch(id, true);
+      const size_t nb_records = chunk.size() / record_size;
+      if (index.size() != nb_records)
+        index.build(chunk.data(), sizes[0], nb_records);
+
+      // Replies lay out like this, found keys and values only following
+      // the header of a `get`:
+      //  3 * sizeof (uint64_t)   sizeof (NodeStatus)
+      // [.......Header.......]   [.....STATUS.....]
+      //  N * sizeof (uint8_t)   N * V
+      // [.......Found......]   [Values]
+      uint64_t header[3] = {constant::SUCCESS, nb_records, 0};
+      std::vector<uint8_t> reply(table::REPLY_HEADER);
+      if (tag == TAGS::TABLE_PUT)
+        putEntries(memory, id, index, sizes, keys,
+                   keys + nb_keys * sizes[0], nb_keys, header);
+      else if (tag == TAGS::TABLE_ERASE)
+        eraseEntries(memory, id, index, sizes, keys, nb_keys, header);
+      else
+      {
+        reply.resize(table::REPLY_HEADER + nb_keys * (1 + sizes[1]), 0);
+        uint8_t* found = &reply[table::REPLY_HEADER];
+        uint8_t* out = found + nb_keys;
+        const uint8_t* values = chunk.data() + nb_records * sizes[0];
+        for (size_t i = 0; i < nb_keys; ++i)
+        {
+          const uint64_t position =
+              index.find(table::keyBits(keys + i * sizes[0], sizes[0]));
+          if (position == TableIndex::NONE) continue;
+
+          found[i] = 1;
+          std::memcpy(out + i * sizes[1], values + position * sizes[1],
+                      sizes[1]);
+          ++header[2];
+        }
+      }
+      delete[] request;
+
+      // The capacity of the partition may have changed.
+      const NodeStatus node_status =
+          memory.getStatus(header[0] == constant::SUCCESS);
+      std::memcpy(&reply[0], header, sizeof(header));
+      std::memcpy(&reply[sizeof(header)], &node_status, sizeof(NodeStatus));
+      message::send_sync<uint8_t>(&reply[0], reply.size(), 0, tag);
+    }
+
+    /**
+     * @brief Describe a chunk for a zone map, or answer a range query on
+     * it.
+     *
+     * @tparam T Type of element.
+     * @param tag Either `ZONE_MAP` or `RANGE`.
+     * @param input Values used as const T*.
+     * @param nb_bytes Size of input.
+     * @param flags Options of a range query (see `range::Flags`).
+     * @param params Lowest and highest values of a range query.
+     * @param out Filled with the reply.
+     */
+    template <typename T>
+    void
+    rangeChunk(int tag, const uint8_t* input, size_t nb_bytes, uint32_t flags,
+               const uint8_t* params, std::vector<uint8_t>& out)
+    {
+      const T* data = (const T*)input;
+      const size_t nb_values = nb_bytes / sizeof(T);
+      uint64_t header[2] = {0, 0};
+      if (tag == TAGS::ZONE_MAP)
+      {
+        // Sorted chunks have their bounds at their ends.
+        T bounds[2] = {T(0), T(0)};
+        header[0] = nb_values;
+        header[1] = std::is_sorted(data, data + nb_values);
+        if (nb_values && header[1])
+        {
+          bounds[0] = data[0];
+          bounds[1] = data[nb_values - 1];
+        }
+        else if (nb_values)
+        {
+          const auto& minmax = std::minmax_element(data, data + nb_values);
+          bounds[0] = *minmax.first;
+          bounds[1] = *minmax.second;
+        }
+
+        out.resize(sizeof(header) + sizeof(bounds));
+        std::memcpy(&out[0], header, sizeof(header));
+        std::memcpy(&out[sizeof(header)], bounds, sizeof(bounds));
+        return;
+      }
+
+      T limits[2];
+      std::memcpy(limits, params, sizeof(limits));
+      const bool read = flags & range::READ;
+      if (flags & range::SORTED)
+      {
+        // Values in the range follow each other, only the first position
+        // is sent.
+        const T* first = std::lower_bound(data, data + nb_values, limits[0]);
+        const T* last = std::upper_bound(first, data + nb_values, limits[1]);
+        header[0] = last - first;
+        header[1] = first - data;
+        out.resize(range::REPLY_HEADER + ((read) ? header[0] * sizeof(T) : 0));
+        if (read && header[0])
+          std::memcpy(&out[range::REPLY_HEADER], first, header[0] * sizeof(T));
+      }
+      else
+      {
+        std::vector<uint64_t> positions;
+        for (size_t i = 0; i < nb_values; ++i)
+        {
+          if (data[i] >= limits[0] && data[i] <= limits[1])
+            positions.push_back(i);
+        }
+
+        header[0] = positions.size();
+        out.resize(range::REPLY_HEADER);
+        if (read && header[0])
+        {
+          out.resize(range::REPLY_HEADER +
+                     header[0] * (sizeof(uint64_t) + sizeof(T)));
+          std::memcpy(&out[range::REPLY_HEADER], &positions[0],
+                      header[0] * sizeof(uint64_t));
+          uint8_t* values =
+              &out[range::REPLY_HEADER] + header[0] * sizeof(uint64_t);
+          for (size_t i = 0; i < header[0]; ++i)
+            std::memcpy(values + i * sizeof(T), data + positions[i], sizeof(T));
+        }
+      }
+      std::memcpy(&out[0], header, sizeof(header));
+    }
+
+    void
+    onRange(MPI_Status& status, Memory& memory)
+    {
+      // Retrieves the request from the master.
+      // The request lays out like this, a zone map sending no bounds:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)   2 * sizeof (T)
+      // [...ID...]  [...DataType...]   [.....Flags.....]   [..Low, High..]
+      const int tag = status.MPI_TAG;
+      uint8_t* request = nullptr;
+      message::rec_sync<uint8_t>(0, tag, status, &request);
+
+      std::string id((const char*)request);
+      uint32_t params[2];
+      std::memcpy(params, request + constant::ID_LEN, sizeof(params));
+      const uint8_t* limits = request + constant::ID_LEN + sizeof(params);
+
+      const auto& chunk = memory.fetch(id, true);
+      const uint8_t* data = chunk.data();
+      const size_t size = chunk.size();
+      const uint32_t flags = params[1];
+
+      std::vector<uint8_t> out;
+      switch (params[0])
+      {
+        case DataType::USHORT:
+          rangeChunk<unsigned short>(tag, data, size, flags, limits, out);
+          break;
+        case DataType::SHORT:
+          rangeChunk<short>(tag, data, size, flags, limits, out);
+          break;
+        case DataType::UINT:
+          rangeChunk<unsigned int>(tag, data, size, flags, limits, out);
+          break;
+        case DataType::INT:
+          rangeChunk<int>(tag, data, size, flags, limits, out);
+          break;
+        case DataType::ULONG:
+          rangeChunk<unsigned long>(tag, data, size, flags, limits, out);
+          break;
+        case DataType::LONG:
+          rangeChunk<long>(tag, data, size, flags, limits, out);
+          break;
+        case DataType::FLOAT:
+          rangeChunk<float>(tag, data, size, flags, limits, out);
+          break;
+        case DataType::DOUBLE:
+          rangeChunk<double>(tag, data, size, flags, limits, out);
+          break;
+      }
+      delete[] request;
+
+      message::send_sync(out.data(), out.size(), 0, tag);
+    }
+
+    /**
+     * @brief Copy written data into a chunk, unless newer data have
+     * already been written.
+     *
+     * @param memory Memory of the slave.
+     * @param data Data to write.
+     * @param data_size Size of data.
+     * @param id Chunk to write.
+     * @param clock Clock of the write message.
+     */
+    void
+    applyWrite(Memory& memory, const uint8_t* data, int data_size,
+               const std::string& id, size_t clock)
+    {
+      auto& var = memory.get(id);
+      // Contains the oldest largest message received.
+      auto& old_pack = std::get<0>(memory.history()[id]);
+      auto& new_pack = std::get<1>(memory.history()[id]);
+
+      // Message is the newest, we can safely erase
+      // previously written data.
+      if (clock > std::get<0>(new_pack))
+      {
+        std::memcpy(&var[0], data, data_size);
+        setPack(clock, data_size, new_pack);
+        // A completed flush has been done,
+        // we can reset the history.
+        if ((size_t)data_size == var.size()) setPack(0, 0, old_pack);
+      }
+      else if (data_size > std::get<1>(old_pack) ||
+               clock > std::get<0>(old_pack))
+      {
+        const auto& start = std::get<1>(new_pack);
+        std::memcpy(&var[0] + start, data + start, data_size - start);
+        if (clock < std::get<0>(old_pack) || std::get<0>(old_pack) == 0)
+          setPack(clock, data_size, old_pack);
+      }
+    }
+
+    void
+    onAllocation(MPI_Status& status, Memory& memory, int rank)
+    {
+      int bytes = 0;
+      MPI_Get_count(&status, MPI_BYTE, &bytes);
+
+      // Allocation failed, we do not save it, and we return a fail.
+      if (bytes == MPI_UNDEFINED)
+      {
+        sendStatus(memory, TAGS::ALLOCATION, false);
+        return;
+      }
+
+      // Allocates the data on the cluster.
+      auto id = memory.reserve(rank, bytes);
+      if (id.empty())
+      {
+        // There is no room to keep the data. The message is still received
+        // in a scratch buffer, and dropped.
+        std::vector<uint8_t> scratch(bytes);
+        message::rec_sync<uint8_t>(0, TAGS::ALLOCATION, bytes, scratch.data());
+
+        sendStatus(memory, TAGS::ALLOCATION, false);
+        return;
+      }
+      message::rec_sync<uint8_t>(0, TAGS::ALLOCATION, bytes,
+                                 &memory.get(id)[0]);
+
+      // This is used in the `onWrite' callback.
+      // This will allow to handle old write messages
+      // that come after newer messages.
+      memory.history()[id] =
+          std::make_tuple(std::make_tuple(0, 0), std::make_tuple(0, 0));
+
+      // Sends an acknowledge to the master.
+      sendStatus(memory, TAGS::ALLOCATION, true, id);
+    }
+
+    void
+    onAllocationPacked(MPI_Status& status, Memory& memory, int rank)
+    {
+      // Retrieves the compressed data from the master.
+      // The data lays out like this:
+      //  sizeof (CodecHeader)      N
+      // [.....CodecHeader.....]  [Data]
+      uint8_t* data = nullptr;
+      int bytes = 0;
+      message::rec_sync<uint8_t>(0, TAGS::ALLOCATION_PACKED, status, &bytes,
+                                 &data);
+
+      // The chunk is allocated with its decoded size.
+      std::string id;
+      codec::CodecHeader header;
+      if (codec::readHeader(data, bytes, header))
+        id = memory.reserve(rank, header.raw_size);
+
+      bool success = !id.empty() && codec::decode(data, bytes,
+                                                  memory.get(id).data(),
+                                                  header.raw_size);
+      delete[] data;
+      if (!success)
+      {
+        if (!id.empty()) memory.release(id);
+        sendStatus(memory, TAGS::ALLOCATION, false);
+        return;
+      }
+
+      // This is used in the `onWrite' callback.
+      memory.history()[id] =
+          std::make_tuple(std::make_tuple(0, 0), std::make_tuple(0, 0));
+
+      // Sends an acknowledge to the master.
+      sendStatus(memory, TAGS::ALLOCATION, true, id);
+    }
+
+    void
+    onAllocationSparse(MPI_Status& status, Memory& memory, int rank)
+    {
+      // Retrieves the non-zero values from the master.
+      // The data lays out like this:
+      //  sizeof (uint64_t)   N * sizeof (uint64_t)   N * atom_size
+      // [...NB_VALUES...]    [.....Positions.....]   [..Values..]
+      uint8_t* data = nullptr;
+      int bytes = 0;
+      message::rec_sync<uint8_t>(0, TAGS::ALLOCATION_SPARSE, status, &bytes,
+                                 &data);
+
+      // Only positions and values are stored, the number of values
+      // of the chunk is kept aside.
+      std::string id;
+      uint64_t nb_values = 0;
+      if ((size_t)bytes >= sizeof(uint64_t))
+      {
+        std::memcpy(&nb_values, data, sizeof(uint64_t));
+        id = memory.reserve(rank, bytes - sizeof(uint64_t));
+      }
+      if (id.empty())
+      {
+        delete[] data;
+        sendStatus(memory, TAGS::ALLOCATION, false);
+        return;
+      }
+      std::memcpy(memory.get(id).data(), data + sizeof(uint64_t),
+                  bytes - sizeof(uint64_t));
+      memory.setSparse(id, nb_values);
+      delete[] data;
+
+      // This is used in the `onWrite' callback.
+      memory.history()[id] =
+          std::make_tuple(std::make_tuple(0, 0), std::make_tuple(0, 0));
+
+      // Sends an acknowledge to the master.
+      sendStatus(memory, TAGS::ALLOCATION, true, id);
+    }
+
+    /**
+     * @brief Fill a buffer with copies of a single element.
+     *
+     * @tparam T Type with the same size as the element.
+     * @param out Buffer to fill.
+     * @param nb_bytes Size of the buffer.
+     * @param value Element to copy.
+     */
+    template <typename T>
+    inline void
+    fill(uint8_t* out, size_t nb_bytes, const uint8_t* value)
+    {
+      T val;
+      std::memcpy(&val, value, sizeof(T));
+
+      T* data = (T*)out;
+      size_t nb_elt = nb_bytes / sizeof(T);
+      for (size_t i = 0; i < nb_elt; ++i) data[i] = val;
+    }
+
+    void
+    onAllocationFill(MPI_Status& status, Memory& memory, int rank)
+    {
+      static constexpr unsigned int HEADER_LEN =
+          sizeof(size_t) + sizeof(unsigned int);
+
+      // Retrieves the data from the master.
+      // The data lays out like this:
+      //  sizeof (size_t)   sizeof (uint)     64 bytes
+      // [...NB_BYTES...]  [..ATOM_SIZE..]  [...VALUE...]
+      uint8_t* data = nullptr;
+      int bytes = 0;
+      message::rec_sync<uint8_t>(0, TAGS::ALLOCATION_FILL, status, &bytes,
+                                 &data);
+
+      size_t nb_bytes = *((size_t*)data);
+      unsigned int atom_size = *((unsigned int*)(data + sizeof(size_t)));
+      const uint8_t* value = data + HEADER_LEN;
+
+      // The chunk is either filled below, or asked uninitialized: zeroing
+      // it first would only be wasted.
+      auto id = memory.reserve(rank, nb_bytes, false);
+      if (id.empty())
+      {
+        sendStatus(memory, TAGS::ALLOCATION, false);
+        delete[] data;
+        return;
+      }
+
+      auto* var_data = &memory.get(id)[0];
+      switch (atom_size)
+      {
+        // Nothing to fill, the chunk is left uninitialized.
+        case 0:
+          break;
+        case sizeof(uint8_t):
+          fill<uint8_t>(var_data, nb_bytes, value);
+          break;
+        case sizeof(uint16_t):
+          fill<uint16_t>(var_data, nb_bytes, value);
+          break;
+        case sizeof(uint32_t):
+          fill<uint32_t>(var_data, nb_bytes, value);
+          break;
+        case sizeof(uint64_t):
+          fill<uint64_t>(var_data, nb_bytes, value);
+          break;
+        default:
+          for (size_t i = 0; i + atom_size <= nb_bytes; i += atom_size)
+            std::memcpy(var_data + i, value, atom_size);
+          break;
+      }
+
+      memory.history()[id] =
+          std::make_tuple(std::make_tuple(0, 0), std::make_tuple(0, 0));
+
+      // Sends an acknowledge to the master.
+      sendStatus(memory, TAGS::ALLOCATION, true, id);
+
+      delete[] data;
+    }
+
+    void
+    onAllocationFile(MPI_Status& status, Memory& memory, int rank)
+    {
+      static constexpr unsigned int HEADER_LEN = 2 * sizeof(size_t);
+
+      // Retrieves the data from the master.
+      // The data lays out like this:
+      //  sizeof (size_t)   sizeof (size_t)     N
+      // [...NB_BYTES...]  [...OFFSET...]   [...PATH...]
+      uint8_t* data = nullptr;
+      int bytes = 0;
+      message::rec_sync<uint8_t>(0, TAGS::ALLOCATION_FILE, status, &bytes,
+                                 &data);
+
+      size_t nb_bytes = 0;
+      size_t offset = 0;
+      std::memcpy(&nb_bytes, data, sizeof(size_t));
+      std::memcpy(&offset, data + sizeof(size_t), sizeof(size_t));
+      std::string path((const char*)(data + HEADER_LEN));
+      delete[] data;
+
+      // The chunk is read in place, the file is not loaded on the master.
+      auto id = memory.reserve(rank, nb_bytes);
+      if (id.empty() || !file::read(path, offset, memory.get(id).data(),
+                                    nb_bytes))
+      {
+        if (!id.empty()) memory.release(id);
+        sendStatus(memory, TAGS::ALLOCATION, false);
+        return;
+      }
+
+      memory.history()[id] =
+          std::make_tuple(std::make_tuple(0, 0), std::make_tuple(0, 0));
+
+      // Sends an acknowledge to the master.
+      sendStatus(memory, TAGS::ALLOCATION, true, id);
+    }
+
+    void
+    onFileWrite(MPI_Status& status, Memory& memory)
+    {
+      // Retrieves the data from the master.
+      // The data lays out like this:
+      //  22 bytes   sizeof (size_t)     N
+      // [...ID...]  [...OFFSET...]   [...PATH...]
+      uint8_t* data = nullptr;
+      int bytes = 0;
+      message::rec_sync<uint8_t>(0, TAGS::FILE_WRITE, status, &bytes, &data);
+
+      std::string id((const char*)data);
+      size_t offset = 0;
+      std::memcpy(&offset, data + constant::ID_LEN, sizeof(size_t));
+      std::string path((const char*)(data + constant::ID_LEN + sizeof(size_t)));
+      delete[] data;
+
+      const auto& chunk = memory.fetch(id, true);
+      bool success = file::write(path, offset, chunk.data(), chunk.size());
+
+      // Sends an acknowledge to the master.
+      const uint8_t& ack = (success) ? constant::SUCCESS : constant::FAIL;
+      message::send_sync<uint8_t>(&ack, 1, 0, TAGS::FILE_WRITE);
+    }
+
+    void
+    onRead(MPI_Status& status, Memory& memory)
+    {
+      // Gets back ID sent by the master.
+      char* id = nullptr;
+      message::rec_sync(0, TAGS::READ, status, &id);
+
+      // Sends the data to the master. The send has to complete here,
+      // the chunk may be spilled by the next message.
+      const auto& data = memory.fetch(std::string(id), true);
+      message::send_sync(&data[0], data.size(), 0, TAGS::READ);
+
+      delete[] id;
+    }
+
+    void
+    onReadPacked(MPI_Status& status, Memory& memory)
+    {
+      // Retrieves the request from the master.
+      // The request lays out like this:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  sizeof (size_t)
+      // [...ID...]  [...DataType...]   [...AtomSize...]   [..Threshold..]
+      uint8_t* request = nullptr;
+      message::rec_sync<uint8_t>(0, TAGS::READ_PACKED, status, &request);
+
+      std::string id((const char*)request);
+      uint32_t data_type = 0;
+      uint32_t atom_size = 0;
+      size_t threshold = 0;
+      const uint8_t* params = request + constant::ID_LEN;
+      std::memcpy(&data_type, params, sizeof(uint32_t));
+      std::memcpy(&atom_size, params + sizeof(uint32_t), sizeof(uint32_t));
+      std::memcpy(&threshold, params + 2 * sizeof(uint32_t), sizeof(size_t));
+      delete[] request;
+
+      // The chunk is compressed before the next message can spill it.
+      const auto& data = memory.fetch(id, true);
+      std::vector<uint8_t> packed;
+      codec::encode(data.data(), data.size(), data_type, atom_size, threshold,
+                    packed);
+      message::send_sync(&packed[0], packed.size(), 0, TAGS::READ);
+    }
+
+    /**
+     * @brief Find the column of a field in a chunk storing records as one
+     * column per field.
+     *
+     * @param nb_bytes Size of the chunk.
+     * @param column Position of the field in a stored record.
+     * @param field_size Size of the field.
+     * @param record_size Size of a stored record, 0 for the whole chunk.
+     * @param offset Filled with the position of the column in the chunk.
+     *
+     * @return Size of the column.
+     */
+    size_t
+    getColumn(size_t nb_bytes, size_t column, size_t field_size,
+              size_t record_size, size_t& offset)
+    {
+      offset = 0;
+      if (record_size == 0) return nb_bytes;
+
+      const size_t nb_records = nb_bytes / record_size;
+      offset = nb_records * column;
+      return nb_records * field_size;
+    }
+
+    void
+    onReadColumn(MPI_Status& status, Memory& memory)
+    {
+      // Retrieves the request from the master.
+      // The request lays out like this:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint32_t)
+      // [...ID...]  [....Column....]   [...FieldSize...]  [..RecordSize..]
+      uint8_t* request = nullptr;
+      message::rec_sync<uint8_t>(0, TAGS::READ_COLUMN, status, &request);
+
+      std::string id((const char*)request);
+      uint32_t params[3];
+      std::memcpy(params, request + constant::ID_LEN, sizeof(params));
+      delete[] request;
+
+      // Only the bytes of the column are sent.
+      const auto& data = memory.fetch(id, true);
+      size_t offset = 0;
+      size_t nb_bytes =
+          getColumn(data.size(), params[0], params[1], params[2], offset);
+      message::send_sync(data.data() + offset, nb_bytes, 0, TAGS::READ);
+    }
+
+    void
+    onWrite(MPI_Status& status, Memory& memory)
+    {
+      // Retrieves the data from the master.
+      // The data lays out like this:
+      //    N bytes      22 bytes   sizeof (size_t)
+      // [...Data...]   [...ID...]   [..Clock..]
+      uint8_t* data = nullptr;
+      int bytes = 0;
+      message::rec_sync<uint8_t>(0, TAGS::WRITE, status, &bytes, &data);
+
+      // TODO: Handle error, which should not happen.
+      // In the case we have 0 bytes, it means
+      // that some data has been lost on the network.
+      MPI_Request req;
+      if (bytes == 0)
+      {
+        message::send<uint8_t>(&constant::FAIL, 1, 0, TAGS::WRITE, req);
+        return;
+      }
+
+      int data_size = bytes - constant::ID_LEN - sizeof(size_t);
+      int clock_offset = bytes - sizeof(size_t);
+
+      size_t clock = *((size_t*)(data + clock_offset));
+      const char* id_cstr = (char*)(data + data_size);
+      std::string id(id_cstr);
+      applyWrite(memory, data, data_size, id, clock);
+
+      // Sends an acknowledge to the master.
+      message::send<uint8_t>(&constant::SUCCESS, 1, 0, TAGS::WRITE, req);
+
+      delete[] data;
+    }
+
+    void
+    onWritePacked(MPI_Status& status, Memory& memory)
+    {
+      // Retrieves the compressed data from the master.
+      // The data lays out like this:
+      //  sizeof (CodecHeader)      N       22 bytes   sizeof (size_t)
+      // [.....CodecHeader.....]  [Data]   [...ID...]   [..Clock..]
+      uint8_t* data = nullptr;
+      int bytes = 0;
+      message::rec_sync<uint8_t>(0, TAGS::WRITE_PACKED, status, &bytes, &data);
+
+      const int packed_size = bytes - constant::ID_LEN - sizeof(size_t);
+      codec::CodecHeader header;
+      bool success =
+          packed_size > 0 && codec::readHeader(data, packed_size, header);
+
+      std::vector<uint8_t> decoded;
+      if (success)
+      {
+        size_t clock = 0;
+        std::memcpy(&clock, data + bytes - sizeof(size_t), sizeof(size_t));
+        std::string id((const char*)(data + packed_size));
+
+        success = header.raw_size <= memory.get(id).size();
+        if (success)
+        {
+          decoded.resize(header.raw_size);
+          success = codec::decode(data, packed_size, decoded.data(),
+                                  decoded.size());
+        }
+        if (success)
+          applyWrite(memory, decoded.data(), decoded.size(), id, clock);
+      }
+      delete[] data;
+
+      // Sends an acknowledge to the master.
+      const uint8_t& ack = (success) ? constant::SUCCESS : constant::FAIL;
+      message::send_sync<uint8_t>(&ack, 1, 0, TAGS::WRITE);
+    }
+
+    void
+    onGrow(MPI_Status& status, Memory& memory)
+    {
+      static constexpr unsigned int HEADER_LEN =
+          constant::ID_LEN + 2 * sizeof(size_t);
+
+      // Retrieves the data from the master.
+      // The data lays out like this:
+      //  22 bytes    sizeof (size_t)   sizeof (size_t)      N
+      // [...ID...]  [...NB_BYTES...]  [..CAPACITY..]   [...Data...]
+      uint8_t* data = nullptr;
+      int bytes = 0;
+      message::rec_sync<uint8_t>(0, TAGS::GROW, status, &bytes, &data);
+
+      std::string id((char*)data);
+      size_t nb_bytes = *((size_t*)(data + constant::ID_LEN));
+      size_t capacity = *((size_t*)(data + constant::ID_LEN + sizeof(size_t)));
+      size_t data_size = bytes - HEADER_LEN;
+
+      bool success = memory.resize(id, nb_bytes, capacity);
+      if (success && data_size)
+      {
+        auto& var = memory.get(id);
+        std::memcpy(&var[0] + nb_bytes - data_size, data + HEADER_LEN,
+                    data_size);
+      }
+
+      // Sends an acknowledge to the master.
+      sendStatus(memory, TAGS::GROW, success);
+
+      delete[] data;
+    }
+
+    /**
+     * @brief Load or store elements of a chunk, given their indices.
+     *
+     * @tparam N Size of one element.
+     * @param chunk Data of the chunk.
+     * @param indices Indices of the elements in the chunk.
+     * @param count Number of indices.
+     * @param values Loaded or stored values.
+     * @param store Whether values are stored in the chunk.
+     */
+    template <size_t N>
+    inline void
+    accessIndexed(uint8_t* chunk, const size_t* indices, size_t count,
+                  uint8_t* values, bool store)
+    {
+      // The size is known at compile time, each copy is a single
+      // load and a single store.
+      if (store)
+        for (size_t i = 0; i < count; ++i)
+          std::memcpy(chunk + indices[i] * N, values + i * N, N);
+      else
+        for (size_t i = 0; i < count; ++i)
+          std::memcpy(values + i * N, chunk + indices[i] * N, N);
+    }
+
+    void
+    accessIndexed(uint8_t* chunk, const size_t* indices, size_t count,
+                  uint8_t* values, bool store, unsigned int atom_size)
+    {
+      switch (atom_size)
+      {
+        case 1:
+          accessIndexed<1>(chunk, indices, count, values, store);
+          break;
+        case 2:
+          accessIndexed<2>(chunk, indices, count, values, store);
+          break;
+        case 4:
+          accessIndexed<4>(chunk, indices, count, values, store);
+          break;
+        case 8:
+          accessIndexed<8>(chunk, indices, count, values, store);
+          break;
+        default:
+          for (size_t i = 0; i < count; ++i)
+          {
+            uint8_t* elt = chunk + indices[i] * atom_size;
+            if (store)
+              std::memcpy(elt, values + i * atom_size, atom_size);
+            else
+              std::memcpy(values + i * atom_size, elt, atom_size);
+          }
+          break;
+      }
+    }
+
+    void
+    onIndexed(MPI_Status& status, Memory& memory, int tag)
+    {
+      static constexpr size_t HEADER_LEN =
+          sizeof(unsigned int) + sizeof(size_t);
+      static constexpr size_t SECTION_LEN = constant::ID_LEN + sizeof(size_t);
+
+      // Retrieves the data from the master.
+      // The data lays out like this:
+      //  sizeof (uint)  sizeof (size_t)
+      // [.ATOM_SIZE.]  [.NB_SECTIONS.]
+      // followed by each section:
+      //  22 bytes   sizeof (size_t)    N * sizeof (size_t)  N * ATOM_SIZE
+      // [...ID...]  [...COUNT...]      [...INDICES...]      [...VALUES...]
+      uint8_t* data = nullptr;
+      int bytes = 0;
+      message::rec_sync<uint8_t>(0, tag, status, &bytes, &data);
+
+      const bool store = (tag == TAGS::SCATTER);
+      unsigned int atom_size = 0;
+      size_t nb_sections = 0;
+      std::memcpy(&atom_size, data, sizeof(unsigned int));
+      std::memcpy(&nb_sections, data + sizeof(unsigned int), sizeof(size_t));
+
+      std::vector<uint8_t> out;
+      std::vector<size_t> indices;
+      std::vector<uint8_t> values;
+      const uint8_t* ptr = data + HEADER_LEN;
+      for (size_t s = 0; s < nb_sections; ++s)
+      {
+        std::string id((const char*)ptr);
+        size_t count = 0;
+        std::memcpy(&count, ptr + constant::ID_LEN, sizeof(size_t));
+        ptr += SECTION_LEN;
+
+        // Indices are copied to be correctly aligned.
+        indices.resize(count);
+        std::memcpy(&indices[0], ptr, count * sizeof(size_t));
+        ptr += count * sizeof(size_t);
+
+        auto* chunk = &memory.get(id)[0];
+        if (store)
+        {
+          values.assign(ptr, ptr + count * atom_size);
+          accessIndexed(chunk, &indices[0], count, &values[0], true,
+                        atom_size);
+          ptr += count * atom_size;
+        }
+        else
+        {
+          size_t offset = out.size();
+          out.resize(offset + count * atom_size);
+          accessIndexed(chunk, &indices[0], count, &out[0] + offset, false,
+                        atom_size);
+        }
+      }
+
+      // Sends the loaded values, or an acknowledge to the master.
+      if (store)
+        message::send_sync<uint8_t>(&constant::SUCCESS, 1, 0, tag);
+      else
+        message::send_sync<uint8_t>(&out[0], out.size(), 0, tag);
+
+      delete[] data;
+    }
+
+    void
+    onCopy(MPI_Status& status, Memory& memory, int rank)
+    {
+      // Retrieves the list of fragments to send and to receive.
+      Transfer* transfers = nullptr;
+      int bytes = 0;
+      MPI_Get_count(&status, MPI_BYTE, &bytes);
+      size_t nb_transfers = bytes / sizeof(Transfer);
+      transfers = new Transfer[nb_transfers];
+      message::rec_sync<Transfer>(0, TAGS::COPY, bytes, transfers);
+
+      // Fragments are directly sent from, and received in the chunks.
+      std::vector<MPI_Request> reqs;
+      for (size_t i = 0; i < nb_transfers; ++i)
+      {
+        const auto& t = transfers[i];
+        int count = t.nb_bytes;
+        if (t.src == rank && t.dst == rank)
+        {
+          auto* src = &memory.get(std::string(t.src_id))[0] + t.src_offset;
+          auto* dst = &memory.get(std::string(t.dst_id))[0] + t.dst_offset;
+          std::memmove(dst, src, t.nb_bytes);
+        }
+        else if (t.src == rank)
+        {
+          auto* src = &memory.get(std::string(t.src_id))[0] + t.src_offset;
+          reqs.emplace_back();
+          MPI_Isend(src, count, MPI_BYTE, t.dst, t.tag, peer_comm,
+                    &reqs.back());
+        }
+        else
+        {
+          auto* dst = &memory.get(std::string(t.dst_id))[0] + t.dst_offset;
+          reqs.emplace_back();
+          MPI_Irecv(dst, count, MPI_BYTE, t.src, t.tag, peer_comm,
+                    &reqs.back());
+        }
+      }
+      if (reqs.size())
+        MPI_Waitall(reqs.size(), &reqs[0], MPI_STATUSES_IGNORE);
+
+      // Sends an acknowledge to the master.
+      message::send_sync<uint8_t>(&constant::SUCCESS, 1, 0, TAGS::COPY);
+
+      delete[] transfers;
+    }
+
+    void
+    onQuit(Memory& memory)
+    {
+      memory.release();
+      MPI_Finalize();
+      std::exit(0);
+    }
+
+    void
+    onFree(MPI_Status& status, Memory& memory)
+    {
+      // Gets back ID sent by the master.
+      char* id = nullptr;
+      message::rec_sync(0, TAGS::FREE, status, &id);
+
+      // Frees the memory associated to the `id' ID.
+      memory.release(std::string(id));
+
+      // Sends the new status to the master.
+      sendStatus(memory, TAGS::FREE, true);
+
+      delete[] id;
+    }
+
+    void
+    onConfig(Memory& memory)
+    {
+      NodeConfig config;
+      message::rec_sync<NodeConfig>(0, TAGS::CONFIG, sizeof(NodeConfig),
+                                    &config);
+
+      sendStatus(memory, TAGS::CONFIG, memory.configure(config));
+    }
+
+    void
+    onCheckpoint(MPI_Status& status, Memory& memory, int rank, int tag)
+    {
+      // Gets back the directory sent by the master.
+      char* dir = nullptr;
+      message::rec_sync(0, tag, status, &dir);
+
+      // Every slave writes its own file at the same time.
+      const auto& path = checkpoint::getPath(std::string(dir), rank);
+      bool success = (tag == TAGS::CHECKPOINT) ? memory.checkpoint(path)
+                                               : memory.restore(path);
+      sendStatus(memory, tag, success);
+
+      delete[] dir;
+    }
+
+    void
+    onStatus(Memory& memory)
+    {
+      // The message is empty.
+      message::rec_sync<uint8_t>(0, TAGS::STATUS, 0, nullptr);
+
+      sendStatus(memory, TAGS::STATUS, true);
+    }
+
+    /**
+     * @brief Apply mapping callback on a chunk. Only the values of a
+     * sparse chunk are mapped, which requires the callback to keep zeros.
+     *
+     * @tparam T Type of element.
+     * @param input Bytes of the chunk.
+     * @param nb_bytes Size of input.
+     * @param sparse Whether the chunk is sparse.
+     * @param call_id Callback to use.
+     *
+     * @return False if the callback would change the implicit zeros.
+     */
+    template <typename T>
+    bool
+    mapChunk(uint8_t* input, size_t nb_bytes, bool sparse,
+             unsigned int call_id)
+    {
+      if (!sparse)
+      {
+        applyCallback<T>(input, nb_bytes, call_id);
+        return true;
+      }
+
+      T zero = 0;
+      algorep::callback::MAPS[call_id](&zero);
+      if (zero != T(0)) return false;
+
+      // Values are stored after the positions.
+      size_t count = nb_bytes / (sizeof(uint64_t) + sizeof(T));
+      applyCallback<T>(input + count * sizeof(uint64_t), count * sizeof(T),
+                       call_id);
+      return true;
+    }
+
+    /**
+     * @brief Apply reduce callbacks on a chunk. The implicit zeros of a
+     * sparse chunk are reduced until one of them leaves the accumulator
+     * unchanged, which is the case of most reductions (sum, max...).
+     *
+     * @tparam T Type of element.
+     * @param input Bytes of the chunk.
+     * @param nb_bytes Size of input.
+     * @param nb_values Number of values of a sparse chunk, 0 if dense.
+     * @param call_id Callback to use.
+     * @param out Accumulator.
+     */
+    template <typename T>
+    void
+    reduceChunk(const uint8_t* input, size_t nb_bytes, size_t nb_values,
+                unsigned int call_id, uint8_t* out)
+    {
+      if (nb_values == 0)
+      {
+        applyReduce<T>(input, nb_bytes, call_id, out);
+        return;
+      }
+
+      // Values are stored after the positions.
+      size_t count = nb_bytes / (sizeof(uint64_t) + sizeof(T));
+      applyReduce<T>(input + count * sizeof(uint64_t), count * sizeof(T),
+                     call_id, out);
+
+      const T zero = 0;
+      T* acc = (T*)out;
+      for (size_t i = count; i < nb_values; ++i)
+      {
+        const T previous = *acc;
+        algorep::callback::REDUCE[call_id](&zero, acc);
+        if (*acc == previous) break;
+      }
+    }
+
+    /**
+     * @brief Compute the statistics of values. Values are processed by
+     * blocks staying in cache: the sum, minimum and maximum of a block are
+     * computed first, the sum being split in independent lanes as in
+     * `summation::block`, then the squared differences to the mean of the
+     * block. Blocks are then merged. Sums are accumulated in double, so
+     * 64-bit integers and sums beyond 2^53 are rounded.
+     *
+     * @tparam T Type of element.
+     * @param input Values used as const T*.
+     * @param nb_bytes Size of input.
+     * @param out Statistics receiving the values.
+     */
+    template <typename T>
+    void
+    describeValues(const uint8_t* input, size_t nb_bytes, Statistics& out)
+    {
+      static constexpr size_t BLOCK = 1024;
+      static constexpr size_t LANES = 4;
+
+      const T* data = (const T*)input;
+      const size_t nb_elt = nb_bytes / sizeof(T);
+      for (size_t begin = 0; begin < nb_elt; begin += BLOCK)
+      {
+        const size_t end = std::min(begin + BLOCK, nb_elt);
+
+        T min = data[begin];
+        T max = data[begin];
+        double sums[LANES] = {0};
+        size_t i = begin;
+        for (; i + LANES <= end; i += LANES)
+        {
+          for (size_t j = 0; j < LANES; ++j)
+          {
+            min = std::min(min, data[i + j]);
+            max = std::max(max, data[i + j]);
+            sums[j] += data[i + j];
+          }
+        }
+        for (size_t j = 0; i + j < end; ++j)
+        {
+          min = std::min(min, data[i + j]);
+          max = std::max(max, data[i + j]);
+          sums[j] += data[i + j];
+        }
+        const double sum = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+
+        Statistics block;
+        block.count = end - begin;
+        block.min = min;
+        block.max = max;
+        block.sum = sum;
+        block.mean = sum / block.count;
+        block.m2 = 0;
+        for (size_t i = begin; i < end; ++i)
+        {
+          const double delta = data[i] - block.mean;
+          block.m2 += delta * delta;
+        }
+
+        statistics::merge(out, block);
+      }
+    }
+
+    void
+    onDescribe(MPI_Status& status, Memory& memory)
+    {
+      // Retrieves the request from the master.
+      // The request lays out like this:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint32_t)
+      // [...ID...]  [...DataType...]   [....Column....]   [..RecordSize..]
+      uint8_t* request = nullptr;
+      message::rec_sync<uint8_t>(0, TAGS::DESCRIBE, status, &request);
+
+      std::string id((const char*)request);
+      uint32_t params[3];
+      std::memcpy(params, request + constant::ID_LEN, sizeof(params));
+      delete[] request;
+
+      const uint32_t data_type = params[0];
+      const auto& chunk = memory.fetch(id, true);
+      const size_t atom_size = DataTypeToSize[data_type];
+      size_t offset = 0;
+      size_t nb_bytes =
+          getColumn(chunk.size(), params[1], atom_size, params[2], offset);
+
+      // Values of a sparse chunk are stored after their positions, the
+      // zeros are then added at once.
+      Statistics zeros = Statistics();
+      if (memory.isSparse(id))
+      {
+        const size_t count = chunk.size() / (sizeof(uint64_t) + atom_size);
+        offset = count * sizeof(uint64_t);
+        nb_bytes = count * atom_size;
+        zeros.count = memory.getSparseSize(id) - count;
+      }
+
+      Statistics result = Statistics();
+      const uint8_t* data = chunk.data() + offset;
+      switch (data_type)
+      {
+        case DataType::USHORT:
+          describeValues<unsigned short>(data, nb_bytes, result);
+          break;
+        case DataType::SHORT:
+          describeValues<short>(data, nb_bytes, result);
+          break;
+        case DataType::UINT:
+          describeValues<unsigned int>(data, nb_bytes, result);
+          break;
+        case DataType::INT:
+          describeValues<int>(data, nb_bytes, result);
+          break;
+        case DataType::ULONG:
+          describeValues<unsigned long>(data, nb_bytes, result);
+          break;
+        case DataType::LONG:
+          describeValues<long>(data, nb_bytes, result);
+          break;
+        case DataType::FLOAT:
+          describeValues<float>(data, nb_bytes, result);
+          break;
+        case DataType::DOUBLE:
+          describeValues<double>(data, nb_bytes, result);
+          break;
+      }
+      statistics::merge(result, zeros);
+
+      message::send_sync<uint8_t>((const uint8_t*)&result, sizeof(Statistics),
+                                  0, TAGS::DESCRIBE);
+    }
+
+    /**
+     * @brief Find the best values of a chunk, using a heap of k values
+     * with the worst one on top.
+     *
+     * @tparam T Type of element.
+     * @param input Bytes of the chunk.
+     * @param nb_bytes Size of input.
+     * @param nb_values Number of values of a sparse chunk, 0 if dense.
+     * @param k Number of values to find.
+     * @param largest Whether the largest values are looked for.
+     * @param out Filled with the number of values, their positions and
+     * the values, the best one first.
+     */
+    template <typename T>
+    void
+    topChunk(const uint8_t* input, size_t nb_bytes, size_t nb_values,
+             size_t k, bool largest, std::vector<uint8_t>& out)
+    {
+      using Entry = std::pair<T, uint64_t>;
+      auto better = [largest](const Entry& a, const Entry& b) {
+        if (a.first != b.first)
+          return (largest) ? a.first > b.first : a.first < b.first;
+        return a.second < b.second;
+      };
+
+      std::vector<Entry> heap;
+      auto push = [&](const T& value, uint64_t position) {
+        if (heap.size() < k)
+        {
+          heap.emplace_back(value, position);
+          std::push_heap(heap.begin(), heap.end(), better);
+        }
+        else if (better(Entry(value, position), heap.front()))
+        {
+          std::pop_heap(heap.begin(), heap.end(), better);
+          heap.back() = Entry(value, position);
+          std::push_heap(heap.begin(), heap.end(), better);
+        }
+      };
+
+      if (nb_values == 0)
+      {
+        const T* data = (const T*)input;
+        for (size_t i = 0; i < nb_bytes / sizeof(T); ++i) push(data[i], i);
+      }
+      else
+      {
+        // Values of a sparse chunk are stored after their positions.
+        const size_t count = nb_bytes / (sizeof(uint64_t) + sizeof(T));
+        const uint64_t* positions = (const uint64_t*)input;
+        const T* data = (const T*)(input + count * sizeof(uint64_t));
+        for (size_t i = 0; i < count; ++i) push(data[i], positions[i]);
+
+        // Only the first k zeros can be among the best values.
+        size_t stored = 0;
+        size_t nb_zeros = 0;
+        for (uint64_t p = 0; p < nb_values && nb_zeros < k; ++p)
+        {
+          if (stored < count && positions[stored] == p)
+          {
+            ++stored;
+            continue;
+          }
+          push(T(0), p);
+          ++nb_zeros;
+        }
+      }
+
+      std::sort_heap(heap.begin(), heap.end(), better);
+      const uint64_t nb_best = heap.size();
+      out.resize(sizeof(uint64_t) + nb_best * (sizeof(uint64_t) + sizeof(T)));
+      std::memcpy(&out[0], &nb_best, sizeof(uint64_t));
+      uint8_t* values = &out[0] + (nb_best + 1) * sizeof(uint64_t);
+      for (size_t i = 0; i < nb_best; ++i)
+      {
+        std::memcpy(&out[0] + (i + 1) * sizeof(uint64_t), &heap[i].second,
+                    sizeof(uint64_t));
+        std::memcpy(values + i * sizeof(T), &heap[i].first, sizeof(T));
+      }
+    }
+
+    void
+    onTopK(MPI_Status& status, Memory& memory)
+    {
+      // Retrieves the request from the master.
+      // The request lays out like this:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t)
+      // [...ID...]  [...DataType...]   [...Largest...]    [.......K.......]
+      uint8_t* request = nullptr;
+      message::rec_sync<uint8_t>(0, TAGS::TOP_K, status, &request);
+
+      std::string id((const char*)request);
+      uint32_t params[2];
+      uint64_t k = 0;
+      std::memcpy(params, request + constant::ID_LEN, sizeof(params));
+      std::memcpy(&k, request + constant::ID_LEN + sizeof(params),
+                  sizeof(uint64_t));
+      delete[] request;
+
+      const auto& chunk = memory.fetch(id, true);
+      const size_t nb_values =
+          (memory.isSparse(id)) ? memory.getSparseSize(id) : 0;
+      const uint8_t* data = chunk.data();
+      const size_t nb_bytes = chunk.size();
+      const bool largest = params[1];
+
+      std::vector<uint8_t> out;
+      switch (params[0])
+      {
+        case DataType::USHORT:
+          topChunk<unsigned short>(data, nb_bytes, nb_values, k, largest, out);
+          break;
+        case DataType::SHORT:
+          topChunk<short>(data, nb_bytes, nb_values, k, largest, out);
+          break;
+        case DataType::UINT:
+          topChunk<unsigned int>(data, nb_bytes, nb_values, k, largest, out);
+          break;
+        case DataType::INT:
+          topChunk<int>(data, nb_bytes, nb_values, k, largest, out);
+          break;
+        case DataType::ULONG:
+          topChunk<unsigned long>(data, nb_bytes, nb_values, k, largest, out);
+          break;
+        case DataType::LONG:
+          topChunk<long>(data, nb_bytes, nb_values, k, largest, out);
+          break;
+        case DataType::FLOAT:
+          topChunk<float>(data, nb_bytes, nb_values, k, largest, out);
+          break;
+        case DataType::DOUBLE:
+          topChunk<double>(data, nb_bytes, nb_values, k, largest, out);
+          break;
+      }
+
+      message::send_sync(out.data(), out.size(), 0, TAGS::TOP_K);
+    }
+
+    /**
+     * @brief Add values to a quantile sketch.
+     *
+     * @tparam T Type of element.
+     * @param input Values used as const T*.
+     * @param nb_bytes Size of input.
+     * @param out Sketch receiving the values.
+     */
+    template <typename T>
+    void
+    sketchValues(const uint8_t* input, size_t nb_bytes, QuantileSketch& out)
+    {
+      const T* data = (const T*)input;
+      for (size_t i = 0; i < nb_bytes / sizeof(T); ++i) out.add(data[i]);
+    }
+
+    void
+    onSketch(MPI_Status& status, Memory& memory)
+    {
+      // Retrieves the request from the master.
+      // The request lays out like this:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t)
+      // [...ID...]  [...DataType...]   [....Unused....]   [...Accuracy...]
+      uint8_t* request = nullptr;
+      message::rec_sync<uint8_t>(0, TAGS::SKETCH, status, &request);
+
+      std::string id((const char*)request);
+      uint32_t params[2];
+      uint64_t accuracy = 0;
+      std::memcpy(params, request + constant::ID_LEN, sizeof(params));
+      std::memcpy(&accuracy, request + constant::ID_LEN + sizeof(params),
+                  sizeof(uint64_t));
+      delete[] request;
+
+      const auto& chunk = memory.fetch(id, true);
+      const uint8_t* data = chunk.data();
+      size_t nb_bytes = chunk.size();
+
+      // Zeros of a sparse chunk are added at once.
+      QuantileSketch sketch(accuracy);
+      if (memory.isSparse(id))
+      {
+        const size_t atom_size = DataTypeToSize[params[0]];
+        const size_t count = nb_bytes / (sizeof(uint64_t) + atom_size);
+        data += count * sizeof(uint64_t);
+        nb_bytes = count * atom_size;
+        sketch.add(0, memory.getSparseSize(id) - count);
+      }
+
+      switch (params[0])
+      {
+        case DataType::USHORT:
+          sketchValues<unsigned short>(data, nb_bytes, sketch);
+          break;
+        case DataType::SHORT:
+          sketchValues<short>(data, nb_bytes, sketch);
+          break;
+        case DataType::UINT:
+          sketchValues<unsigned int>(data, nb_bytes, sketch);
+          break;
+        case DataType::INT:
+          sketchValues<int>(data, nb_bytes, sketch);
+          break;
+        case DataType::ULONG:
+          sketchValues<unsigned long>(data, nb_bytes, sketch);
+          break;
+        case DataType::LONG:
+          sketchValues<long>(data, nb_bytes, sketch);
+          break;
+        case DataType::FLOAT:
+          sketchValues<float>(data, nb_bytes, sketch);
+          break;
+        case DataType::DOUBLE:
+          sketchValues<double>(data, nb_bytes, sketch);
+          break;
+      }
+
+      std::vector<uint8_t> out;
+      sketch.serialize(out);
+      message::send_sync(out.data(), out.size(), 0, TAGS::SKETCH);
+    }
+
+    /**
+     * @brief Add the hashes of integer values to a sketch. Values are
+     * hashed by blocks, before the sketch is updated.
+     *
+     * @tparam T Integer type of element.
+     * @tparam S Type of sketch, either `HyperLogLog` or `BloomFilter`.
+     * @param input Values used as const T*.
+     * @param nb_bytes Size of input.
+     * @param out Sketch receiving the hashes.
+     */
+    template <typename T, typename S>
+    void
+    hashValues(const uint8_t* input, size_t nb_bytes, S& out)
+    {
+      const T* data = (const T*)input;
+      const size_t nb_values = nb_bytes / sizeof(T);
+      uint64_t hashes[hashing::BLOCK];
+      for (size_t i = 0; i < nb_values; i += hashing::BLOCK)
+      {
+        const size_t count = std::min(hashing::BLOCK, nb_values - i);
+        hashing::hashBlock(data + i, count, hashes);
+        for (size_t j = 0; j < count; ++j) out.add(hashes[j]);
+      }
+    }
+
+    /**
+     * @brief Add the hashes of the values of a chunk to a sketch.
+     *
+     * @tparam S Type of sketch, either `HyperLogLog` or `BloomFilter`.
+     * @param memory Memory of the slave.
+     * @param id Chunk to hash.
+     * @param data_type Type of the values (see `DataType`).
+     * @param out Sketch receiving the hashes.
+     */
+    template <typename S>
+    void
+    hashChunk(Memory& memory, const std::string& id, unsigned int data_type,
+              S& out)
+    {
+      const auto& chunk = memory.fetch(id, true);
+      const uint8_t* data = chunk.data();
+      size_t nb_bytes = chunk.size();
+
+      // A single zero stands for every zero of a sparse chunk.
+      if (memory.isSparse(id))
+      {
+        const size_t atom_size = DataTypeToSize[data_type];
+        const size_t count = nb_bytes / (sizeof(uint64_t) + atom_size);
+        data += count * sizeof(uint64_t);
+        nb_bytes = count * atom_size;
+        if (memory.getSparseSize(id) > count) out.add(hashing::hash(0));
+      }
+
+      switch (data_type)
+      {
+        case DataType::USHORT:
+          hashValues<unsigned short>(data, nb_bytes, out);
+          break;
+        case DataType::SHORT:
+          hashValues<short>(data, nb_bytes, out);
+          break;
+        case DataType::UINT:
+          hashValues<unsigned int>(data, nb_bytes, out);
+          break;
+        case DataType::INT:
+          hashValues<int>(data, nb_bytes, out);
+          break;
+        case DataType::ULONG:
+          hashValues<unsigned long>(data, nb_bytes, out);
+          break;
+        case DataType::LONG:
+          hashValues<long>(data, nb_bytes, out);
+          break;
+      }
+    }
+
+    void
+    onDistinct(MPI_Status& status, Memory& memory)
+    {
+      // Retrieves the request from the master.
+      // The request lays out like this:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t)
+      // [...ID...]  [...DataType...]   [...Precision...]  [....Unused....]
+      uint8_t* request = nullptr;
+      message::rec_sync<uint8_t>(0, TAGS::DISTINCT, status, &request);
+
+      std::string id((const char*)request);
+      uint32_t params[2];
+      std::memcpy(params, request + constant::ID_LEN, sizeof(params));
+      delete[] request;
+
+      HyperLogLog sketch(params[1]);
+      hashChunk(memory, id, params[0], sketch);
+
+      std::vector<uint8_t> out;
+      sketch.serialize(out);
+      message::send_sync(out.data(), out.size(), 0, TAGS::DISTINCT);
+    }
+
+    void
+    onBloom(MPI_Status& status, Memory& memory)
+    {
+      // Retrieves the request from the master.
+      // The request lays out like this:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t)
+      // [...ID...]  [...DataType...]   [..NB_HASHES..]    [...NB_BITS...]
+      uint8_t* request = nullptr;
+      message::rec_sync<uint8_t>(0, TAGS::BLOOM, status, &request);
+
+      std::string id((const char*)request);
+      uint32_t params[2];
+      uint64_t nb_bits = 0;
+      std::memcpy(params, request + constant::ID_LEN, sizeof(params));
+      std::memcpy(&nb_bits, request + constant::ID_LEN + sizeof(params),
+                  sizeof(uint64_t));
+      delete[] request;
+
+      BloomFilter filter(nb_bits, params[1]);
+      hashChunk(memory, id, params[0], filter);
+
+      std::vector<uint8_t> out;
+      filter.serialize(out);
+      message::send_sync(out.data(), out.size(), 0, TAGS::BLOOM);
+    }
+
+    /**
+     * @brief Test integer values against a Bloom filter.
+     *
+     * @tparam T Integer type of element.
+     * @param input Values used as const T*.
+     * @param nb_bytes Size of input.
+     * @param filter Filter to test against.
+     * @param out One byte per value, set to 1 if the value may be in the
+     * filter.
+     */
+    template <typename T>
+    void
+    filterValues(const uint8_t* input, size_t nb_bytes,
+                 const BloomFilter& filter, uint8_t* out)
+    {
+      const T* data = (const T*)input;
+      const size_t nb_values = nb_bytes / sizeof(T);
+      uint64_t hashes[hashing::BLOCK];
+      for (size_t i = 0; i < nb_values; i += hashing::BLOCK)
+      {
+        const size_t count = std::min(hashing::BLOCK, nb_values - i);
+        hashing::hashBlock(data + i, count, hashes);
+        for (size_t j = 0; j < count; ++j)
+          out[i + j] = filter.contains(hashes[j]);
+      }
+    }
+
+    void
+    onFilter(MPI_Status& status, Memory& memory, int rank)
+    {
+      // Retrieves the request from the master.
+      // The request lays out like this:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)       N
+      // [...ID...]  [...DataType...]   [....Unused....]   [..Filter..]
+      uint8_t* request = nullptr;
+      int bytes = 0;
+      message::rec_sync<uint8_t>(0, TAGS::FILTER, status, &bytes, &request);
+
+      std::string id((const char*)request);
+      uint32_t params[2];
+      std::memcpy(params, request + constant::ID_LEN, sizeof(params));
+      const size_t header_len = constant::ID_LEN + sizeof(params);
+      BloomFilter filter;
+      const bool valid =
+          filter.deserialize(request + header_len, bytes - header_len);
+      delete[] request;
+
+      // Results take one byte per value, next to the tested chunk.
+      const size_t atom_size = DataTypeToSize[params[0]];
+      const size_t nb_values = memory.get(id).size() / atom_size;
+      auto result = (valid) ? memory.reserve(rank, nb_values) : std::string();
+      if (result.empty())
+      {
+        sendStatus(memory, TAGS::ALLOCATION, false);
+        return;
+      }
+      memory.history()[result] =
+          std::make_tuple(std::make_tuple(0, 0), std::make_tuple(0, 0));
+
+      // Getting the results does not move any chunk, so both pointers
+      // stay valid.
+      const uint8_t* data = memory.fetch(id, true).data();
+      uint8_t* out = memory.get(result).data();
+      const size_t nb_bytes = nb_values * atom_size;
+      switch (params[0])
+      {
+        case DataType::USHORT:
+          filterValues<unsigned short>(data, nb_bytes, filter, out);
+          break;
+        case DataType::SHORT:
+          filterValues<short>(data, nb_bytes, filter, out);
+          break;
+        case DataType::UINT:
+          filterValues<unsigned int>(data, nb_bytes, filter, out);
+          break;
+        case DataType::INT:
+          filterValues<int>(data, nb_bytes, filter, out);
+          break;
+        case DataType::ULONG:
+          filterValues<unsigned long>(data, nb_bytes, filter, out);
+          break;
+        case DataType::LONG:
+          filterValues<long>(data, nb_bytes, filter, out);
+          break;
+      }
+
+      sendStatus(memory, TAGS::ALLOCATION, true, result);
+    }
+
+    /**
+     * @brief Convert a range of values of a chunk to doubles.
+     *
+     * @tparam T Type of element.
+     * @param input Chunk, dense or sparse.
+     * @param nb_stored Number of values stored in the chunk.
+     * @param sparse Whether the chunk is sparse.
+     * @param begin Position of the first value, local to the chunk.
+     * @param count Number of values to convert.
+     * @param out Filled with the values, zeros included.
+     */
+    template <typename T>
+    void
+    toDoubles(const uint8_t* input, size_t nb_stored, bool sparse,
+              size_t begin, size_t count, double* out)
+    {
+      if (!sparse)
+      {
+        const T* data = (const T*)input + begin;
+        for (size_t i = 0; i < count; ++i) out[i] = data[i];
+        return;
+      }
+
+      const uint64_t* positions = (const uint64_t*)input;
+      const T* values = (const T*)(input + nb_stored * sizeof(uint64_t));
+      std::fill(out, out + count, 0.0);
+      auto* it = std::lower_bound(positions, positions + nb_stored, begin);
+      for (; it != positions + nb_stored && *it < begin + count; ++it)
+        out[*it - begin] = values[it - positions];
+    }
+
+    void
+    onSum(MPI_Status& status, Memory& memory)
+    {
+      // Retrieves the request from the master.
+      // The request lays out like this:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t) * 2
+      // [...ID...]  [...DataType...]   [....Unused....]   [Lower, NB_VALUES]
+      uint8_t* request = nullptr;
+      message::rec_sync<uint8_t>(0, TAGS::SUM, status, &request);
+
+      std::string id((const char*)request);
+      uint32_t params[2];
+      uint64_t range[2];
+      std::memcpy(params, request + constant::ID_LEN, sizeof(params));
+      std::memcpy(range, request + constant::ID_LEN + sizeof(params),
+                  sizeof(range));
+      delete[] request;
+
+      const auto& chunk = memory.fetch(id, true);
+      const bool sparse = memory.isSparse(id);
+      const size_t atom_size = DataTypeToSize[params[0]];
+      const size_t nb_stored =
+          chunk.size() / ((sparse) ? sizeof(uint64_t) + atom_size : atom_size);
+      const size_t lower = range[0];
+      const size_t total = range[1];
+      const size_t end =
+          lower + ((sparse) ? memory.getSparseSize(id) : nb_stored);
+
+      const auto& convert = [&](size_t position, size_t count, double* out) {
+        if (params[0] == DataType::FLOAT)
+          toDoubles<float>(chunk.data(), nb_stored, sparse, position - lower,
+                           count, out);
+        else if (params[0] == DataType::DOUBLE)
+          toDoubles<double>(chunk.data(), nb_stored, sparse, position - lower,
+                            count, out);
+      };
+
+      // Blocks entirely inside the chunk are summed here, the values of
+      // the others are sent to the master.
+      const size_t block_len = summation::BLOCK;
+      const size_t first = (lower + block_len - 1) / block_len;
+      const size_t last = (end == total) ? (total + block_len - 1) / block_len
+                                         : end / block_len;
+      const size_t nb_blocks = (last > first) ? last - first : 0;
+      const size_t head_end = (nb_blocks) ? first * block_len : end;
+      const size_t tail_begin =
+          (nb_blocks) ? std::min(last * block_len, total) : end;
+
+      // The reply lays out like this:
+      //  sizeof (uint64_t) * 2   B * 16   sizeof (uint64_t)   H * 8
+      // [First block, B]        [Sums]   [.......H.......]   [Values]
+      //  sizeof (uint64_t)   T * 8
+      // [.......T.......]    [Values]
+      const uint64_t counts[4] = {first, nb_blocks, head_end - lower,
+                                  end - tail_begin};
+      std::vector<uint8_t> out(4 * sizeof(uint64_t) +
+                               (2 * nb_blocks + counts[2] + counts[3]) *
+                                   sizeof(double));
+      uint8_t* cursor = &out[0];
+      std::memcpy(cursor, counts, 2 * sizeof(uint64_t));
+      cursor += 2 * sizeof(uint64_t);
+
+      double values[summation::BLOCK];
+      for (size_t b = first; b < first + nb_blocks; ++b)
+      {
+        const size_t count =
+            std::min(block_len, total - b * block_len);
+        convert(b * block_len, count, values);
+        double sum[2];
+        summation::block(values, count, sum);
+        std::memcpy(cursor, sum, sizeof(sum));
+        cursor += sizeof(sum);
+      }
+
+      std::memcpy(cursor, &counts[2], sizeof(uint64_t));
+      cursor += sizeof(uint64_t);
+      convert(lower, counts[2], (double*)cursor);
+      cursor += counts[2] * sizeof(double);
+      std::memcpy(cursor, &counts[3], sizeof(uint64_t));
+      cursor += sizeof(uint64_t);
+      convert(tail_begin, counts[3], (double*)cursor);
+
+      message::send_sync(out.data(), out.size(), 0, TAGS::SUM);
+    }
+
+    /**
+     * @brief Apply a parameterized kernel on a chunk. Only the values of a
+     * sparse chunk are mapped, which requires the kernel to keep zeros.
+     *
+     * @tparam T Type of element.
+     * @param input Bytes of the chunk.
+     * @param nb_bytes Size of input.
+     * @param sparse Whether the chunk is sparse.
+     * @param kernel_id Kernel to use (see `MapParamID`).
+     * @param raw_params `MAX_PARAMS` parameters, as bytes.
+     *
+     * @return False if the kernel is unknown, or would change the implicit
+     * zeros.
+     */
+    template <typename T>
+    bool
+    mapParamChunk(uint8_t* input, size_t nb_bytes, bool sparse,
+                  unsigned int kernel_id, const uint8_t* raw_params)
+    {
+      T params[callback::MAX_PARAMS];
+      std::memcpy(params, raw_params, sizeof(params));
+      if (!sparse)
+        return callback::mapParams<T>(kernel_id, params, (T*)input,
+                                      nb_bytes / sizeof(T));
+
+      T zero = 0;
+      if (!callback::mapParams<T>(kernel_id, params, &zero, 1)) return false;
+      if (zero != T(0)) return false;
+
+      // Values are stored after the positions.
+      size_t count = nb_bytes / (sizeof(uint64_t) + sizeof(T));
+      return callback::mapParams<T>(
+          kernel_id, params, (T*)(input + count * sizeof(uint64_t)), count);
+    }
+
     void
-    setPack(size_t clock, int size, std::tuple<size_t, int>& out)
+    onMapParam(MPI_Status& status, Memory& memory)
     {
-      std::get<0>(out) = clock;
-      std::get<1>(out) = size;
+      // Retrieves the request from the master.
+      // The request lays out like this:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  MAX_PARAMS * size
+      // [...ID...]  [...DataType...]   [....Kernel....]   [...Params...]
+      uint8_t* request = nullptr;
+      message::rec_sync<uint8_t>(0, TAGS::MAP_PARAM, status, &request);
+
+      std::string id((const char*)request);
+      uint32_t params[2];
+      std::memcpy(params, request + constant::ID_LEN, sizeof(params));
+      const uint8_t* raw = request + constant::ID_LEN + sizeof(params);
+
+      auto& chunk = memory.fetch(id, true);
+      uint8_t* data = &chunk[0];
+      const size_t nb_bytes = chunk.size();
+      const bool sparse = memory.isSparse(id);
+      const unsigned int kernel = params[1];
+      bool success = false;
+      switch (params[0])
+      {
+        case DataType::USHORT:
+          success = mapParamChunk<unsigned short>(data, nb_bytes, sparse,
+                                                  kernel, raw);
+          break;
+        case DataType::SHORT:
+          success = mapParamChunk<short>(data, nb_bytes, sparse, kernel, raw);
+          break;
+        case DataType::UINT:
+          success = mapParamChunk<unsigned int>(data, nb_bytes, sparse,
+                                                kernel, raw);
+          break;
+        case DataType::INT:
+          success = mapParamChunk<int>(data, nb_bytes, sparse, kernel, raw);
+          break;
+        case DataType::ULONG:
+          success = mapParamChunk<unsigned long>(data, nb_bytes, sparse,
+                                                 kernel, raw);
+          break;
+        case DataType::LONG:
+          success = mapParamChunk<long>(data, nb_bytes, sparse, kernel, raw);
+          break;
+        case DataType::FLOAT:
+          success = mapParamChunk<float>(data, nb_bytes, sparse, kernel, raw);
+          break;
+        case DataType::DOUBLE:
+          success = mapParamChunk<double>(data, nb_bytes, sparse, kernel, raw);
+          break;
+      }
+      delete[] request;
+
+      // Sends an acknowledge to the master.
+      message::send_sync<uint8_t>(
+          (success) ? &constant::SUCCESS : &constant::FAIL, 1, 0,
+          TAGS::MAP_PARAM);
     }
 
+    /**
+     * @brief Start exchanging the halos of a chunk with the chunks holding
+     * the neighbouring ranges. The halo received from the previous chunk
+     * is made of its last values, and the one received from the next chunk
+     * of its first values.
+     *
+     * @param halo Chunk and its neighbours.
+     * @param values Values of the chunk, preceded by `left_bytes` bytes
+     * and followed by `right_bytes` bytes receiving the halos.
+     * @param nb_bytes Size of the chunk, at least the size of the halos.
+     * @param left_bytes Size of the halo received from the previous chunk.
+     * @param right_bytes Size of the halo received from the next chunk.
+     * @param reqs Requests to wait for before reading the halos.
+     */
     void
-    onAllocation(MPI_Status& status, Memory& memory, int rank)
+    startHalo(const Halo& halo, uint8_t* values, size_t nb_bytes,
+              size_t left_bytes, size_t right_bytes,
+              std::vector<MPI_Request>& reqs)
     {
-      MPI_Request req;
+      uint8_t* chunk = values + left_bytes;
+      if (halo.left && left_bytes)
+      {
+        reqs.emplace_back();
+        MPI_Irecv(values, left_bytes, MPI_BYTE, halo.left,
+                  haloTag(halo.index, false), peer_comm, &reqs.back());
+      }
+      if (halo.left && right_bytes)
+      {
+        reqs.emplace_back();
+        MPI_Isend(chunk, right_bytes, MPI_BYTE, halo.left,
+                  haloTag(halo.index - 1, true), peer_comm, &reqs.back());
+      }
+      if (halo.right && right_bytes)
+      {
+        reqs.emplace_back();
+        MPI_Irecv(chunk + nb_bytes, right_bytes, MPI_BYTE, halo.right,
+                  haloTag(halo.index, true), peer_comm, &reqs.back());
+      }
+      if (halo.right && left_bytes)
+      {
+        reqs.emplace_back();
+        MPI_Isend(chunk + nb_bytes - left_bytes, left_bytes, MPI_BYTE,
+                  halo.right, haloTag(halo.index + 1, false), peer_comm,
+                  &reqs.back());
+      }
+    }
+
+    /**
+     * @brief Retrieve a request sent by `sendHalo`.
+     *
+     * @param status Status of the probed message.
+     * @param tag Operation identifier.
+     * @param halos Filled with the chunks of the slave.
+     * @param params Filled with the parameters of the operation.
+     */
+    void
+    receiveHalo(MPI_Status& status, int tag, std::vector<Halo>& halos,
+                std::vector<uint8_t>& params)
+    {
+      // The request lays out like this:
+      //  sizeof (uint64_t)   N * sizeof (Halo)      P
+      // [.......N.......]    [.....Chunks.....]   [Params]
+      uint8_t* request = nullptr;
       int bytes = 0;
-      MPI_Get_count(&status, MPI_BYTE, &bytes);
+      message::rec_sync<uint8_t>(0, tag, status, &bytes, &request);
 
-      // Allocation failed, we do not save it, and we return a fail.
-      if (bytes == MPI_UNDEFINED)
+      uint64_t nb_halos = 0;
+      std::memcpy(&nb_halos, request, sizeof(uint64_t));
+      halos.resize(nb_halos);
+      const size_t halos_len = nb_halos * sizeof(Halo);
+      std::memcpy(&halos[0], request + sizeof(uint64_t), halos_len);
+      params.assign(request + sizeof(uint64_t) + halos_len, request + bytes);
+      delete[] request;
+    }
+
+    /**
+     * @brief Apply a stencil on a range of values. Weights are applied one
+     * after another on the whole range, so that the inner loop has no
+     * dependency between positions.
+     *
+     * @tparam T Type of element.
+     * @param in Values, preceded by their halo.
+     * @param out Result, preceded by room for a halo.
+     * @param weights Weights of the stencil.
+     * @param nb_weights Number of weights, 2 * halo + 1.
+     * @param begin First position computed, in the chunk.
+     * @param end Position following the last computed one.
+     */
+    template <typename T>
+    void
+    applyStencil(const T* in, T* out, const T* weights, size_t nb_weights,
+                 size_t begin, size_t end)
+    {
+      T* result = out + nb_weights / 2;
+      for (size_t i = begin; i < end; ++i) result[i] = 0;
+      for (size_t k = 0; k < nb_weights; ++k)
       {
-        message::send<uint8_t>(&constant::FAIL, 1, 0, TAGS::ALLOCATION, req);
-        return;
+        const T weight = weights[k];
+        for (size_t i = begin; i < end; ++i) result[i] += weight * in[i + k];
       }
+    }
 
-      // Allocates the data on the cluster.
-      auto id = memory.reserve(rank, bytes);
-      message::rec_sync<uint8_t>(0, TAGS::ALLOCATION, bytes,
-                                 &memory.get(id)[0]);
+    /**
+     * @brief Apply a stencil on every chunk of the slave. Chunks are
+     * computed together step by step, so that neighbouring chunks on the
+     * same slave never wait for each other.
+     *
+     * @tparam T Type of element.
+     * @param memory Memory of the slave.
+     * @param halos Chunks of the slave.
+     * @param raw_weights Weights of the stencil, as bytes.
+     * @param nb_weights Number of weights.
+     * @param nb_steps Number of times the stencil is applied.
+     */
+    template <typename T>
+    void
+    stencilChunks(Memory& memory, const std::vector<Halo>& halos,
+                  const uint8_t* raw_weights, size_t nb_weights,
+                  size_t nb_steps)
+    {
+      std::vector<T> weights(nb_weights);
+      std::memcpy(&weights[0], raw_weights, nb_weights * sizeof(T));
+      const size_t h = nb_weights / 2;
 
-      // This is used in the `onWrite' callback.
-      // This will allow to handle old write messages
-      // that come after newer messages.
-      memory.history()[id] =
-          std::make_tuple(std::make_tuple(0, 0), std::make_tuple(0, 0));
+      // Each chunk is computed in a buffer having room for its halos.
+      std::vector<std::vector<T>> cur(halos.size());
+      std::vector<std::vector<T>> next(halos.size());
+      std::vector<size_t> lens(halos.size());
+      for (size_t c = 0; c < halos.size(); ++c)
+      {
+        const auto& chunk = memory.fetch(std::string(halos[c].src_id), true);
+        lens[c] = chunk.size() / sizeof(T);
+        cur[c].resize(lens[c] + 2 * h);
+        next[c].resize(lens[c] + 2 * h);
+        std::memcpy(&cur[c][h], chunk.data(), lens[c] * sizeof(T));
+      }
 
-      // Sends an acknowledge to the master.
-      message::send(id, 0, TAGS::ALLOCATION, req);
+      for (size_t step = 0; step < nb_steps; ++step)
+      {
+        std::vector<MPI_Request> reqs;
+        for (size_t c = 0; c < halos.size(); ++c)
+        {
+          auto& values = cur[c];
+          startHalo(halos[c], (uint8_t*)&values[0], lens[c] * sizeof(T),
+                    h * sizeof(T), h * sizeof(T), reqs);
+
+          // The bounds of the element are repeated outside of it.
+          if (!halos[c].left) std::fill_n(&values[0], h, values[h]);
+          if (!halos[c].right)
+            std::fill_n(&values[h + lens[c]], h, values[h + lens[c] - 1]);
+        }
+
+        // The interior does not need the halos, and is computed while
+        // they are exchanged.
+        for (size_t c = 0; c < halos.size(); ++c)
+        {
+          const size_t end = (lens[c] > h) ? lens[c] - h : 0;
+          applyStencil<T>(&cur[c][0], &next[c][0], &weights[0], nb_weights,
+                          std::min(h, end), end);
+        }
+        if (reqs.size())
+          MPI_Waitall(reqs.size(), &reqs[0], MPI_STATUSES_IGNORE);
+
+        for (size_t c = 0; c < halos.size(); ++c)
+        {
+          const size_t head = std::min(h, lens[c]);
+          const size_t tail = std::max(head, (lens[c] > h) ? lens[c] - h : 0);
+          applyStencil<T>(&cur[c][0], &next[c][0], &weights[0], nb_weights,
+                          0, head);
+          applyStencil<T>(&cur[c][0], &next[c][0], &weights[0], nb_weights,
+                          tail, lens[c]);
+          cur[c].swap(next[c]);
+        }
+      }
+
+      for (size_t c = 0; c < halos.size(); ++c)
+      {
+        auto& chunk = memory.fetch(std::string(halos[c].dst_id), true);
+        std::memcpy(chunk.data(), &cur[c][h], lens[c] * sizeof(T));
+      }
     }
 
     void
-    onRead(MPI_Status& status, const Memory& memory)
+    onStencil(MPI_Status& status, Memory& memory)
     {
-      // Gets back ID sent by the master.
-      char* id = nullptr;
-      message::rec_sync(0, TAGS::READ, status, &id);
+      std::vector<Halo> halos;
+      std::vector<uint8_t> params;
+      receiveHalo(status, TAGS::STENCIL, halos, params);
 
-      // Sends the data to the master.
-      MPI_Request req;
-      const auto& data = memory.getConst(std::string(id));
-      message::send(&data[0], data.size(), 0, TAGS::READ, req);
+      // Parameters lay out like this:
+      //  sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t)   N * size
+      // [...DataType...]   [..NB_WEIGHTS..]   [...NB_STEPS...]   [Weights]
+      uint32_t header[2];
+      uint64_t nb_steps = 0;
+      std::memcpy(header, &params[0], sizeof(header));
+      std::memcpy(&nb_steps, &params[sizeof(header)], sizeof(uint64_t));
+      const uint8_t* weights = &params[sizeof(header) + sizeof(uint64_t)];
 
-      delete[] id;
+      const size_t nb_weights = header[1];
+      switch (header[0])
+      {
+        case DataType::USHORT:
+          stencilChunks<unsigned short>(memory, halos, weights, nb_weights,
+                                        nb_steps);
+          break;
+        case DataType::SHORT:
+          stencilChunks<short>(memory, halos, weights, nb_weights, nb_steps);
+          break;
+        case DataType::UINT:
+          stencilChunks<unsigned int>(memory, halos, weights, nb_weights,
+                                      nb_steps);
+          break;
+        case DataType::INT:
+          stencilChunks<int>(memory, halos, weights, nb_weights, nb_steps);
+          break;
+        case DataType::ULONG:
+          stencilChunks<unsigned long>(memory, halos, weights, nb_weights,
+                                       nb_steps);
+          break;
+        case DataType::LONG:
+          stencilChunks<long>(memory, halos, weights, nb_weights, nb_steps);
+          break;
+        case DataType::FLOAT:
+          stencilChunks<float>(memory, halos, weights, nb_weights, nb_steps);
+          break;
+        case DataType::DOUBLE:
+          stencilChunks<double>(memory, halos, weights, nb_weights, nb_steps);
+          break;
+      }
+
+      // Sends an acknowledge to the master.
+      message::send_sync<uint8_t>(&constant::SUCCESS, 1, 0, TAGS::STENCIL);
     }
 
+    /**
+     * @brief Compute rolling aggregates over a range of values. Sums are
+     * updated by adding the entering value and removing the leaving one,
+     * minimums and maximums are kept by a monotonic deque of positions, so
+     * that each value costs O(1).
+     *
+     * @tparam T Type of element.
+     * @param values Values read.
+     * @param lo First existing position, windows never reaching before it.
+     * @param begin First position computed.
+     * @param end Position following the last computed one.
+     * @param window Number of values of a window.
+     * @param kind Aggregate to compute (see `callback::RollingID`).
+     * @param out Receives the aggregates of [begin, end).
+     */
+    template <typename T>
     void
-    onWrite(MPI_Status& status, Memory& memory)
+    rollValues(const T* values, size_t lo, size_t begin, size_t end,
+               size_t window, unsigned int kind, T* out)
     {
-      // Retrieves the data from the master.
-      // The data lays out like this:
-      //    N bytes      22 bytes   sizeof (size_t)
-      // [...Data...]   [...ID...]   [..Clock..]
-      uint8_t* data = nullptr;
-      int bytes = 0;
-      message::rec_sync<uint8_t>(0, TAGS::WRITE, status, &bytes, &data);
+      using namespace algorep::callback;
 
-      // TODO: Handle error, which should not happen.
-      // In the case we have 0 bytes, it means
-      // that some data has been lost on the network.
-      MPI_Request req;
-      if (bytes == 0)
+      if (begin >= end) return;
+      const size_t start = (begin >= lo + window) ? begin + 1 - window : lo;
+      const bool sums = kind == ROLLING_SUM || kind == ROLLING_MEAN;
+
+      // Positions, whose values are decreasing for a maximum.
+      std::vector<size_t> deque(end - start);
+      size_t head = 0;
+      size_t tail = 0;
+      T sum = 0;
+      for (size_t i = start; i < end; ++i)
       {
-        message::send<uint8_t>(&constant::FAIL, 1, 0, TAGS::WRITE, req);
-        return;
+        if (sums)
+        {
+          sum += values[i];
+          if (i >= start + window) sum -= values[i - window];
+        }
+        else
+        {
+          while (tail > head && ((kind == ROLLING_MAX)
+                                     ? values[deque[tail - 1]] <= values[i]
+                                     : values[deque[tail - 1]] >= values[i]))
+            --tail;
+          deque[tail++] = i;
+          if (deque[head] + window <= i) ++head;
+        }
+        if (i < begin) continue;
+
+        switch (kind)
+        {
+          case ROLLING_SUM:
+            out[i - begin] = sum;
+            break;
+          case ROLLING_MEAN:
+            out[i - begin] = sum / (T)std::min(window, i - start + 1);
+            break;
+          default:
+            out[i - begin] = values[deque[head]];
+            break;
+        }
       }
+    }
 
-      int data_size = bytes - constant::ID_LEN - sizeof(size_t);
-      int clock_offset = bytes - sizeof(size_t);
+    /**
+     * @brief Compute rolling aggregates on every chunk of the slave. A
+     * chunk needs the `window - 1` values preceding it, which may span
+     * several chunks: each chunk receives them from the previous one, and
+     * sends on the last `window - 1` values of its halo followed by its own
+     * values. Windows not needing the halo are computed while it is in
+     * flight.
+     *
+     * @tparam T Type of element.
+     * @param memory Memory of the slave.
+     * @param halos Chunks of the slave, in the order of the element.
+     * @param window Number of values of a window.
+     * @param kind Aggregate to compute (see `callback::RollingID`).
+     */
+    template <typename T>
+    void
+    rollChunks(Memory& memory, const std::vector<Halo>& halos, size_t window,
+               unsigned int kind)
+    {
+      const size_t h = window - 1;
+      std::vector<std::vector<T>> values(halos.size());
+      std::vector<std::vector<T>> lefts(halos.size());
+      std::vector<std::vector<T>> results(halos.size());
+      std::vector<MPI_Request> recvs(halos.size(), MPI_REQUEST_NULL);
+      for (size_t c = 0; c < halos.size(); ++c)
+      {
+        const auto& chunk = memory.fetch(std::string(halos[c].src_id), true);
+        const size_t len = chunk.size() / sizeof(T);
+        values[c].resize(h + len);
+        results[c].resize(len);
+        std::memcpy(&values[c][h], chunk.data(), len * sizeof(T));
 
-      size_t clock = *((size_t*)(data + clock_offset));
-      const char* id_cstr = (char*)(data + data_size);
-      std::string id(id_cstr);
+        // Halos are shorter near the start of the element.
+        if (!halos[c].left || h == 0) continue;
+        lefts[c].resize(h);
+        MPI_Irecv(&lefts[c][0], h * sizeof(T), MPI_BYTE, halos[c].left,
+                  haloTag(halos[c].index, false), peer_comm, &recvs[c]);
+      }
 
-      auto& var = memory.get(id);
-      // Contains the oldest largest message received.
-      auto& old_pack = std::get<0>(memory.history()[id]);
-      auto& new_pack = std::get<1>(memory.history()[id]);
+      // Windows ending after the first `h` values are inside the chunk.
+      for (size_t c = 0; c < halos.size(); ++c)
+      {
+        const size_t len = results[c].size();
+        rollValues<T>(&values[c][0], h, std::min(2 * h, h + len), h + len,
+                      window, kind, results[c].data() + std::min(h, len));
+      }
 
-      // Message is the newest, we can safely erase
-      // previously written data.
-      if (clock > std::get<0>(new_pack))
+      // Chunks are completed in the order of the element. Their halo only
+      // depends on previous chunks, already sent by this slave or awaited
+      // from another one.
+      std::vector<std::vector<T>> sent(halos.size());
+      std::vector<MPI_Request> sends;
+      for (size_t c = 0; c < halos.size(); ++c)
       {
-        std::memcpy(&var[0], data, data_size);
-        setPack(clock, data_size, new_pack);
-        // A completed flush has been done,
-        // we can reset the history.
-        if ((size_t)data_size == var.capacity()) setPack(0, 0, old_pack);
+        const size_t len = results[c].size();
+        size_t lo = h;
+        if (recvs[c] != MPI_REQUEST_NULL)
+        {
+          MPI_Status status;
+          MPI_Wait(&recvs[c], &status);
+          int bytes = 0;
+          MPI_Get_count(&status, MPI_BYTE, &bytes);
+          lo = h - bytes / sizeof(T);
+          std::copy(lefts[c].begin(), lefts[c].begin() + (h - lo),
+                    values[c].begin() + lo);
+        }
+        rollValues<T>(&values[c][0], lo, h, h + std::min(h, len), window,
+                      kind, &results[c][0]);
+
+        if (halos[c].right && h)
+        {
+          const size_t nb_sent = std::min(h, h + len - lo);
+          sent[c].assign(values[c].end() - nb_sent, values[c].end());
+          sends.emplace_back();
+          MPI_Isend(sent[c].data(), nb_sent * sizeof(T), MPI_BYTE,
+                    halos[c].right, haloTag(halos[c].index + 1, false),
+                    peer_comm, &sends.back());
+        }
+
+        auto& chunk = memory.fetch(std::string(halos[c].dst_id), true);
+        std::memcpy(chunk.data(), &results[c][0], len * sizeof(T));
       }
-      else if (data_size > std::get<1>(old_pack) ||
-               clock > std::get<0>(old_pack))
+      if (sends.size())
+        MPI_Waitall(sends.size(), &sends[0], MPI_STATUSES_IGNORE);
+    }
+
+    void
+    onRolling(MPI_Status& status, Memory& memory)
+    {
+      std::vector<Halo> halos;
+      std::vector<uint8_t> params;
+      receiveHalo(status, TAGS::ROLLING, halos, params);
+
+      // Parameters lay out like this:
+      //  sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t)
+      // [...DataType...]   [.....KIND.....]   [....WINDOW....]
+      uint32_t header[2];
+      uint64_t window = 0;
+      std::memcpy(header, &params[0], sizeof(header));
+      std::memcpy(&window, &params[sizeof(header)], sizeof(uint64_t));
+
+      switch (header[0])
       {
-        const auto& start = std::get<1>(new_pack);
-        std::memcpy(&var[0] + start, data + start, data_size - start);
-        if (clock < std::get<0>(old_pack) || std::get<0>(old_pack) == 0)
-          setPack(clock, data_size, old_pack);
+        case DataType::USHORT:
+          rollChunks<unsigned short>(memory, halos, window, header[1]);
+          break;
+        case DataType::SHORT:
+          rollChunks<short>(memory, halos, window, header[1]);
+          break;
+        case DataType::UINT:
+          rollChunks<unsigned int>(memory, halos, window, header[1]);
+          break;
+        case DataType::INT:
+          rollChunks<int>(memory, halos, window, header[1]);
+          break;
+        case DataType::ULONG:
+          rollChunks<unsigned long>(memory, halos, window, header[1]);
+          break;
+        case DataType::LONG:
+          rollChunks<long>(memory, halos, window, header[1]);
+          break;
+        case DataType::FLOAT:
+          rollChunks<float>(memory, halos, window, header[1]);
+          break;
+        case DataType::DOUBLE:
+          rollChunks<double>(memory, halos, window, header[1]);
+          break;
       }
 
       // Sends an acknowledge to the master.
-      message::send<uint8_t>(&constant::SUCCESS, 1, 0, TAGS::WRITE, req);
+      message::send_sync<uint8_t>(&constant::SUCCESS, 1, 0, TAGS::ROLLING);
+    }
 
-      delete[] data;
+    /**
+     * @brief Retrieve a request sent by `sendMatrix`.
+     *
+     * @param status Status of the probed message.
+     * @param blocks Filled with the chunks of the matrix on the slave.
+     * @param params Filled with the parameters of the operation.
+     * @param rows Filled with the values attached to the rows of the
+     * chunks, in the order of the chunks.
+     */
+    void
+    receiveBlocks(MPI_Status& status, std::vector<MatrixBlock>& blocks,
+                  std::vector<uint8_t>& params, std::vector<uint8_t>& rows)
+    {
+      // The request lays out like this:
+      //  sizeof (uint64_t)   N * sizeof (MatrixBlock)   sizeof (uint64_t)
+      // [.......N.......]    [........Chunks........]   [.......P.......]
+      //       P                 R
+      // [..Params..]   [..Rows values..]
+      uint8_t* request = nullptr;
+      int bytes = 0;
+      message::rec_sync<uint8_t>(0, status.MPI_TAG, status, &bytes, &request);
+
+      uint64_t nb_blocks = 0;
+      uint64_t nb_params = 0;
+      std::memcpy(&nb_blocks, request, sizeof(uint64_t));
+      blocks.resize(nb_blocks);
+      const size_t blocks_len = nb_blocks * sizeof(MatrixBlock);
+      std::memcpy(&blocks[0], request + sizeof(uint64_t), blocks_len);
+
+      const uint8_t* p = request + sizeof(uint64_t) + blocks_len;
+      std::memcpy(&nb_params, p, sizeof(uint64_t));
+      p += sizeof(uint64_t);
+      params.assign(p, p + nb_params);
+      rows.assign(p + nb_params, (const uint8_t*)request + bytes);
+      delete[] request;
     }
 
+    /**
+     * @brief Multiply rows by a vector. Every row is summed in independent
+     * lanes, which shortens the chain of dependent additions.
+     *
+     * @tparam T Type of element.
+     * @param mat Rows, one after the other.
+     * @param nb_rows Number of rows.
+     * @param nb_cols Number of values of a row.
+     * @param vec Vector of `nb_cols` values.
+     * @param out Receives one value per row.
+     */
+    template <typename T>
     void
-    onQuit(Memory& memory)
+    multiplyRows(const T* mat, size_t nb_rows, size_t nb_cols, const T* vec,
+                 T* out)
     {
-      memory.release();
-      MPI_Finalize();
-      std::exit(0);
+      static constexpr size_t LANES = 4;
+      for (size_t r = 0; r < nb_rows; ++r)
+      {
+        const T* row = mat + r * nb_cols;
+        T acc[LANES] = {0};
+        size_t c = 0;
+        for (; c + LANES <= nb_cols; c += LANES)
+        {
+          for (size_t j = 0; j < LANES; ++j) acc[j] += row[c + j] * vec[c + j];
+        }
+        for (size_t j = 0; c + j < nb_cols; ++j)
+          acc[j] += row[c + j] * vec[c + j];
+        out[r] = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+      }
     }
 
+    /**
+     * @brief Add the product of the transpose of rows by a vector. Rows
+     * are read in order, each one scaled into the accumulator.
+     *
+     * @tparam T Type of element.
+     * @param mat Rows, one after the other.
+     * @param nb_rows Number of rows.
+     * @param nb_cols Number of values of a row.
+     * @param vec Vector of `nb_rows` values.
+     * @param out Accumulator of `nb_cols` values.
+     */
+    template <typename T>
     void
-    onFree(MPI_Status& status, Memory& memory)
+    multiplyTransposed(const T* mat, size_t nb_rows, size_t nb_cols,
+                       const T* vec, T* out)
     {
-      // Gets back ID sent by the master.
-      char* id = nullptr;
-      message::rec_sync(0, TAGS::FREE, status, &id);
+      for (size_t r = 0; r < nb_rows; ++r)
+      {
+        const T* row = mat + r * nb_cols;
+        const T scale = vec[r];
+        for (size_t c = 0; c < nb_cols; ++c) out[c] += scale * row[c];
+      }
+    }
 
-      // Frees the memory associated to the `id' ID.
-      memory.release(std::string(id));
+    /**
+     * @brief Apply an operation on the chunks of a matrix held by the
+     * slave.
+     *
+     * @tparam T Type of element.
+     * @param tag Operation to apply.
+     * @param memory Memory of the slave.
+     * @param blocks Chunks of the matrix.
+     * @param params Parameters of the operation.
+     * @param rows Values attached to the rows of the chunks.
+     *
+     * @return Reply to the master: the partial sum of a transposed
+     * product, or an acknowledge.
+     */
+    template <typename T>
+    std::vector<uint8_t>
+    matrixBlocks(int tag, Memory& memory,
+                 const std::vector<MatrixBlock>& blocks,
+                 const std::vector<uint8_t>& params,
+                 const std::vector<uint8_t>& rows)
+    {
+      // Parameters start like this, followed by those of the operation:
+      //  sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t)
+      // [...DataType...]   [..CALLBACK_ID..]  [.....NB_COLS....]
+      uint32_t header[2];
+      uint64_t nb_cols = 0;
+      std::memcpy(header, &params[0], sizeof(header));
+      std::memcpy(&nb_cols, &params[sizeof(header)], sizeof(uint64_t));
+      const size_t offset = sizeof(header) + sizeof(uint64_t);
+      const T* vec = reinterpret_cast<const T*>(&params[0] + offset);
+      const T* row_values = reinterpret_cast<const T*>(rows.data());
 
-      delete[] id;
+      std::vector<T> partial((tag == TAGS::MATVEC_TRANSPOSED) ? nb_cols : 0);
+      for (const auto& block : blocks)
+      {
+        const auto& chunk = memory.fetch(std::string(block.src_id), true);
+        const T* values = reinterpret_cast<const T*>(chunk.data());
+        std::vector<T> result(block.nb_rows);
+        switch (tag)
+        {
+          case TAGS::MATVEC:
+            multiplyRows<T>(values, block.nb_rows, nb_cols, vec, &result[0]);
+            break;
+          case TAGS::MATVEC_TRANSPOSED:
+            multiplyTransposed<T>(values, block.nb_rows, nb_cols, row_values,
+                                  &partial[0]);
+            row_values += block.nb_rows;
+            break;
+          case TAGS::REDUCE_ROWS:
+            for (size_t r = 0; r < block.nb_rows; ++r)
+            {
+              result[r] = *vec;
+              applyReduce<T>(chunk.data() + r * nb_cols * sizeof(T),
+                             nb_cols * sizeof(T), header[1],
+                             reinterpret_cast<uint8_t*>(&result[r]));
+            }
+            break;
+        }
+        if (tag == TAGS::MATVEC_TRANSPOSED) continue;
+
+        // The result is written once computed, as fetching may move the
+        // chunk of the matrix.
+        auto& dst = memory.fetch(std::string(block.dst_id), true);
+        std::memcpy(dst.data(), &result[0], block.nb_rows * sizeof(T));
+      }
+
+      if (tag != TAGS::MATVEC_TRANSPOSED)
+        return std::vector<uint8_t>(1, constant::SUCCESS);
+
+      const auto* bytes = reinterpret_cast<const uint8_t*>(partial.data());
+      return std::vector<uint8_t>(bytes, bytes + nb_cols * sizeof(T));
+    }
+
+    void
+    onMatrix(MPI_Status& status, Memory& memory)
+    {
+      const int tag = status.MPI_TAG;
+      std::vector<MatrixBlock> blocks;
+      std::vector<uint8_t> params;
+      std::vector<uint8_t> rows;
+      receiveBlocks(status, blocks, params, rows);
+
+      uint32_t data_type = 0;
+      std::memcpy(&data_type, &params[0], sizeof(uint32_t));
+      std::vector<uint8_t> reply(1, constant::FAIL);
+      switch (data_type)
+      {
+        case DataType::USHORT:
+          reply = matrixBlocks<unsigned short>(tag, memory, blocks, params,
+                                               rows);
+          break;
+        case DataType::SHORT:
+          reply = matrixBlocks<short>(tag, memory, blocks, params, rows);
+          break;
+        case DataType::UINT:
+          reply = matrixBlocks<unsigned int>(tag, memory, blocks, params,
+                                             rows);
+          break;
+        case DataType::INT:
+          reply = matrixBlocks<int>(tag, memory, blocks, params, rows);
+          break;
+        case DataType::ULONG:
+          reply = matrixBlocks<unsigned long>(tag, memory, blocks, params,
+                                              rows);
+          break;
+        case DataType::LONG:
+          reply = matrixBlocks<long>(tag, memory, blocks, params, rows);
+          break;
+        case DataType::FLOAT:
+          reply = matrixBlocks<float>(tag, memory, blocks, params, rows);
+          break;
+        case DataType::DOUBLE:
+          reply = matrixBlocks<double>(tag, memory, blocks, params, rows);
+          break;
+      }
+
+      message::send_sync<uint8_t>(&reply[0], reply.size(), 0, tag);
     }
 
     void
@@ -154,41 +2618,59 @@ namespace algorep
       size_t sep2 = data.find('-', sep + 1);
       std::string id = data.substr(0, sep);
 
+      // The column of a field may follow: id-callback-type-column-record.
+      char* end = nullptr;
       unsigned int callback_id = strtol(data_cstr + sep + 1, NULL, 10);
-      unsigned int data_type = strtol(data_cstr + sep2 + 1, NULL, 10);
+      unsigned int data_type = strtol(data_cstr + sep2 + 1, &end, 10);
+      size_t column = 0;
+      size_t record_size = 0;
+      if (*end == '-')
+      {
+        column = strtoul(end + 1, &end, 10);
+        record_size = strtoul(end + 1, NULL, 10);
+      }
 
-      size_t nb_elt = memory.get(id).capacity();
-      auto* var_data = &memory.get(id)[0];
+      auto& chunk = memory.fetch(id, true);
+      size_t offset = 0;
+      size_t nb_elt = getColumn(chunk.size(), column,
+                                DataTypeToSize[data_type], record_size, offset);
+      auto* var_data = &chunk[0] + offset;
+      bool sparse = memory.isSparse(id);
+      bool success = true;
       switch (data_type)
       {
         case DataType::USHORT:
-          applyCallback<unsigned short>(var_data, nb_elt, callback_id);
+          success = mapChunk<unsigned short>(var_data, nb_elt, sparse,
+                                             callback_id);
           break;
         case DataType::SHORT:
-          applyCallback<short>(var_data, nb_elt, callback_id);
+          success = mapChunk<short>(var_data, nb_elt, sparse, callback_id);
           break;
         case DataType::UINT:
-          applyCallback<unsigned int>(var_data, nb_elt, callback_id);
+          success = mapChunk<unsigned int>(var_data, nb_elt, sparse,
+                                           callback_id);
           break;
         case DataType::INT:
-          applyCallback<int>(var_data, nb_elt, callback_id);
+          success = mapChunk<int>(var_data, nb_elt, sparse, callback_id);
           break;
         case DataType::ULONG:
-          applyCallback<unsigned long>(var_data, nb_elt, callback_id);
+          success = mapChunk<unsigned long>(var_data, nb_elt, sparse,
+                                            callback_id);
           break;
         case DataType::LONG:
-          applyCallback<long>(var_data, nb_elt, callback_id);
+          success = mapChunk<long>(var_data, nb_elt, sparse, callback_id);
           break;
         case DataType::FLOAT:
-          applyCallback<float>(var_data, nb_elt, callback_id);
+          success = mapChunk<float>(var_data, nb_elt, sparse, callback_id);
           break;
         case DataType::DOUBLE:
-          applyCallback<double>(var_data, nb_elt, callback_id);
+          success = mapChunk<double>(var_data, nb_elt, sparse, callback_id);
           break;
       }
 
       // Sends an acknowledge to the master.
-      message::send_sync<uint8_t>(&constant::SUCCESS, 1, 0, TAGS::MAP);
+      message::send_sync<uint8_t>(
+          (success) ? &constant::SUCCESS : &constant::FAIL, 1, 0, TAGS::MAP);
       delete[] data_cstr;
     }
   }
@@ -197,51 +2679,61 @@ namespace algorep
   onReduce(MPI_Status& status, Memory& memory)
   {
     static constexpr unsigned int UINT_LEN = sizeof(unsigned int);
+    static constexpr unsigned int DATA_LEN = 4 * UINT_LEN + 64;
     // Sends the data with this layout:
-    //  64 bytes       sizeof (uint)      sizeof (uint)        N
-    // [ACCUMULATOR] [...DATA_TYPE...] [...CALLBACK_ID...]  [nodes]
+    //  64 bytes       sizeof (uint)      sizeof (uint)      2 * sizeof (uint)
+    // [ACCUMULATOR] [...DATA_TYPE...] [...CALLBACK_ID...] [COLUMN, RECORD]
+    //   N
+    // [nodes]
     uint8_t* data = nullptr;
     int bytes = 0;
     message::rec_sync<uint8_t>(status.MPI_SOURCE, TAGS::REDUCE, status, &bytes,
                                &data);
 
-    std::string nodes_list((char*)(data + 64 + UINT_LEN * 2));
+    std::string nodes_list((char*)(data + DATA_LEN));
     std::string curr_id = nodes_list;
     size_t sep = nodes_list.find('-');
     if (sep != std::string::npos) curr_id = curr_id.substr(0, sep);
 
-    auto& vec = memory.get(curr_id);
-    auto* var_data = &vec[0];
-    size_t nb_elt = vec.capacity();
     unsigned int data_type = *((unsigned int*)(data + 64));
     unsigned int call_id = *((unsigned int*)(data + 64 + UINT_LEN));
+    unsigned int column = *((unsigned int*)(data + 64 + UINT_LEN * 2));
+    unsigned int record_size = *((unsigned int*)(data + 64 + UINT_LEN * 3));
+
+    auto& vec = memory.fetch(curr_id, true);
+    size_t offset = 0;
+    size_t nb_elt = getColumn(vec.size(), column, DataTypeToSize[data_type],
+                              record_size, offset);
+    auto* var_data = &vec[0] + offset;
+    size_t nb_values = 0;
+    if (memory.isSparse(curr_id)) nb_values = memory.getSparseSize(curr_id);
 
     size_t nb_bytes_type = DataTypeToSize[data_type];
     switch (data_type)
     {
       case DataType::USHORT:
-        applyReduce<unsigned short>(var_data, nb_elt, call_id, data);
+        reduceChunk<unsigned short>(var_data, nb_elt, nb_values, call_id, data);
         break;
       case DataType::SHORT:
-        applyReduce<short>(var_data, nb_elt, call_id, data);
+        reduceChunk<short>(var_data, nb_elt, nb_values, call_id, data);
         break;
       case DataType::UINT:
-        applyReduce<unsigned int>(var_data, nb_elt, call_id, data);
+        reduceChunk<unsigned int>(var_data, nb_elt, nb_values, call_id, data);
         break;
       case DataType::INT:
-        applyReduce<int>(var_data, nb_elt, call_id, data);
+        reduceChunk<int>(var_data, nb_elt, nb_values, call_id, data);
         break;
       case DataType::ULONG:
-        applyReduce<unsigned long>(var_data, nb_elt, call_id, data);
+        reduceChunk<unsigned long>(var_data, nb_elt, nb_values, call_id, data);
         break;
       case DataType::LONG:
-        applyReduce<long>(var_data, nb_elt, call_id, data);
+        reduceChunk<long>(var_data, nb_elt, nb_values, call_id, data);
         break;
       case DataType::FLOAT:
-        applyReduce<float>(var_data, nb_elt, call_id, data);
+        reduceChunk<float>(var_data, nb_elt, nb_values, call_id, data);
         break;
       case DataType::DOUBLE:
-        applyReduce<double>(var_data, nb_elt, call_id, data);
+        reduceChunk<double>(var_data, nb_elt, nb_values, call_id, data);
         break;
     }
 
@@ -261,10 +2753,10 @@ namespace algorep
     int next_dest = strtol(cstr, NULL, 10);
 
     size_t nb_bytes = nodes_list.length() - sep;
-    std::memcpy(data + 64 + UINT_LEN * 2, cstr, nb_bytes);
+    std::memcpy(data + DATA_LEN, cstr, nb_bytes);
 
     // Sends the message to the next node of the chain.
-    message::send_sync<uint8_t>(data, 64 + UINT_LEN * 2 + nb_bytes, next_dest,
+    message::send_sync<uint8_t>(data, DATA_LEN + nb_bytes, next_dest,
                                 TAGS::REDUCE);
 
     delete[] data;
@@ -274,6 +2766,7 @@ namespace algorep
   init(int argc, char** argv)
   {
     MPI_Init(&argc, &argv);
+    MPI_Comm_dup(MPI_COMM_WORLD, &peer_comm);
   }
 
   void
@@ -299,7 +2792,7 @@ namespace algorep
 
     if (rank == 0) return callback();
 
-    Memory memory;
+    Memory memory(max_memory);
     MPI_Status status;
 
     while (true)
@@ -326,6 +2819,94 @@ namespace algorep
         case TAGS::REDUCE:
           onReduce(status, memory);
           break;
+        case TAGS::ALLOCATION_FILL:
+          onAllocationFill(status, memory, rank);
+          break;
+        case TAGS::GROW:
+          onGrow(status, memory);
+          break;
+        case TAGS::GATHER:
+        case TAGS::SCATTER:
+          onIndexed(status, memory, status.MPI_TAG);
+          break;
+        case TAGS::COPY:
+          onCopy(status, memory, rank);
+          break;
+        case TAGS::STATUS:
+          onStatus(memory);
+          break;
+        case TAGS::CONFIG:
+          onConfig(memory);
+          break;
+        case TAGS::ALLOCATION_FILE:
+          onAllocationFile(status, memory, rank);
+          break;
+        case TAGS::FILE_WRITE:
+          onFileWrite(status, memory);
+          break;
+        case TAGS::CHECKPOINT:
+        case TAGS::RESTORE:
+          onCheckpoint(status, memory, rank, status.MPI_TAG);
+          break;
+        case TAGS::ALLOCATION_PACKED:
+          onAllocationPacked(status, memory, rank);
+          break;
+        case TAGS::ALLOCATION_SPARSE:
+          onAllocationSparse(status, memory, rank);
+          break;
+        case TAGS::READ_COLUMN:
+          onReadColumn(status, memory);
+          break;
+        case TAGS::DESCRIBE:
+          onDescribe(status, memory);
+          break;
+        case TAGS::TOP_K:
+          onTopK(status, memory);
+          break;
+        case TAGS::SKETCH:
+          onSketch(status, memory);
+          break;
+        case TAGS::DISTINCT:
+          onDistinct(status, memory);
+          break;
+        case TAGS::BLOOM:
+          onBloom(status, memory);
+          break;
+        case TAGS::FILTER:
+          onFilter(status, memory, rank);
+          break;
+        case TAGS::SUM:
+          onSum(status, memory);
+          break;
+        case TAGS::MAP_PARAM:
+          onMapParam(status, memory);
+          break;
+        case TAGS::STENCIL:
+          onStencil(status, memory);
+          break;
+        case TAGS::MATVEC:
+        case TAGS::MATVEC_TRANSPOSED:
+        case TAGS::REDUCE_ROWS:
+          onMatrix(status, memory);
+          break;
+        case TAGS::ROLLING:
+          onRolling(status, memory);
+          break;
+        case TAGS::TABLE_PUT:
+        case TAGS::TABLE_GET:
+        case TAGS::TABLE_ERASE:
+          onTable(status, memory);
+          break;
+        case TAGS::ZONE_MAP:
+        case TAGS::RANGE:
+          onRange(status, memory);
+          break;
+        case TAGS::READ_PACKED:
+          onReadPacked(status, memory);
+          break;
+        case TAGS::WRITE_PACKED:
+          onWritePacked(status, memory);
+          break;
         case TAGS::QUIT:
           onQuit(memory);
           break;
@@ -1,4 +1,15 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <data/allocator.h>
+#include <data/checkpoint.h>
+#include <data/codec.h>
+#include <data/file.h>
 
 namespace algorep
 {
@@ -7,12 +18,19 @@ namespace algorep
   void
   Allocator::free(BaseElement* elt)
   {
+    // The memory is owned by another element.
+    if (elt->isView())
+    {
+      delete elt;
+      return;
+    }
+    this->elements_.erase(elt);
+
     const auto& ids = elt->getIds();
     const auto& bounds = elt->getBounds();
 
     for (size_t i = 0; i < ids.size(); ++i)
     {
-      const auto& id = ids[i];
       const auto& bound = bounds[i];
 
       // int dest = getRankFromId(id);
@@ -20,17 +38,1880 @@ namespace algorep
       const auto& lower = std::get<0>(bound);
       const auto& upper = std::get<1>(bound);
 
-      // Asks the `dest' slave for a write.
-      // This function will return as soon as the `pair.first'
-      // string is copied, this will not wait until the receiver
-      // acknowledge it, which is exactly what we want.
-      message::send_sync(id, dest, TAGS::FREE);
-
-      // We basically consider that every message will arrive one day.
-      // We can safely consider the memory as freed.
       size_t bytes = elt->getAtomSize() * (upper - lower + 1);
       this->memory_per_node_[dest - 1] += bytes;
     }
+
+    // The last chunk may have been reserved larger than its size.
+    if (ids.size())
+    {
+      const auto& last = bounds.back();
+      size_t size = std::get<1>(last) - std::get<0>(last) + 1;
+      size_t spare = elt->getCapacity() - size;
+      this->memory_per_node_[elt->getIntIds().back() - 1] +=
+          spare * elt->getAtomSize();
+    }
+    this->release(ids, elt->getIntIds());
+
     delete elt;
   }
+
+  void
+  Allocator::release(const std::vector<std::string>& ids,
+                     const std::vector<int>& nodes)
+  {
+    // Every message is sent before waiting for the replies, so that
+    // slaves free their chunks at the same time.
+    std::vector<MPI_Request> reqs(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+      message::send(ids[i], nodes[i], TAGS::FREE, reqs[i]);
+
+    for (size_t i = 0; i < ids.size(); ++i)
+      this->receiveStatus(nodes[i], TAGS::FREE);
+
+    if (reqs.size()) MPI_Waitall(reqs.size(), &reqs[0], MPI_STATUSES_IGNORE);
+  }
+
+  const std::vector<NodeStatus>&
+  Allocator::queryMemoryStatus()
+  {
+    for (int node = 1; node <= this->nb_nodes_; ++node)
+      message::send_sync<uint8_t>(nullptr, 0, node, TAGS::STATUS);
+
+    for (int node = 1; node <= this->nb_nodes_; ++node)
+      this->receiveStatus(node, TAGS::STATUS);
+
+    return this->status_per_node_;
+  }
+
+  bool
+  Allocator::configureSpill(const std::string& dir, size_t disk_bytes)
+  {
+    if (dir.length() >= constant::PATH_LEN) return false;
+
+    NodeConfig config = this->config_;
+    config.disk_budget = disk_bytes;
+    std::memset(config.scratch_dir, 0, constant::PATH_LEN);
+    std::memcpy(config.scratch_dir, dir.c_str(), dir.length());
+
+    // Slaves that applied the settings are restored.
+    if (!this->sendConfig(config))
+    {
+      this->sendConfig(this->config_);
+      return false;
+    }
+
+    // The disk budget is seen as memory by the placement.
+    for (auto& available : this->memory_per_node_)
+    {
+      available += disk_bytes;
+      available -= std::min<unsigned long long>(available,
+                                                this->config_.disk_budget);
+    }
+    this->config_ = config;
+
+    return true;
+  }
+
+  bool
+  Allocator::sendConfig(const NodeConfig& config)
+  {
+    for (int node = 1; node <= this->nb_nodes_; ++node)
+      message::send_sync<NodeConfig>(&config, sizeof(NodeConfig), node,
+                                     TAGS::CONFIG);
+
+    bool success = true;
+    for (int node = 1; node <= this->nb_nodes_; ++node)
+    {
+      const auto& status = this->receiveStatus(node, TAGS::CONFIG);
+      success = success && (status.status == constant::SUCCESS);
+    }
+
+    return success;
+  }
+
+  NodeStatus
+  Allocator::receiveStatus(int node, int tag, std::string* id)
+  {
+    // Receives the data with this layout:
+    //  sizeof (NodeStatus)    N
+    // [.....STATUS.....]   [.ID.]
+    uint8_t* reply = nullptr;
+    message::rec_sync<uint8_t>(node, tag, &reply);
+
+    NodeStatus status;
+    std::memcpy(&status, reply, sizeof(NodeStatus));
+    if (id && status.status == constant::SUCCESS)
+      *id = std::string(reinterpret_cast<char*>(reply) + sizeof(NodeStatus));
+    delete[] reply;
+
+    this->update(node, status);
+
+    return status;
+  }
+
+  void
+  Allocator::update(int node, const NodeStatus& status)
+  {
+    this->status_per_node_[node - 1] = status;
+
+    const size_t max_memory = this->max_memory_ + this->config_.disk_budget;
+    unsigned long long available = 0;
+    if (status.used < max_memory) available = max_memory - status.used;
+
+    auto& estimate = this->memory_per_node_[node - 1];
+    estimate = std::min(estimate, available);
+  }
+
+  bool
+  Allocator::sendIndexed(const BaseElement* elt,
+                         const std::vector<size_t>& indices,
+                         const uint8_t* values, int tag,
+                         std::vector<int>& dests,
+                         std::vector<std::vector<size_t>>& order)
+  {
+    if (!elt->isDense()) return false;
+
+    const unsigned int atom_size = elt->getAtomSize();
+    const auto& ids = elt->getIds();
+    const auto& bounds = elt->getBounds();
+
+    // Groups the positions of the indices by node, and then by chunk,
+    // using a binary search over the bounds of the element.
+    std::map<int, std::map<size_t, std::vector<size_t>>> groups;
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      size_t chunk = elt->findChunk(indices[i]);
+      if (chunk == bounds.size()) return false;
+
+      groups[elt->getIntIds()[chunk]][chunk].push_back(i);
+    }
+
+    // Sends the data with this layout:
+    //  sizeof (uint)  sizeof (size_t)
+    // [.ATOM_SIZE.]  [.NB_SECTIONS.]
+    // followed by each section:
+    //  22 bytes   sizeof (size_t)    N * sizeof (size_t)  N * ATOM_SIZE
+    // [...ID...]  [...COUNT...]      [...INDICES...]      [...VALUES...]
+    // Values are only sent for a store.
+    static constexpr size_t HEADER_LEN = sizeof(unsigned int) + sizeof(size_t);
+    static constexpr size_t SECTION_LEN = constant::ID_LEN + sizeof(size_t);
+    size_t value_size = (values) ? atom_size : 0;
+
+    std::vector<std::vector<uint8_t>> messages(groups.size());
+    std::vector<MPI_Request> reqs(groups.size());
+    size_t m = 0;
+    for (const auto& group : groups)
+    {
+      size_t nb_sections = group.second.size();
+      size_t nb_bytes = HEADER_LEN + nb_sections * SECTION_LEN;
+      for (const auto& section : group.second)
+        nb_bytes += section.second.size() * (sizeof(size_t) + value_size);
+
+      auto& data = messages[m];
+      data.resize(nb_bytes, 0);
+      std::memcpy(&data[0], &atom_size, sizeof(unsigned int));
+      std::memcpy(&data[0] + sizeof(unsigned int), &nb_sections,
+                  sizeof(size_t));
+
+      dests.push_back(group.first);
+      order.emplace_back();
+      uint8_t* ptr = &data[0] + HEADER_LEN;
+      for (const auto& section : group.second)
+      {
+        const auto& id = ids[section.first];
+        const auto& positions = section.second;
+        const size_t lower = std::get<0>(bounds[section.first]);
+        const size_t count = positions.size();
+
+        std::memcpy(ptr, id.c_str(), id.length());
+        std::memcpy(ptr + constant::ID_LEN, &count, sizeof(size_t));
+        ptr += SECTION_LEN;
+
+        // Indices are sent relatively to the start of the chunk.
+        for (size_t i = 0; i < count; ++i)
+        {
+          size_t local = indices[positions[i]] - lower;
+          std::memcpy(ptr + i * sizeof(size_t), &local, sizeof(size_t));
+        }
+        ptr += count * sizeof(size_t);
+
+        for (size_t i = 0; i < count && values; ++i)
+          std::memcpy(ptr + i * atom_size, values + positions[i] * atom_size,
+                      atom_size);
+        ptr += count * value_size;
+
+        order.back().insert(order.back().end(), positions.begin(),
+                            positions.end());
+      }
+
+      message::send<uint8_t>(&data[0], data.size(), group.first, tag,
+                             reqs[m]);
+      ++m;
+    }
+
+    if (reqs.size()) MPI_Waitall(reqs.size(), &reqs[0], MPI_STATUSES_IGNORE);
+
+    return true;
+  }
+
+  bool
+  Allocator::repartition(BaseElement* elt, Layout layout)
+  {
+    if (elt->isView() || !elt->isDense()) return false;
+
+    const size_t atom_size = elt->getAtomSize();
+    const auto& nodes = this->plan(elt->getNbValues(), atom_size, layout);
+    if (nodes.size() == 0) return false;
+
+    // The new chunks are allocated without sending any data,
+    // slaves then fill them from the old ones.
+    auto* moved = new BaseElement(elt->getNbValues(), atom_size);
+    this->sendFill(nodes, atom_size, nullptr);
+    if (!this->track(nodes, moved))
+    {
+      delete moved;
+      return false;
+    }
+
+    // On success, `moved' takes the old chunks, which are then freed.
+    bool success = this->transfer(elt, moved);
+    if (success) elt->swapChunks(*moved);
+    this->free(moved);
+
+    return success;
+  }
+
+  bool
+  Allocator::checkpoint(const std::string& dir)
+  {
+    using namespace checkpoint;
+
+    // Nothing is written if an element can not be restored.
+    for (const auto& pair : this->elements_)
+    {
+      if (!pair.first->isCheckpointable()) return false;
+    }
+
+    // The directory may already exist.
+    mkdir(dir.c_str(), 0755);
+    for (int node = 1; node <= this->nb_nodes_; ++node)
+      message::send_sync(dir, node, TAGS::CHECKPOINT);
+
+    // Elements are saved in their order of allocation, while the slaves
+    // write their chunks.
+    std::vector<std::pair<unsigned long long, const BaseElement*>> elements;
+    for (const auto& pair : this->elements_)
+      elements.emplace_back(pair.second, pair.first);
+    std::sort(elements.begin(), elements.end());
+
+    std::ofstream out(getPath(dir, 0), std::ios::binary | std::ios::trunc);
+    MasterHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.nb_nodes = this->nb_nodes_;
+    header.clock = this->clock_;
+    header.nb_elements = elements.size();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(MasterHeader));
+
+    for (const auto& pair : elements)
+    {
+      const auto* elt = pair.second;
+      ElementRecord record;
+      record.nb_values = elt->getNbValues();
+      record.capacity = elt->getCapacity();
+      record.atom_size = elt->getAtomSize();
+      record.nb_chunks = elt->getIds().size();
+      record.storage = elt->getStorage();
+      out.write(reinterpret_cast<const char*>(&record), sizeof(ElementRecord));
+
+      for (size_t i = 0; i < record.nb_chunks; ++i)
+      {
+        BoundRecord bound;
+        std::memset(&bound, 0, sizeof(BoundRecord));
+        const auto& id = elt->getIds()[i];
+        std::memcpy(bound.id, id.c_str(), id.length());
+        bound.lower = std::get<0>(elt->getBounds()[i]);
+        bound.upper = std::get<1>(elt->getBounds()[i]);
+        out.write(reinterpret_cast<const char*>(&bound), sizeof(BoundRecord));
+      }
+    }
+    bool success = !!out;
+
+    for (int node = 1; node <= this->nb_nodes_; ++node)
+    {
+      const auto& status = this->receiveStatus(node, TAGS::CHECKPOINT);
+      success = success && (status.status == constant::SUCCESS);
+    }
+
+    return success;
+  }
+
+  std::vector<BaseElement*>
+  Allocator::restore(const std::string& dir)
+  {
+    using namespace checkpoint;
+
+    std::vector<BaseElement*> result;
+    if (this->elements_.size()) return result;
+
+    // The metadata are read first, nothing is sent to the slaves if
+    // they are not valid.
+    std::ifstream in(getPath(dir, 0), std::ios::binary);
+    MasterHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(MasterHeader));
+    if (!in || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.nb_nodes != (uint64_t)this->nb_nodes_)
+      return result;
+
+    for (size_t e = 0; in && e < header.nb_elements; ++e)
+    {
+      ElementRecord record;
+      in.read(reinterpret_cast<char*>(&record), sizeof(ElementRecord));
+      if (!in) break;
+      if (record.storage != Storage::DENSE)
+      {
+        in.setstate(std::ios::failbit);
+        break;
+      }
+
+      auto* elt = new BaseElement(record.nb_values, record.atom_size, false,
+                                  (Storage)record.storage);
+      result.push_back(elt);
+      for (size_t i = 0; in && i < record.nb_chunks; ++i)
+      {
+        BoundRecord bound;
+        in.read(reinterpret_cast<char*>(&bound), sizeof(BoundRecord));
+        bound.id[constant::ID_LEN - 1] = '\0';
+        elt->addId(std::string(bound.id),
+                   std::make_tuple(bound.lower, bound.upper));
+      }
+      elt->setCapacity(record.capacity);
+    }
+    if (!in)
+    {
+      for (auto* elt : result) delete elt;
+      return std::vector<BaseElement*>();
+    }
+
+    for (int node = 1; node <= this->nb_nodes_; ++node)
+      message::send_sync(dir, node, TAGS::RESTORE);
+
+    std::vector<bool> restored(this->nb_nodes_ + 1, false);
+    bool success = true;
+    for (int node = 1; node <= this->nb_nodes_; ++node)
+    {
+      const auto& status = this->receiveStatus(node, TAGS::RESTORE);
+      restored[node] = (status.status == constant::SUCCESS);
+      success = success && restored[node];
+    }
+
+    // Chunks restored on the other slaves are freed.
+    if (!success)
+    {
+      std::vector<std::string> ids;
+      std::vector<int> nodes;
+      for (auto* elt : result)
+      {
+        for (size_t i = 0; i < elt->getIds().size(); ++i)
+        {
+          if (!restored[elt->getIntIds()[i]]) continue;
+          ids.push_back(elt->getIds()[i]);
+          nodes.push_back(elt->getIntIds()[i]);
+        }
+        delete elt;
+      }
+      this->release(ids, nodes);
+      result.clear();
+    }
+    else
+    {
+      for (auto* elt : result)
+        this->elements_.emplace(elt, this->nb_tracked_++);
+      // New writes have to be seen as newer than the restored history.
+      this->clock_ = std::max(this->clock_, (size_t)header.clock);
+    }
+
+    // No other element exists, the usage of the slaves is exact.
+    const size_t max_memory = this->max_memory_ + this->config_.disk_budget;
+    for (int i = 0; i < this->nb_nodes_; ++i)
+    {
+      const size_t used = this->status_per_node_[i].used;
+      this->memory_per_node_[i] = (used < max_memory) ? max_memory - used : 0;
+    }
+
+    return result;
+  }
+
+  size_t
+  Allocator::rebalance()
+  {
+    // Elements split in the most chunks are handled first, they are
+    // the ones slowing down every operation.
+    std::vector<BaseElement*> elements;
+    for (const auto& pair : this->elements_) elements.push_back(pair.first);
+    std::sort(elements.begin(), elements.end(),
+              [](const BaseElement* a, const BaseElement* b) {
+                return a->getIds().size() > b->getIds().size();
+              });
+
+    size_t nb_moved = 0;
+    for (auto* elt : elements)
+    {
+      const size_t nb_chunks = elt->getIds().size();
+      if (nb_chunks < 2 || !elt->isDense()) continue;
+
+      const auto& nodes =
+          this->plan(elt->getNbValues(), elt->getAtomSize(), Layout::FEWEST);
+      if (nodes.size() == 0 || nodes.size() >= nb_chunks) continue;
+
+      nb_moved += this->repartition(elt, Layout::FEWEST);
+    }
+
+    return nb_moved;
+  }
+
+  bool
+  Allocator::transfer(const BaseElement* src, const BaseElement* dst)
+  {
+    // MPI only guarantees tags up to this value.
+    static constexpr int MAX_TAG = 32767;
+
+    const size_t atom_size = src->getAtomSize();
+    if (!src->isDense() || !dst->isDense()) return false;
+    if (atom_size != dst->getAtomSize()) return false;
+    if (src->getNbValues() > dst->getNbValues()) return false;
+
+    const auto& src_bounds = src->getBounds();
+    const auto& dst_bounds = dst->getBounds();
+
+    // Sweeps both layouts at once, a fragment is cut at each bound
+    // of one of the two elements.
+    std::map<int, std::vector<Transfer>> per_node;
+    size_t i = 0;
+    size_t j = 0;
+    size_t idx = 0;
+    int tag = 0;
+    while (idx < src->getNbValues())
+    {
+      const auto& src_bound = src_bounds[i];
+      const auto& dst_bound = dst_bounds[j];
+      size_t end = std::min(std::get<1>(src_bound), std::get<1>(dst_bound));
+
+      Transfer t;
+      std::memset(&t, 0, sizeof(Transfer));
+      t.src = src->getIntIds()[i];
+      t.dst = dst->getIntIds()[j];
+      t.tag = tag++ % MAX_TAG;
+      std::memcpy(t.src_id, src->getIds()[i].c_str(), src->getIds()[i].size());
+      std::memcpy(t.dst_id, dst->getIds()[j].c_str(), dst->getIds()[j].size());
+      t.src_offset = (idx - std::get<0>(src_bound)) * atom_size;
+      t.dst_offset = (idx - std::get<0>(dst_bound)) * atom_size;
+      t.nb_bytes = (end - idx + 1) * atom_size;
+
+      per_node[t.src].push_back(t);
+      if (t.dst != t.src) per_node[t.dst].push_back(t);
+
+      idx = end + 1;
+      if (idx > std::get<1>(src_bound)) ++i;
+      if (idx > std::get<1>(dst_bound)) ++j;
+    }
+
+    // Each node involved receives the list of fragments it sends
+    // and receives. Transfers are given in the same order to the
+    // sender and the receiver, so that messages always match.
+    std::vector<MPI_Request> reqs(per_node.size());
+    size_t m = 0;
+    for (const auto& node : per_node)
+    {
+      const auto& transfers = node.second;
+      message::send<Transfer>(&transfers[0],
+                              transfers.size() * sizeof(Transfer), node.first,
+                              TAGS::COPY, reqs[m++]);
+    }
+    if (reqs.size()) MPI_Waitall(reqs.size(), &reqs[0], MPI_STATUSES_IGNORE);
+
+    bool success = true;
+    for (const auto& node : per_node)
+    {
+      uint8_t status = 0;
+      message::rec_sync_ack(node.first, TAGS::COPY, status);
+      success = success && (status == constant::SUCCESS);
+    }
+
+    return success;
+  }
+
+  bool
+  Allocator::grow(BaseElement* elt, const uint8_t* data, size_t nb_elts)
+  {
+    const size_t atom_size = elt->getAtomSize();
+
+    // First, we try to grow the last chunk in place. Its capacity
+    // is doubled, as long as the node has enough memory left.
+    int last_dest = 0;
+    size_t last_size = 0;
+    size_t old_capacity = elt->getCapacity();
+    size_t capacity = old_capacity;
+    if (elt->getIds().size())
+    {
+      const auto& bound = elt->getBounds().back();
+      last_dest = elt->getIntIds().back();
+      last_size = std::get<1>(bound) - std::get<0>(bound) + 1;
+
+      if (last_size + nb_elts > capacity)
+      {
+        size_t wanted = std::max(last_size + nb_elts, 2 * capacity);
+        size_t available = this->memory_per_node_[last_dest - 1] / atom_size;
+        capacity = std::min(wanted, capacity + available);
+      }
+      this->memory_per_node_[last_dest - 1] -=
+          (capacity - old_capacity) * atom_size;
+    }
+    size_t in_place = std::min(nb_elts, capacity - last_size);
+    size_t remaining = nb_elts - in_place;
+
+    // The remaining elements are spilled in new chunks, placed with
+    // a capacity large enough to double the size of the element.
+    std::vector<Placement> nodes;
+    if (remaining)
+    {
+      size_t wanted = std::max(remaining, elt->getNbValues() + in_place);
+      nodes = this->plan(wanted, atom_size);
+      if (nodes.size() == 0) nodes = this->plan(remaining, atom_size);
+
+      // The network is full, we restore the state of the last chunk.
+      if (nodes.size() == 0)
+      {
+        if (last_dest)
+          this->memory_per_node_[last_dest - 1] +=
+              (capacity - old_capacity) * atom_size;
+        return false;
+      }
+    }
+
+    bool success = true;
+    if (last_dest && (in_place || capacity != old_capacity))
+    {
+      success = this->sendGrow(elt->getIds().back(), last_dest,
+                               (last_size + in_place) * atom_size,
+                               capacity * atom_size, data,
+                               (data) ? in_place * atom_size : 0);
+
+      // The slave could not grow the chunk, its state is unchanged.
+      if (!success)
+      {
+        this->memory_per_node_[last_dest - 1] +=
+            (capacity - old_capacity) * atom_size;
+        this->update(last_dest, this->status_per_node_[last_dest - 1]);
+        return false;
+      }
+      elt->setCapacity(capacity);
+      elt->resizeLast(last_size + in_place);
+    }
+    if (remaining == 0) return success;
+
+    // Only keeps the planned chunks receiving data. The spare capacity
+    // is kept on the last one.
+    const size_t start = elt->getNbValues();
+    size_t offset = 0;
+    size_t last_capacity = 0;
+    std::vector<Placement> used;
+    for (const auto& node : nodes)
+    {
+      if (offset == remaining) break;
+
+      last_capacity = std::get<2>(node) - std::get<1>(node) + 1;
+      size_t count = std::min(last_capacity, remaining - offset);
+      used.push_back(std::make_tuple(std::get<0>(node), start + offset,
+                                     start + offset + count - 1));
+      offset += count;
+    }
+
+    std::vector<MPI_Request> reqs;
+    if (data)
+    {
+      reqs.resize(used.size());
+      for (size_t i = 0; i < used.size(); ++i)
+      {
+        const auto& node = used[i];
+        const auto& lower = std::get<1>(node);
+        const auto& upper = std::get<2>(node);
+
+        const uint8_t* src = data + (in_place + lower - start) * atom_size;
+        size_t bytes = atom_size * (upper - lower + 1);
+        message::send<uint8_t>(src, bytes, std::get<0>(node),
+                               TAGS::ALLOCATION, reqs[i]);
+      }
+    }
+    else
+      this->sendFill(used, atom_size, nullptr, true);
+
+    // The spare capacity of the last chunk is booked before `track`, as
+    // the replies of the slaves may lower the estimate of their memory.
+    // Only the elements booked are recorded as capacity, so that `free`
+    // gives back exactly what was taken.
+    const auto& last = used.back();
+    const int last_node = std::get<0>(last);
+    const size_t last_count = std::get<2>(last) - std::get<1>(last) + 1;
+    const unsigned long long needed = last_count * atom_size;
+    auto& estimate = this->memory_per_node_[last_node - 1];
+    const size_t spare = std::min<unsigned long long>(
+        last_capacity - last_count,
+        (estimate > needed) ? (estimate - needed) / atom_size : 0);
+    estimate -= spare * atom_size;
+
+    bool tracked = this->track(used, elt);
+    if (reqs.size())
+      MPI_Waitall(reqs.size(), &reqs[0], MPI_STATUSES_IGNORE);
+    if (!tracked)
+    {
+      this->memory_per_node_[last_node - 1] += spare * atom_size;
+      this->update(last_node, this->status_per_node_[last_node - 1]);
+      return false;
+    }
+
+    elt->setCapacity(last_count + spare);
+    elt->setNbValues(start + remaining);
+
+    return success;
+  }
+
+  bool
+  Allocator::shrink(BaseElement* elt, size_t nb_elts)
+  {
+    const size_t atom_size = elt->getAtomSize();
+
+    // Frees every chunk placed after the new size.
+    std::vector<std::string> ids;
+    std::vector<int> nodes;
+    while (elt->getIds().size() &&
+           std::get<0>(elt->getBounds().back()) >= nb_elts)
+    {
+      ids.push_back(elt->getIds().back());
+      nodes.push_back(elt->getIntIds().back());
+
+      this->memory_per_node_[nodes.back() - 1] +=
+          elt->getCapacity() * atom_size;
+      elt->removeLast();
+    }
+    this->release(ids, nodes);
+
+    if (elt->getNbValues() == nb_elts) return true;
+
+    // The last chunk is truncated, but keeps its capacity.
+    const auto& bound = elt->getBounds().back();
+    size_t last_size = nb_elts - std::get<0>(bound);
+    bool success = this->sendGrow(elt->getIds().back(), elt->getIntIds().back(),
+                                  last_size * atom_size,
+                                  elt->getCapacity() * atom_size, nullptr, 0);
+    elt->resizeLast(last_size);
+
+    return success;
+  }
+
+  bool
+  Allocator::sendGrow(const std::string& id, int dest, size_t nb_bytes,
+                      size_t capacity, const uint8_t* data, size_t data_bytes)
+  {
+    static constexpr unsigned int HEADER_LEN =
+        constant::ID_LEN + 2 * sizeof(size_t);
+
+    // Sends the data with this layout:
+    //  22 bytes    sizeof (size_t)   sizeof (size_t)      N
+    // [...ID...]  [...NB_BYTES...]  [..CAPACITY..]   [...Data...]
+    std::vector<uint8_t> msg(HEADER_LEN + data_bytes, 0);
+    std::memcpy(&msg[0], id.c_str(), id.length());
+    std::memcpy(&msg[0] + constant::ID_LEN, &nb_bytes, sizeof(size_t));
+    std::memcpy(&msg[0] + constant::ID_LEN + sizeof(size_t), &capacity,
+                sizeof(size_t));
+    if (data_bytes) std::memcpy(&msg[0] + HEADER_LEN, data, data_bytes);
+
+    message::send_sync<uint8_t>(&msg[0], msg.size(), dest, TAGS::GROW);
+
+    return this->receiveStatus(dest, TAGS::GROW).status == constant::SUCCESS;
+  }
+
+  Element<uint8_t>*
+  Allocator::reserveBytes(size_t nb_bytes, size_t alignment)
+  {
+    if (alignment == 0) alignment = 1;
+
+    // Places blocks of `alignment' bytes, so that a chunk never
+    // starts in the middle of a block.
+    size_t nb_blocks = (nb_bytes + alignment - 1) / alignment;
+    auto nodes = this->plan(nb_blocks, alignment);
+    if (nodes.size() == 0) return nullptr;
+
+    for (auto& node : nodes)
+    {
+      std::get<1>(node) *= alignment;
+      std::get<2>(node) =
+          std::min((std::get<2>(node) + 1) * alignment, nb_bytes) - 1;
+    }
+
+    auto* result = new Element<uint8_t>(nb_bytes);
+    this->sendFill(nodes, sizeof(uint8_t), nullptr);
+    if (!this->track(nodes, result))
+    {
+      delete result;
+      return nullptr;
+    }
+
+    return result;
+  }
+
+  std::vector<Placement>
+  Allocator::plan(size_t nb_elements, size_t atom_size, Layout layout) const
+  {
+    std::vector<Placement> nodes;
+
+    if (layout == Layout::FEWEST)
+    {
+      // Nodes having the most free memory are filled first.
+      std::vector<int> order(this->nb_nodes_);
+      for (int i = 0; i < this->nb_nodes_; ++i) order[i] = i;
+      std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        return this->memory_per_node_[a] > this->memory_per_node_[b];
+      });
+
+      size_t start_idx = 0;
+      size_t free_elt = nb_elements;
+      for (const auto& i : order)
+      {
+        size_t count =
+            std::min((size_t)(this->memory_per_node_[i] / atom_size), free_elt);
+        if (count == 0) break;
+
+        nodes.push_back(
+            std::make_tuple(i + 1, start_idx, start_idx + count - 1));
+        free_elt -= count;
+        start_idx += count;
+      }
+      if (free_elt) nodes.clear();
+      return nodes;
+    }
+
+    if (layout == Layout::BALANCED)
+    {
+      // Splits the elements evenly between the nodes having free memory.
+      // A full node gives its share to the other ones, until every
+      // element is placed.
+      std::vector<size_t> counts(this->nb_nodes_, 0);
+      size_t free_elt = nb_elements;
+      while (free_elt)
+      {
+        size_t nb_active = 0;
+        for (int i = 0; i < this->nb_nodes_; ++i)
+          nb_active += (this->memory_per_node_[i] / atom_size > counts[i]);
+        if (nb_active == 0) return nodes;
+
+        size_t share = std::max(free_elt / nb_active, (size_t)1);
+        for (int i = 0; i < this->nb_nodes_ && free_elt; ++i)
+        {
+          size_t max = this->memory_per_node_[i] / atom_size - counts[i];
+          size_t count = std::min(std::min(share, max), free_elt);
+          counts[i] += count;
+          free_elt -= count;
+        }
+      }
+
+      size_t start_idx = 0;
+      for (int i = 0; i < this->nb_nodes_; ++i)
+      {
+        if (counts[i] == 0) continue;
+
+        nodes.push_back(
+            std::make_tuple(i + 1, start_idx, start_idx + counts[i] - 1));
+        start_idx += counts[i];
+      }
+      return nodes;
+    }
+
+    // First, we check if the size of the allocation can fit
+    // on a single node.
+    size_t start_idx = 0;
+    size_t free_elt = nb_elements;
+    for (int i = 0; i < this->nb_nodes_; ++i)
+    {
+      auto max = (this->memory_per_node_[i] / atom_size);
+      if (max < 1) continue;
+
+      if (max >= free_elt)
+      {
+        nodes.push_back(
+            std::make_tuple(i + 1, start_idx, start_idx + free_elt - 1));
+        return nodes;
+      }
+      nodes.push_back(std::make_tuple(i + 1, start_idx, start_idx + max - 1));
+      free_elt -= max;
+      start_idx += max;
+    }
+
+    // The network is full, nothing will be allocated.
+    nodes.clear();
+    return nodes;
+  }
+
+  void
+  Allocator::sendFill(const std::vector<Placement>& nodes,
+                      unsigned int atom_size, const void* value, bool zero)
+  {
+    static constexpr unsigned int HEADER_LEN =
+        sizeof(size_t) + sizeof(unsigned int);
+
+    // Sends the data with this layout:
+    //  sizeof (size_t)   sizeof (uint)     64 bytes
+    // [...NB_BYTES...]  [..ATOM_SIZE..]  [...VALUE...]
+    // An atom size of 0 means that the memory should not be filled. The
+    // memory is set to zero by filling it with a single zero byte.
+    std::vector<std::vector<uint8_t>> messages(nodes.size());
+    std::vector<MPI_Request> reqs(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      const auto& node = nodes[i];
+      size_t bytes = atom_size * (std::get<2>(node) - std::get<1>(node) + 1);
+      unsigned int fill_size = (value) ? atom_size : (zero) ? 1 : 0;
+
+      auto& data = messages[i];
+      data.resize(HEADER_LEN + 64, 0);
+      std::memcpy(&data[0], &bytes, sizeof(size_t));
+      std::memcpy(&data[0] + sizeof(size_t), &fill_size, sizeof(unsigned int));
+      if (value) std::memcpy(&data[0] + HEADER_LEN, value, atom_size);
+
+      message::send<uint8_t>(&data[0], data.size(), std::get<0>(node),
+                             TAGS::ALLOCATION_FILL, reqs[i]);
+    }
+
+    MPI_Waitall(reqs.size(), &reqs[0], MPI_STATUSES_IGNORE);
+  }
+
+  std::vector<Placement>
+  Allocator::planFile(const std::string& path, size_t atom_size,
+                      size_t offset, size_t& nb_elements,
+                      size_t& file_offset) const
+  {
+    FileHeader header;
+    size_t size = 0;
+    size_t available = 0;
+    file_offset = 0;
+    if (file::readHeader(path, header, size))
+    {
+      if (header.atom_size != atom_size) return std::vector<Placement>();
+
+      file_offset = sizeof(FileHeader);
+      available = std::min<size_t>(header.nb_values,
+                                   (size - file_offset) / atom_size);
+    }
+    else
+      available = size / atom_size;
+
+    if (offset >= available) return std::vector<Placement>();
+    if (nb_elements == 0) nb_elements = available - offset;
+    if (nb_elements > available - offset) return std::vector<Placement>();
+
+    file_offset += offset * atom_size;
+
+    return this->plan(nb_elements, atom_size);
+  }
+
+  bool
+  Allocator::sendSparse(const std::vector<size_t>& indices,
+                        const uint8_t* values, BaseElement* elt)
+  {
+    const size_t atom_size = elt->getAtomSize();
+    const size_t entry_size = sizeof(uint64_t) + atom_size;
+
+    // Chunks are planned on the non-zero values. Each chunk then covers
+    // the positions up to the first value of the next one.
+    const auto& entries = this->plan(indices.size(), entry_size);
+    if (entries.size() == 0) return false;
+
+    std::vector<Placement> nodes(entries.size());
+    std::vector<size_t> nb_bytes(entries.size());
+    std::vector<std::vector<uint8_t>> chunks(entries.size());
+    std::vector<MPI_Request> reqs(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+      const size_t first = std::get<1>(entries[i]);
+      const size_t count = std::get<2>(entries[i]) - first + 1;
+      const size_t lower = (i == 0) ? 0 : indices[first];
+      const size_t upper = (i + 1 == entries.size())
+                               ? elt->getNbValues() - 1
+                               : indices[std::get<1>(entries[i + 1])] - 1;
+      nodes[i] = std::make_tuple(std::get<0>(entries[i]), lower, upper);
+      nb_bytes[i] = count * entry_size;
+
+      // Sends the chunk with this layout:
+      //  sizeof (uint64_t)   N * sizeof (uint64_t)   N * atom_size
+      // [...NB_VALUES...]    [.....Positions.....]   [..Values..]
+      // Positions start at the beginning of the chunk.
+      auto& chunk = chunks[i];
+      chunk.resize(sizeof(uint64_t) + nb_bytes[i]);
+      const uint64_t nb_values = upper - lower + 1;
+      std::memcpy(&chunk[0], &nb_values, sizeof(uint64_t));
+
+      uint8_t* positions = &chunk[0] + sizeof(uint64_t);
+      for (size_t j = 0; j < count; ++j)
+      {
+        const uint64_t position = indices[first + j] - lower;
+        std::memcpy(positions + j * sizeof(uint64_t), &position,
+                    sizeof(uint64_t));
+      }
+      if (count)
+        std::memcpy(positions + count * sizeof(uint64_t),
+                    values + first * atom_size, count * atom_size);
+
+      message::send<uint8_t>(&chunk[0], chunk.size(), std::get<0>(nodes[i]),
+                             TAGS::ALLOCATION_SPARSE, reqs[i]);
+    }
+
+    bool tracked = this->track(nodes, elt, &nb_bytes);
+    MPI_Waitall(reqs.size(), &reqs[0], MPI_STATUSES_IGNORE);
+
+    return tracked;
+  }
+
+  void
+  Allocator::receiveSparse(const BaseElement* elt,
+                           std::vector<size_t>& indices,
+                           std::vector<uint8_t>& values)
+  {
+    const size_t atom_size = elt->getAtomSize();
+    const size_t entry_size = sizeof(uint64_t) + atom_size;
+
+    const auto& ids = elt->getIds();
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      const int dest = elt->getIntIds()[i];
+      const size_t lower = std::get<0>(elt->getBounds()[i]);
+
+      // Slaves send sparse chunks as they store them.
+      MPI_Request req;
+      message::send(ids[i], dest, TAGS::READ, req);
+
+      uint8_t* chunk = nullptr;
+      int bytes = 0;
+      MPI_Status status;
+      MPI_Probe(dest, TAGS::READ, MPI_COMM_WORLD, &status);
+      message::rec_sync<uint8_t>(dest, TAGS::READ, status, &bytes, &chunk);
+
+      const size_t count = bytes / entry_size;
+      for (size_t j = 0; j < count; ++j)
+      {
+        uint64_t position = 0;
+        std::memcpy(&position, chunk + j * sizeof(uint64_t), sizeof(uint64_t));
+        indices.push_back(lower + position);
+      }
+      const uint8_t* chunk_values = chunk + count * sizeof(uint64_t);
+      values.insert(values.end(), chunk_values,
+                    chunk_values + count * atom_size);
+
+      delete[] chunk;
+    }
+  }
+
+  bool
+  Allocator::sendMap(const BaseElement* elt, unsigned int callback_id,
+                     unsigned int data_type, size_t column,
+                     size_t record_size)
+  {
+    const auto& ids = elt->getIds();
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      const int dest = elt->getIntIds()[i];
+
+      std::string id = ids[i] + "-" + std::to_string(callback_id);
+      id += "-" + std::to_string(data_type);
+      // Only the column of the field is mapped.
+      if (record_size)
+      {
+        id += "-" + std::to_string(column);
+        id += "-" + std::to_string(record_size);
+      }
+
+      MPI_Request req;
+      message::send(id, dest, TAGS::MAP, req);
+    }
+
+    // Every acknowledge is received, even after a refused chunk.
+    bool success = true;
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      const int dest = elt->getIntIds()[i];
+
+      uint8_t status = 0;
+      message::rec_sync_ack(dest, TAGS::MAP, status);
+      success = success && (status == constant::SUCCESS);
+    }
+
+    return success;
+  }
+
+  bool
+  Allocator::sendHalo(const BaseElement* elt, const BaseElement* out,
+                      int tag, size_t halo_len,
+                      const std::vector<uint8_t>& params)
+  {
+    if (!elt->isDense() || !out->isDense()) return false;
+    if (out->getBounds() != elt->getBounds()) return false;
+    if (out->getIntIds() != elt->getIntIds()) return false;
+
+    // Chunks only exchange values with their direct neighbours.
+    const auto& bounds = elt->getBounds();
+    const auto& ranks = elt->getIntIds();
+    std::map<int, std::vector<Halo>> per_node;
+    for (size_t i = 0; i < bounds.size(); ++i)
+    {
+      if (std::get<1>(bounds[i]) - std::get<0>(bounds[i]) + 1 < halo_len)
+        return false;
+
+      Halo halo;
+      std::memset(&halo, 0, sizeof(Halo));
+      halo.left = (i > 0) ? ranks[i - 1] : 0;
+      halo.right = (i + 1 < bounds.size()) ? ranks[i + 1] : 0;
+      halo.index = i;
+      std::memcpy(halo.src_id, elt->getIds()[i].c_str(),
+                  elt->getIds()[i].size());
+      std::memcpy(halo.dst_id, out->getIds()[i].c_str(),
+                  out->getIds()[i].size());
+      per_node[ranks[i]].push_back(halo);
+    }
+
+    // Sends the request with this layout, chunks being in the order of
+    // the element:
+    //  sizeof (uint64_t)   N * sizeof (Halo)      P
+    // [.......N.......]    [.....Chunks.....]   [Params]
+    std::vector<std::vector<uint8_t>> requests;
+    for (const auto& node : per_node)
+    {
+      const auto& halos = node.second;
+      const uint64_t nb_halos = halos.size();
+      const size_t halos_len = nb_halos * sizeof(Halo);
+      requests.emplace_back(sizeof(uint64_t) + halos_len + params.size());
+      auto& request = requests.back();
+      std::memcpy(&request[0], &nb_halos, sizeof(uint64_t));
+      std::memcpy(&request[sizeof(uint64_t)], &halos[0], halos_len);
+      if (params.size())
+        std::memcpy(&request[sizeof(uint64_t) + halos_len], &params[0],
+                    params.size());
+
+      MPI_Request req;
+      message::send<uint8_t>(&request[0], request.size(), node.first, tag,
+                             req);
+    }
+
+    bool success = true;
+    for (const auto& node : per_node)
+    {
+      uint8_t status = 0;
+      message::rec_sync_ack(node.first, tag, status);
+      success = success && (status == constant::SUCCESS);
+    }
+
+    return success;
+  }
+
+  std::vector<Placement>
+  Allocator::planRows(const BaseElement* mat, size_t nb_cols) const
+  {
+    std::vector<Placement> nodes;
+    if (!mat->isDense() || nb_cols == 0) return nodes;
+
+    const auto& bounds = mat->getBounds();
+    for (size_t i = 0; i < bounds.size(); ++i)
+    {
+      const auto& lower = std::get<0>(bounds[i]);
+      const auto& upper = std::get<1>(bounds[i]);
+      if (lower % nb_cols || (upper + 1) % nb_cols)
+        return std::vector<Placement>();
+
+      nodes.emplace_back(mat->getIntIds()[i], lower / nb_cols,
+                         (upper + 1) / nb_cols - 1);
+    }
+
+    return nodes;
+  }
+
+  bool
+  Allocator::sendMatrix(const BaseElement* mat, const BaseElement* out,
+                        int tag, const std::vector<uint8_t>& params,
+                        const uint8_t* rows, size_t atom_size,
+                        std::vector<std::vector<uint8_t>>& replies)
+  {
+    uint64_t nb_cols = 0;
+    std::memcpy(&nb_cols, &params[2 * sizeof(uint32_t)], sizeof(uint64_t));
+    const auto& nodes = this->planRows(mat, nb_cols);
+    if (nodes.size() == 0) return false;
+
+    // Chunks are grouped by slave, so that the parameters, which may hold
+    // a whole vector, are sent once to each of them.
+    std::map<int, std::vector<MatrixBlock>> blocks;
+    std::map<int, std::vector<uint8_t>> values;
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      const int dest = std::get<0>(nodes[i]);
+      const auto& lower = std::get<1>(nodes[i]);
+      const auto& upper = std::get<2>(nodes[i]);
+
+      MatrixBlock block;
+      std::memset(&block, 0, sizeof(MatrixBlock));
+      std::memcpy(block.src_id, mat->getIds()[i].c_str(),
+                  mat->getIds()[i].size());
+      if (out)
+        std::memcpy(block.dst_id, out->getIds()[i].c_str(),
+                    out->getIds()[i].size());
+      block.nb_rows = upper - lower + 1;
+      blocks[dest].push_back(block);
+
+      if (rows)
+        values[dest].insert(values[dest].end(), rows + lower * atom_size,
+                            rows + (upper + 1) * atom_size);
+    }
+
+    // Sends the request with this layout, chunks being in the order of
+    // the matrix, followed by the values of their rows:
+    //  sizeof (uint64_t)   N * sizeof (MatrixBlock)   sizeof (uint64_t)
+    // [.......N.......]    [........Chunks........]   [.......P.......]
+    //       P                 R
+    // [..Params..]   [..Rows values..]
+    std::vector<std::vector<uint8_t>> requests;
+    for (const auto& node : blocks)
+    {
+      const uint64_t nb_blocks = node.second.size();
+      const uint64_t nb_params = params.size();
+      const size_t blocks_len = nb_blocks * sizeof(MatrixBlock);
+      const auto& rows_values = values[node.first];
+
+      requests.emplace_back();
+      auto& request = requests.back();
+      const auto* n = reinterpret_cast<const uint8_t*>(&nb_blocks);
+      const auto* p = reinterpret_cast<const uint8_t*>(&nb_params);
+      const auto* b = reinterpret_cast<const uint8_t*>(&node.second[0]);
+      request.insert(request.end(), n, n + sizeof(uint64_t));
+      request.insert(request.end(), b, b + blocks_len);
+      request.insert(request.end(), p, p + sizeof(uint64_t));
+      request.insert(request.end(), params.begin(), params.end());
+      request.insert(request.end(), rows_values.begin(), rows_values.end());
+
+      MPI_Request req;
+      message::send<uint8_t>(&request[0], request.size(), node.first, tag,
+                             req);
+    }
+
+    // Slaves writing in `out` only acknowledge.
+    bool success = true;
+    replies.clear();
+    for (const auto& node : blocks)
+    {
+      MPI_Status status;
+      uint8_t* reply = nullptr;
+      int bytes = 0;
+      MPI_Probe(node.first, tag, MPI_COMM_WORLD, &status);
+      message::rec_sync<uint8_t>(node.first, tag, status, &bytes, &reply);
+
+      if (out) success = success && reply[0] == constant::SUCCESS;
+      replies.emplace_back(reply, reply + bytes);
+      delete[] reply;
+    }
+
+    return success;
+  }
+
+  bool
+  Allocator::sendTable(const BaseElement* table, int tag, size_t key_size,
+                       size_t value_size, const uint8_t* keys,
+                       const uint8_t* values, size_t nb_keys,
+                       std::vector<std::vector<size_t>>& groups,
+                       std::vector<std::vector<uint8_t>>& replies)
+  {
+    const auto& ids = table->getIds();
+    groups.assign(ids.size(), std::vector<size_t>());
+    replies.assign(ids.size(), std::vector<uint8_t>());
+    for (size_t i = 0; i < nb_keys; ++i)
+    {
+      const uint64_t bits = table::keyBits(keys + i * key_size, key_size);
+      groups[table::partition(bits, ids.size())].push_back(i);
+    }
+
+    // Sends the request with this layout, values only following the keys
+    // of a `put`:
+    //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t)
+    // [...ID...]  [...KeySize...]    [..ValueSize..]    [.......N.......]
+    //  N * K     N * V
+    // [Keys]   [Values]
+    const size_t header_len =
+        constant::ID_LEN + 2 * sizeof(uint32_t) + sizeof(uint64_t);
+    std::vector<std::vector<uint8_t>> requests(ids.size());
+    for (size_t p = 0; p < ids.size(); ++p)
+    {
+      const auto& group = groups[p];
+      if (group.empty()) continue;
+
+      const uint32_t sizes[2] = {(uint32_t)key_size, (uint32_t)value_size};
+      const uint64_t nb_group = group.size();
+      auto& request = requests[p];
+      request.resize(header_len + nb_group * key_size +
+                         ((values) ? nb_group * value_size : 0),
+                     0);
+      std::memcpy(&request[0], ids[p].c_str(), ids[p].size());
+      std::memcpy(&request[constant::ID_LEN], sizes, sizeof(sizes));
+      std::memcpy(&request[constant::ID_LEN + sizeof(sizes)], &nb_group,
+                  sizeof(uint64_t));
+
+      uint8_t* out_keys = &request[header_len];
+      uint8_t* out_values = out_keys + nb_group * key_size;
+      for (size_t i = 0; i < group.size(); ++i)
+      {
+        std::memcpy(out_keys + i * key_size, keys + group[i] * key_size,
+                    key_size);
+        if (values)
+          std::memcpy(out_values + i * value_size,
+                      values + group[i] * value_size, value_size);
+      }
+
+      MPI_Request req;
+      message::send<uint8_t>(&request[0], request.size(),
+                             table->getIntIds()[p], tag, req);
+    }
+
+    bool success = true;
+    for (size_t p = 0; p < ids.size(); ++p)
+    {
+      if (groups[p].empty()) continue;
+
+      const int dest = table->getIntIds()[p];
+      MPI_Status status;
+      uint8_t* reply = nullptr;
+      int bytes = 0;
+      MPI_Probe(dest, tag, MPI_COMM_WORLD, &status);
+      message::rec_sync<uint8_t>(dest, tag, status, &bytes, &reply);
+
+      replies[p].assign(reply, reply + bytes);
+      delete[] reply;
+
+      uint64_t header[3];
+      std::memcpy(header, &replies[p][0], sizeof(header));
+      success = success && header[0] == constant::SUCCESS;
+    }
+
+    return success;
+  }
+
+  size_t
+  Allocator::resizeTable(BaseElement* table,
+                         const std::vector<std::vector<uint8_t>>& replies)
+  {
+    size_t nb_matched = 0;
+    for (size_t p = 0; p < replies.size(); ++p)
+    {
+      if (replies[p].empty()) continue;
+
+      uint64_t header[3];
+      std::memcpy(header, &replies[p][0], sizeof(header));
+      nb_matched += header[2];
+
+      // The memory follows the number of entries of the partition, and
+      // is then bounded by the memory the slave reports, as the capacity
+      // of the partition grows on its own.
+      const auto& bounds = table->getBounds()[p];
+      const size_t count = std::get<1>(bounds) - std::get<0>(bounds) + 1;
+      const int dest = table->getIntIds()[p];
+      this->memory_per_node_[dest - 1] += count * table->getAtomSize();
+      this->memory_per_node_[dest - 1] -= header[1] * table->getAtomSize();
+      table->resizeChunk(p, header[1]);
+
+      NodeStatus status;
+      std::memcpy(&status, &replies[p][sizeof(header)], sizeof(NodeStatus));
+      this->update(dest, status);
+    }
+
+    return nb_matched;
+  }
+
+  bool
+  Allocator::sendMapParam(const BaseElement* elt, unsigned int kernel_id,
+                          unsigned int data_type, const uint8_t* params,
+                          size_t nb_bytes)
+  {
+    // Sends the request with this layout:
+    //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  MAX_PARAMS * size
+    // [...ID...]  [...DataType...]   [....Kernel....]   [...Params...]
+    const uint32_t header[2] = {data_type, kernel_id};
+    const size_t header_len = constant::ID_LEN + sizeof(header);
+    const auto& ids = elt->getIds();
+    std::vector<std::vector<uint8_t>> requests(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      auto& request = requests[i];
+      request.resize(header_len + nb_bytes, 0);
+      std::memcpy(&request[0], ids[i].c_str(), ids[i].length());
+      std::memcpy(&request[constant::ID_LEN], header, sizeof(header));
+      std::memcpy(&request[header_len], params, nb_bytes);
+
+      MPI_Request req;
+      message::send<uint8_t>(&request[0], request.size(), elt->getIntIds()[i],
+                             TAGS::MAP_PARAM, req);
+    }
+
+    bool success = true;
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      uint8_t status = 0;
+      message::rec_sync_ack(elt->getIntIds()[i], TAGS::MAP_PARAM, status);
+      success = success && (status == constant::SUCCESS);
+    }
+
+    return success;
+  }
+
+  Statistics
+  Allocator::sendDescribe(const BaseElement* elt, unsigned int data_type,
+                          size_t column, size_t record_size)
+  {
+    // Every chunk is described at the same time, requests are kept
+    // until the replies are received.
+    const auto& ids = elt->getIds();
+    std::vector<std::vector<uint8_t>> requests(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      // Sends the request with this layout:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint32_t)
+      // [...ID...]  [...DataType...]   [....Column....]   [..RecordSize..]
+      const uint32_t params[3] = {data_type, (uint32_t)column,
+                                  (uint32_t)record_size};
+      auto& request = requests[i];
+      request.resize(constant::ID_LEN + sizeof(params), 0);
+      std::memcpy(&request[0], ids[i].c_str(), ids[i].length());
+      std::memcpy(&request[constant::ID_LEN], params, sizeof(params));
+
+      MPI_Request req;
+      message::send<uint8_t>(&request[0], request.size(), elt->getIntIds()[i],
+                             TAGS::DESCRIBE, req);
+    }
+
+    Statistics result = Statistics();
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      Statistics partial;
+      message::rec_sync<uint8_t>(elt->getIntIds()[i], TAGS::DESCRIBE,
+                                 sizeof(Statistics), (uint8_t*)&partial);
+      statistics::merge(result, partial);
+    }
+
+    return result;
+  }
+
+  void
+  Allocator::receiveTopK(const BaseElement* elt, unsigned int data_type,
+                         size_t k, bool largest, std::vector<size_t>& indices,
+                         std::vector<uint8_t>& values)
+  {
+    const auto& ids = elt->getIds();
+    std::vector<std::vector<uint8_t>> requests(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      // Sends the request with this layout:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t)
+      // [...ID...]  [...DataType...]   [...Largest...]    [.......K.......]
+      const uint32_t params[2] = {data_type, largest};
+      const uint64_t count = k;
+      auto& request = requests[i];
+      request.resize(constant::ID_LEN + sizeof(params) + sizeof(count), 0);
+      std::memcpy(&request[0], ids[i].c_str(), ids[i].length());
+      std::memcpy(&request[constant::ID_LEN], params, sizeof(params));
+      std::memcpy(&request[constant::ID_LEN + sizeof(params)], &count,
+                  sizeof(count));
+
+      MPI_Request req;
+      message::send<uint8_t>(&request[0], request.size(), elt->getIntIds()[i],
+                             TAGS::TOP_K, req);
+    }
+
+    const size_t atom_size = DataTypeToSize[data_type];
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      // Replies lay out like this, positions are local to the chunk:
+      //  sizeof (uint64_t)   N * sizeof (uint64_t)   N * atom_size
+      // [......N......]      [.....Positions.....]   [..Values..]
+      uint8_t* reply = nullptr;
+      message::rec_sync<uint8_t>(elt->getIntIds()[i], TAGS::TOP_K, &reply);
+
+      uint64_t count = 0;
+      std::memcpy(&count, reply, sizeof(uint64_t));
+      const size_t lower = std::get<0>(elt->getBounds()[i]);
+      for (size_t j = 0; j < count; ++j)
+      {
+        uint64_t position = 0;
+        std::memcpy(&position, reply + (j + 1) * sizeof(uint64_t),
+                    sizeof(uint64_t));
+        indices.push_back(lower + position);
+      }
+      const uint8_t* chunk_values = reply + (count + 1) * sizeof(uint64_t);
+      values.insert(values.end(), chunk_values,
+                    chunk_values + count * atom_size);
+
+      delete[] reply;
+    }
+  }
+
+  QuantileSketch
+  Allocator::sendSketch(const BaseElement* elt, unsigned int data_type,
+                        size_t accuracy)
+  {
+    const auto& ids = elt->getIds();
+    std::vector<std::vector<uint8_t>> requests(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      // Sends the request with this layout:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t)
+      // [...ID...]  [...DataType...]   [....Unused....]   [...Accuracy...]
+      const uint32_t params[2] = {data_type, 0};
+      const uint64_t size = accuracy;
+      auto& request = requests[i];
+      request.resize(constant::ID_LEN + sizeof(params) + sizeof(size), 0);
+      std::memcpy(&request[0], ids[i].c_str(), ids[i].length());
+      std::memcpy(&request[constant::ID_LEN], params, sizeof(params));
+      std::memcpy(&request[constant::ID_LEN + sizeof(params)], &size,
+                  sizeof(size));
+
+      MPI_Request req;
+      message::send<uint8_t>(&request[0], request.size(), elt->getIntIds()[i],
+                             TAGS::SKETCH, req);
+    }
+
+    QuantileSketch result(accuracy);
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      uint8_t* reply = nullptr;
+      MPI_Status status;
+      const int dest = elt->getIntIds()[i];
+      int bytes = 0;
+      MPI_Probe(dest, TAGS::SKETCH, MPI_COMM_WORLD, &status);
+      message::rec_sync<uint8_t>(dest, TAGS::SKETCH, status, &bytes, &reply);
+
+      QuantileSketch partial(accuracy);
+      if (partial.deserialize(reply, bytes)) result.merge(partial);
+      delete[] reply;
+    }
+
+    return result;
+  }
+
+  std::vector<std::vector<uint8_t>>
+  Allocator::sendHashSketch(const BaseElement* elt, unsigned int data_type,
+                            int tag, uint32_t param, uint64_t size)
+  {
+    const auto& ids = elt->getIds();
+    std::vector<std::vector<uint8_t>> requests(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      // Sends the request with this layout:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t)
+      // [...ID...]  [...DataType...]   [....Param....]    [.....Size.....]
+      const uint32_t params[2] = {data_type, param};
+      auto& request = requests[i];
+      request.resize(constant::ID_LEN + sizeof(params) + sizeof(size), 0);
+      std::memcpy(&request[0], ids[i].c_str(), ids[i].length());
+      std::memcpy(&request[constant::ID_LEN], params, sizeof(params));
+      std::memcpy(&request[constant::ID_LEN + sizeof(params)], &size,
+                  sizeof(size));
+
+      MPI_Request req;
+      message::send<uint8_t>(&request[0], request.size(), elt->getIntIds()[i],
+                             tag, req);
+    }
+
+    std::vector<std::vector<uint8_t>> replies(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      uint8_t* reply = nullptr;
+      MPI_Status status;
+      const int dest = elt->getIntIds()[i];
+      int bytes = 0;
+      MPI_Probe(dest, tag, MPI_COMM_WORLD, &status);
+      message::rec_sync<uint8_t>(dest, tag, status, &bytes, &reply);
+
+      replies[i].assign(reply, reply + bytes);
+      delete[] reply;
+    }
+
+    return replies;
+  }
+
+  bool
+  Allocator::sendFilter(const BaseElement* elt, unsigned int data_type,
+                        const BloomFilter& filter, BaseElement* mask)
+  {
+    std::vector<uint8_t> bytes;
+    filter.serialize(bytes);
+
+    const auto& ids = elt->getIds();
+    std::vector<std::vector<uint8_t>> requests(ids.size());
+    std::vector<Placement> nodes;
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      // Sends the request with this layout:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)       N
+      // [...ID...]  [...DataType...]   [....Unused....]   [..Filter..]
+      const uint32_t params[2] = {data_type, 0};
+      const size_t header_len = constant::ID_LEN + sizeof(params);
+      auto& request = requests[i];
+      request.resize(header_len + bytes.size(), 0);
+      std::memcpy(&request[0], ids[i].c_str(), ids[i].length());
+      std::memcpy(&request[constant::ID_LEN], params, sizeof(params));
+      std::memcpy(&request[header_len], &bytes[0], bytes.size());
+
+      MPI_Request req;
+      message::send<uint8_t>(&request[0], request.size(), elt->getIntIds()[i],
+                             TAGS::FILTER, req);
+
+      // Results are allocated on the node of the tested chunk.
+      const auto& bounds = elt->getBounds()[i];
+      nodes.emplace_back(elt->getIntIds()[i], std::get<0>(bounds),
+                         std::get<1>(bounds));
+    }
+
+    return this->track(nodes, mask);
+  }
+
+  double
+  Allocator::sendSum(const BaseElement* elt, unsigned int data_type)
+  {
+    const uint64_t nb_values = elt->getNbValues();
+    const auto& ids = elt->getIds();
+    const auto& bounds = elt->getBounds();
+    std::vector<std::vector<uint8_t>> requests(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      // Sends the request with this layout:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint64_t) * 2
+      // [...ID...]  [...DataType...]   [....Unused....]   [Lower, NB_VALUES]
+      const uint32_t params[2] = {data_type, 0};
+      const uint64_t range[2] = {std::get<0>(bounds[i]), nb_values};
+      auto& request = requests[i];
+      request.resize(constant::ID_LEN + sizeof(params) + sizeof(range), 0);
+      std::memcpy(&request[0], ids[i].c_str(), ids[i].length());
+      std::memcpy(&request[constant::ID_LEN], params, sizeof(params));
+      std::memcpy(&request[constant::ID_LEN + sizeof(params)], range,
+                  sizeof(range));
+
+      MPI_Request req;
+      message::send<uint8_t>(&request[0], request.size(), elt->getIntIds()[i],
+                             TAGS::SUM, req);
+    }
+
+    // Blocks split between chunks are rebuilt from their values, so that
+    // they are summed exactly as if they belonged to a single chunk.
+    std::vector<double> blocks(
+        2 * ((nb_values + summation::BLOCK - 1) / summation::BLOCK));
+    std::map<size_t, std::vector<double>> split;
+    const auto& place = [&](size_t position, const double* values,
+                            size_t count) {
+      for (size_t j = 0; j < count; ++j, ++position)
+      {
+        auto& block = split[position / summation::BLOCK];
+        if (block.empty())
+        {
+          const size_t first = position - position % summation::BLOCK;
+          block.resize(std::min<size_t>(summation::BLOCK, nb_values - first));
+        }
+        block[position % summation::BLOCK] = values[j];
+      }
+    };
+
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      // Replies lay out like this, with the sums of the blocks inside the
+      // chunk, and the values before and after them:
+      //  sizeof (uint64_t) * 2   B * 16   sizeof (uint64_t)   H * 8
+      // [First block, B]        [Sums]   [.......H.......]   [Values]
+      //  sizeof (uint64_t)   T * 8
+      // [.......T.......]    [Values]
+      uint8_t* reply = nullptr;
+      MPI_Status status;
+      const int dest = elt->getIntIds()[i];
+      int bytes = 0;
+      MPI_Probe(dest, TAGS::SUM, MPI_COMM_WORLD, &status);
+      message::rec_sync<uint8_t>(dest, TAGS::SUM, status, &bytes, &reply);
+
+      const uint8_t* cursor = reply;
+      uint64_t header[2];
+      std::memcpy(header, cursor, sizeof(header));
+      cursor += sizeof(header);
+      if (header[1])
+        std::memcpy(&blocks[2 * header[0]], cursor,
+                    2 * header[1] * sizeof(double));
+      cursor += 2 * header[1] * sizeof(double);
+
+      uint64_t nb_head = 0;
+      std::memcpy(&nb_head, cursor, sizeof(uint64_t));
+      cursor += sizeof(uint64_t);
+      std::vector<double> values(nb_head);
+      if (nb_head) std::memcpy(&values[0], cursor, nb_head * sizeof(double));
+      place(std::get<0>(bounds[i]), values.data(), nb_head);
+      cursor += nb_head * sizeof(double);
+
+      uint64_t nb_tail = 0;
+      std::memcpy(&nb_tail, cursor, sizeof(uint64_t));
+      cursor += sizeof(uint64_t);
+      values.resize(nb_tail);
+      if (nb_tail) std::memcpy(&values[0], cursor, nb_tail * sizeof(double));
+      place(std::get<1>(bounds[i]) + 1 - nb_tail, values.data(), nb_tail);
+
+      delete[] reply;
+    }
+
+    for (const auto& block : split)
+      summation::block(&block.second[0], block.second.size(),
+                       &blocks[2 * block.first]);
+
+    return summation::combine(blocks);
+  }
+
+  std::vector<std::vector<uint8_t>>
+  Allocator::sendRange(const BaseElement* elt, int tag, unsigned int data_type,
+                       const std::vector<size_t>& chunks,
+                       const std::vector<uint32_t>& flags,
+                       const std::vector<uint8_t>& params)
+  {
+    const auto& ids = elt->getIds();
+    std::vector<std::vector<uint8_t>> requests(chunks.size());
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+      // Sends the request with this layout:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)       N
+      // [...ID...]  [...DataType...]   [.....Flags.....]   [..Params..]
+      const auto& id = ids[chunks[i]];
+      const uint32_t header[2] = {data_type, flags[i]};
+      const size_t header_len = constant::ID_LEN + sizeof(header);
+      auto& request = requests[i];
+      request.resize(header_len + params.size(), 0);
+      std::memcpy(&request[0], id.c_str(), id.length());
+      std::memcpy(&request[constant::ID_LEN], header, sizeof(header));
+      if (params.size())
+        std::memcpy(&request[header_len], &params[0], params.size());
+
+      MPI_Request req;
+      message::send<uint8_t>(&request[0], request.size(),
+                             elt->getIntIds()[chunks[i]], tag, req);
+    }
+
+    std::vector<std::vector<uint8_t>> replies(chunks.size());
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+      uint8_t* reply = nullptr;
+      MPI_Status status;
+      const int dest = elt->getIntIds()[chunks[i]];
+      int bytes = 0;
+      MPI_Probe(dest, tag, MPI_COMM_WORLD, &status);
+      message::rec_sync<uint8_t>(dest, tag, status, &bytes, &reply);
+
+      replies[i].assign(reply, reply + bytes);
+      delete[] reply;
+    }
+
+    return replies;
+  }
+
+  void
+  Allocator::receiveColumn(const BaseElement* elt, size_t column,
+                           size_t field_size, size_t record_size,
+                           uint8_t* out)
+  {
+    const auto& ids = elt->getIds();
+    const auto& bounds = elt->getBounds();
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      const int dest = elt->getIntIds()[i];
+      const size_t lower = std::get<0>(bounds[i]);
+      const size_t count = std::get<1>(bounds[i]) - lower + 1;
+
+      // Sends the request with this layout:
+      //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  sizeof (uint32_t)
+      // [...ID...]  [....Column....]   [...FieldSize...]  [..RecordSize..]
+      const uint32_t params[3] = {(uint32_t)column, (uint32_t)field_size,
+                                  (uint32_t)record_size};
+      std::vector<uint8_t> request(constant::ID_LEN + sizeof(params), 0);
+      std::memcpy(&request[0], ids[i].c_str(), ids[i].length());
+      std::memcpy(&request[constant::ID_LEN], params, sizeof(params));
+      message::send_sync<uint8_t>(&request[0], request.size(), dest,
+                                  TAGS::READ_COLUMN);
+
+      // The column is received directly at its place.
+      message::rec_sync<uint8_t>(dest, TAGS::READ, count * field_size,
+                                 out + lower * field_size);
+    }
+  }
+
+  bool
+  Allocator::readPacked(const std::string& id, int dest,
+                        unsigned int data_type, unsigned int atom_size,
+                        uint8_t* out, size_t nb_bytes)
+  {
+    // Sends the request with this layout:
+    //  22 bytes   sizeof (uint32_t)  sizeof (uint32_t)  sizeof (size_t)
+    // [...ID...]  [...DataType...]   [...AtomSize...]   [..Threshold..]
+    const size_t params = constant::ID_LEN;
+    std::vector<uint8_t> request(params + 2 * sizeof(uint32_t) +
+                                 sizeof(size_t), 0);
+    const uint32_t type = data_type;
+    const uint32_t atom = atom_size;
+    std::memcpy(&request[0], id.c_str(), id.length());
+    std::memcpy(&request[params], &type, sizeof(uint32_t));
+    std::memcpy(&request[params + sizeof(uint32_t)], &atom, sizeof(uint32_t));
+    std::memcpy(&request[params + 2 * sizeof(uint32_t)],
+                &this->compress_threshold_, sizeof(size_t));
+    message::send_sync<uint8_t>(&request[0], request.size(), dest,
+                                TAGS::READ_PACKED);
+
+    uint8_t* packed = nullptr;
+    int bytes = 0;
+    MPI_Status status;
+    MPI_Probe(dest, TAGS::READ, MPI_COMM_WORLD, &status);
+    message::rec_sync<uint8_t>(dest, TAGS::READ, status, &bytes, &packed);
+
+    bool success = codec::decode(packed, bytes, out, nb_bytes);
+    delete[] packed;
+
+    return success;
+  }
+
+  bool
+  Allocator::sendFileWrite(const BaseElement* elt, const std::string& path,
+                           const FileHeader* header)
+  {
+    if (!elt->isDense()) return false;
+
+    // The file is created with its final size, so that slaves can write
+    // their ranges in any order.
+    const size_t header_len = (header) ? sizeof(FileHeader) : 0;
+    {
+      std::ofstream out(path, std::ios::binary | std::ios::trunc);
+      if (header)
+        out.write(reinterpret_cast<const char*>(header), header_len);
+      if (!out) return false;
+    }
+    size_t nb_bytes = header_len + elt->getNbValues() * elt->getAtomSize();
+    if (truncate(path.c_str(), nb_bytes) != 0) return false;
+
+    const auto& ids = elt->getIds();
+    const auto& bounds = elt->getBounds();
+    std::vector<std::vector<uint8_t>> msgs(ids.size());
+    std::vector<MPI_Request> reqs(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      size_t offset = header_len + std::get<0>(bounds[i]) * elt->getAtomSize();
+
+      // Sends the data with this layout:
+      //  22 bytes   sizeof (size_t)     N
+      // [...ID...]  [...OFFSET...]   [...PATH...]
+      auto& msg = msgs[i];
+      msg.resize(constant::ID_LEN + sizeof(size_t) + path.length() + 1, 0);
+      std::memcpy(&msg[0], ids[i].c_str(), ids[i].length());
+      std::memcpy(&msg[0] + constant::ID_LEN, &offset, sizeof(size_t));
+      std::memcpy(&msg[0] + constant::ID_LEN + sizeof(size_t), path.c_str(),
+                  path.length());
+
+      message::send<uint8_t>(&msg[0], msg.size(), elt->getIntIds()[i],
+                             TAGS::FILE_WRITE, reqs[i]);
+    }
+
+    bool success = true;
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      uint8_t status = 0;
+      message::rec_sync_ack(elt->getIntIds()[i], TAGS::FILE_WRITE, status);
+      success = success && (status == constant::SUCCESS);
+    }
+    if (reqs.size()) MPI_Waitall(reqs.size(), &reqs[0], MPI_STATUSES_IGNORE);
+
+    return success;
+  }
+
+  void
+  Allocator::sendFileRead(const std::vector<Placement>& nodes,
+                          unsigned int atom_size, const std::string& path,
+                          size_t file_offset)
+  {
+    static constexpr unsigned int HEADER_LEN = 2 * sizeof(size_t);
+
+    std::vector<std::vector<uint8_t>> msgs(nodes.size());
+    std::vector<MPI_Request> reqs(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      const auto& node = nodes[i];
+      size_t nb_bytes = atom_size * (std::get<2>(node) - std::get<1>(node) + 1);
+      size_t offset = file_offset + atom_size * std::get<1>(node);
+
+      // Sends the data with this layout:
+      //  sizeof (size_t)   sizeof (size_t)     N
+      // [...NB_BYTES...]  [...OFFSET...]   [...PATH...]
+      auto& msg = msgs[i];
+      msg.resize(HEADER_LEN + path.length() + 1, 0);
+      std::memcpy(&msg[0], &nb_bytes, sizeof(size_t));
+      std::memcpy(&msg[0] + sizeof(size_t), &offset, sizeof(size_t));
+      std::memcpy(&msg[0] + HEADER_LEN, path.c_str(), path.length());
+
+      message::send<uint8_t>(&msg[0], msg.size(), std::get<0>(node),
+                             TAGS::ALLOCATION_FILE, reqs[i]);
+    }
+
+    MPI_Waitall(reqs.size(), &reqs[0], MPI_STATUSES_IGNORE);
+  }
+
+  bool
+  Allocator::track(const std::vector<Placement>& nodes, BaseElement* elt,
+                   const std::vector<size_t>* nb_bytes)
+  {
+    std::vector<std::string> ids(nodes.size());
+    std::vector<int> dests(nodes.size());
+    std::vector<size_t> bytes(nodes.size());
+
+    bool success = true;
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      const auto& lower = std::get<1>(nodes[i]);
+      const auto& upper = std::get<2>(nodes[i]);
+      dests[i] = std::get<0>(nodes[i]);
+      bytes[i] = (nb_bytes) ? (*nb_bytes)[i]
+                            : elt->getAtomSize() * (upper - lower + 1);
+
+      // The memory is considered as used before the reply, which
+      // already takes the chunk into account.
+      this->memory_per_node_[dests[i] - 1] -= bytes[i];
+      auto status = this->receiveStatus(dests[i], TAGS::ALLOCATION, &ids[i]);
+      if (status.status == constant::SUCCESS) continue;
+
+      // The slave did not have the memory the master expected.
+      this->memory_per_node_[dests[i] - 1] += bytes[i];
+      this->update(dests[i], status);
+      success = false;
+    }
+
+    // The element is left untouched, and the allocated chunks are freed.
+    if (!success)
+    {
+      std::vector<std::string> allocated;
+      std::vector<int> owners;
+      for (size_t i = 0; i < nodes.size(); ++i)
+      {
+        if (ids[i].empty()) continue;
+        allocated.push_back(ids[i]);
+        owners.push_back(dests[i]);
+        this->memory_per_node_[dests[i] - 1] += bytes[i];
+      }
+      this->release(allocated, owners);
+
+      return false;
+    }
+
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      const auto& node = nodes[i];
+      elt->addId(ids[i], std::make_tuple(std::get<1>(node), std::get<2>(node)));
+    }
+    this->elements_.emplace(elt, this->nb_tracked_++);
+
+    return true;
+  }
 }  // namespace algorep
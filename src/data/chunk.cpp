@@ -0,0 +1,170 @@
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <data/chunk.h>
+
+namespace algorep
+{
+  Chunk::~Chunk()
+  {
+    this->clear();
+  }
+
+  Chunk::Chunk(Chunk&& other)
+      : ram_{std::move(other.ram_)}, fd_{other.fd_}, map_{other.map_},
+        size_{other.size_}, capacity_{other.capacity_}
+  {
+    other.fd_ = -1;
+    other.map_ = nullptr;
+    other.size_ = 0;
+    other.capacity_ = 0;
+  }
+
+  Chunk&
+  Chunk::operator=(Chunk&& other)
+  {
+    if (this == &other) return *this;
+
+    this->clear();
+    this->ram_ = std::move(other.ram_);
+    this->fd_ = other.fd_;
+    this->map_ = other.map_;
+    this->size_ = other.size_;
+    this->capacity_ = other.capacity_;
+
+    other.fd_ = -1;
+    other.map_ = nullptr;
+    other.size_ = 0;
+    other.capacity_ = 0;
+
+    return *this;
+  }
+
+  void
+  Chunk::resize(size_t nb_bytes, bool zero)
+  {
+    const size_t size = this->size();
+    if (!this->isSpilled())
+      this->ram_.resize(nb_bytes);
+    else
+    {
+      this->reserve(nb_bytes);
+      this->size_ = nb_bytes;
+    }
+
+    // Spilled chunks need it as well: the file may still contain bytes of
+    // a previous truncation.
+    if (zero && nb_bytes > size)
+      std::memset(this->data() + size, 0, nb_bytes - size);
+  }
+
+  void
+  Chunk::reserve(size_t nb_bytes)
+  {
+    if (!this->isSpilled())
+    {
+      this->ram_.reserve(nb_bytes);
+      return;
+    }
+
+    if (nb_bytes > this->capacity_ && !this->remap(nb_bytes))
+      throw std::bad_alloc();
+  }
+
+  void
+  Chunk::clear()
+  {
+    if (this->map_) munmap(this->map_, this->capacity_);
+    if (this->fd_ != -1) close(this->fd_);
+
+    this->fd_ = -1;
+    this->map_ = nullptr;
+    this->size_ = 0;
+    this->capacity_ = 0;
+    Bytes().swap(this->ram_);
+  }
+
+  bool
+  Chunk::spill(const std::string& path)
+  {
+    if (this->isSpilled()) return true;
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd == -1) return false;
+    // The file is only reachable through the descriptor from now on.
+    unlink(path.c_str());
+
+    this->fd_ = fd;
+    if (!this->remap(this->ram_.capacity()))
+    {
+      close(fd);
+      this->fd_ = -1;
+      return false;
+    }
+
+    this->size_ = this->ram_.size();
+    if (this->size_) std::memcpy(this->map_, this->ram_.data(), this->size_);
+    Bytes().swap(this->ram_);
+
+    return true;
+  }
+
+  bool
+  Chunk::load()
+  {
+    if (!this->isSpilled()) return true;
+
+    Bytes ram;
+    try
+    {
+      ram.reserve(this->capacity_);
+      ram.assign(this->map_, this->map_ + this->size_);
+    }
+    catch (const std::bad_alloc&)
+    {
+      return false;
+    }
+
+    this->clear();
+    this->ram_.swap(ram);
+
+    return true;
+  }
+
+  void
+  Chunk::advise(int advice) const
+  {
+    if (this->map_) madvise(this->map_, this->capacity_, advice);
+  }
+
+  bool
+  Chunk::remap(size_t capacity)
+  {
+    if (ftruncate(this->fd_, capacity) == -1) return false;
+
+    // A mapping can not be empty.
+    uint8_t* map = nullptr;
+    if (capacity)
+    {
+      void* ptr = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED,
+                       this->fd_, 0);
+      // The old mapping is kept, and the file is truncated back to it.
+      if (ptr == MAP_FAILED)
+      {
+        ftruncate(this->fd_, this->capacity_);
+        return false;
+      }
+      map = static_cast<uint8_t*>(ptr);
+    }
+
+    if (this->map_) munmap(this->map_, this->capacity_);
+    this->map_ = map;
+    this->capacity_ = capacity;
+
+    return true;
+  }
+}  // namespace algorep
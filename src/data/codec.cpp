@@ -0,0 +1,412 @@
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+#include <type_traits>
+
+#include <constant/callback.h>
+#include <data/codec.h>
+
+namespace algorep
+{
+  namespace codec
+  {
+    namespace
+    {
+      /**
+       * @brief Number of bytes compressed to estimate the ratio of
+       * each encoding.
+       */
+      constexpr size_t SAMPLE_LEN = 4096;
+
+      /**
+       * @brief Shortest match encoded by the LZ compressor.
+       */
+      constexpr size_t MIN_MATCH = 4;
+
+      /**
+       * @brief Number of bits of the hash of the LZ compressor.
+       */
+      constexpr unsigned int HASH_BITS = 14;
+
+      /**
+       * @brief Shortest run of zeros ending a literal run.
+       */
+      constexpr size_t MIN_ZEROS = 4;
+
+      void
+      putVarint(uint64_t value, std::vector<uint8_t>& out)
+      {
+        while (value >= 0x80)
+        {
+          out.push_back((value & 0x7F) | 0x80);
+          value >>= 7;
+        }
+        out.push_back(value);
+      }
+
+      bool
+      getVarint(const uint8_t*& in, const uint8_t* end, uint64_t& value)
+      {
+        value = 0;
+        for (unsigned int shift = 0; shift < 64 && in < end; shift += 7)
+        {
+          const uint8_t byte = *in++;
+          value |= (uint64_t)(byte & 0x7F) << shift;
+          if (!(byte & 0x80)) return true;
+        }
+        return false;
+      }
+
+      bool
+      isInteger(unsigned int data_type)
+      {
+        return data_type < DataType::FLOAT;
+      }
+
+      template <typename U>
+      void
+      encodeDelta(const uint8_t* data, size_t nb_bytes,
+                  std::vector<uint8_t>& out)
+      {
+        typedef typename std::make_signed<U>::type S;
+        static constexpr unsigned int SIGN = sizeof(U) * 8 - 1;
+
+        U previous = 0;
+        for (size_t i = 0; i + sizeof(U) <= nb_bytes; i += sizeof(U))
+        {
+          U value;
+          std::memcpy(&value, data + i, sizeof(U));
+          const U delta = value - previous;
+          previous = value;
+
+          // Small negative differences become small positive values.
+          putVarint((U)((U)(delta << 1) ^ (U)((S)delta >> SIGN)), out);
+        }
+      }
+
+      template <typename U>
+      bool
+      decodeDelta(const uint8_t* in, const uint8_t* end, uint8_t* out,
+                  size_t out_bytes)
+      {
+        if (out_bytes % sizeof(U) != 0) return false;
+
+        U previous = 0;
+        for (size_t i = 0; i < out_bytes; i += sizeof(U))
+        {
+          uint64_t zigzag = 0;
+          if (!getVarint(in, end, zigzag)) return false;
+
+          const U value = (U)zigzag;
+          previous += (U)((value >> 1) ^ (U)(0 - (value & 1)));
+          std::memcpy(out + i, &previous, sizeof(U));
+        }
+
+        return in == end;
+      }
+
+      void
+      shuffle(const uint8_t* data, size_t nb_bytes, unsigned int atom_size,
+              std::vector<uint8_t>& out)
+      {
+        // Bytes of the same rank are gathered: the exponents and high
+        // bytes of floats become long repeated sequences.
+        const size_t nb_values = nb_bytes / atom_size;
+        out.resize(nb_bytes);
+        for (unsigned int b = 0; b < atom_size; ++b)
+          for (size_t i = 0; i < nb_values; ++i)
+            out[b * nb_values + i] = data[i * atom_size + b];
+
+        const size_t tail = nb_values * atom_size;
+        std::copy(data + tail, data + nb_bytes, out.begin() + tail);
+      }
+
+      void
+      unshuffle(const uint8_t* data, size_t nb_bytes, unsigned int atom_size,
+                uint8_t* out)
+      {
+        const size_t nb_values = nb_bytes / atom_size;
+        for (unsigned int b = 0; b < atom_size; ++b)
+          for (size_t i = 0; i < nb_values; ++i)
+            out[i * atom_size + b] = data[b * nb_values + i];
+
+        const size_t tail = nb_values * atom_size;
+        std::copy(data + tail, data + nb_bytes, out + tail);
+      }
+
+      void
+      compressLZ(const uint8_t* data, size_t nb_bytes,
+                 std::vector<uint8_t>& out)
+      {
+        // The data lays out as a list of sequences:
+        //   varint     N bytes     varint           varint
+        // [..N..]   [..Literals..]  [..Length - 4..]  [..Offset..]
+        // The last sequence only contains literals.
+        std::vector<size_t> table(1 << HASH_BITS, 0);
+        size_t anchor = 0;
+        size_t i = 0;
+        while (i + MIN_MATCH <= nb_bytes)
+        {
+          uint32_t sequence;
+          std::memcpy(&sequence, data + i, sizeof(uint32_t));
+          const size_t hash = (sequence * 2654435761u) >> (32 - HASH_BITS);
+
+          // Positions are stored with an offset of 1, 0 being empty.
+          const size_t candidate = table[hash];
+          table[hash] = i + 1;
+          if (!candidate ||
+              std::memcmp(data + candidate - 1, data + i, MIN_MATCH) != 0)
+          {
+            ++i;
+            continue;
+          }
+
+          const size_t match = candidate - 1;
+          size_t length = MIN_MATCH;
+          while (i + length < nb_bytes &&
+                 data[match + length] == data[i + length])
+            ++length;
+
+          putVarint(i - anchor, out);
+          out.insert(out.end(), data + anchor, data + i);
+          putVarint(length - MIN_MATCH, out);
+          putVarint(i - match, out);
+
+          i += length;
+          anchor = i;
+        }
+
+        putVarint(nb_bytes - anchor, out);
+        out.insert(out.end(), data + anchor, data + nb_bytes);
+      }
+
+      bool
+      decompressLZ(const uint8_t* in, const uint8_t* end, uint8_t* out,
+                   size_t out_bytes)
+      {
+        size_t position = 0;
+        while (true)
+        {
+          uint64_t nb_literals = 0;
+          if (!getVarint(in, end, nb_literals)) return false;
+          if (nb_literals > (size_t)(end - in) ||
+              nb_literals > out_bytes - position)
+            return false;
+
+          std::memcpy(out + position, in, nb_literals);
+          in += nb_literals;
+          position += nb_literals;
+          if (position == out_bytes) break;
+
+          uint64_t length = 0;
+          uint64_t offset = 0;
+          if (!getVarint(in, end, length) || !getVarint(in, end, offset))
+            return false;
+          length += MIN_MATCH;
+          if (offset == 0 || offset > position ||
+              length > out_bytes - position)
+            return false;
+
+          // The match may overlap the bytes it produces.
+          for (size_t i = 0; i < length; ++i, ++position)
+            out[position] = out[position - offset];
+        }
+
+        return in == end;
+      }
+
+      void
+      encodeZeros(const uint8_t* data, size_t nb_bytes,
+                  std::vector<uint8_t>& out)
+      {
+        // The data lays out as a list of runs:
+        //  varint   varint      N bytes
+        // [.Zeros.]  [..N..]  [..Literals..]
+        size_t i = 0;
+        while (i < nb_bytes)
+        {
+          size_t start = i;
+          while (i < nb_bytes && data[i] == 0) ++i;
+          putVarint(i - start, out);
+
+          // Short runs of zeros are kept in the literals.
+          start = i;
+          while (i < nb_bytes)
+          {
+            if (data[i] != 0)
+            {
+              ++i;
+              continue;
+            }
+
+            size_t j = i;
+            while (j < nb_bytes && data[j] == 0 && j - i < MIN_ZEROS) ++j;
+            if (j - i == MIN_ZEROS || j == nb_bytes) break;
+            i = j;
+          }
+
+          putVarint(i - start, out);
+          out.insert(out.end(), data + start, data + i);
+        }
+      }
+
+      bool
+      decodeZeros(const uint8_t* in, const uint8_t* end, uint8_t* out,
+                  size_t out_bytes)
+      {
+        size_t position = 0;
+        while (position < out_bytes)
+        {
+          uint64_t nb_zeros = 0;
+          uint64_t nb_literals = 0;
+          if (!getVarint(in, end, nb_zeros) ||
+              nb_zeros > out_bytes - position)
+            return false;
+          std::memset(out + position, 0, nb_zeros);
+          position += nb_zeros;
+
+          if (!getVarint(in, end, nb_literals) ||
+              nb_literals > out_bytes - position ||
+              nb_literals > (size_t)(end - in))
+            return false;
+          std::memcpy(out + position, in, nb_literals);
+          in += nb_literals;
+          position += nb_literals;
+        }
+
+        return in == end;
+      }
+
+      void
+      encodeWith(Codec codec, const uint8_t* data, size_t nb_bytes,
+                 unsigned int atom_size, std::vector<uint8_t>& out)
+      {
+        std::vector<uint8_t> shuffled;
+        switch (codec)
+        {
+          case Codec::DELTA_VARINT:
+            if (atom_size == sizeof(uint16_t))
+              encodeDelta<uint16_t>(data, nb_bytes, out);
+            else if (atom_size == sizeof(uint32_t))
+              encodeDelta<uint32_t>(data, nb_bytes, out);
+            else
+              encodeDelta<uint64_t>(data, nb_bytes, out);
+            break;
+          case Codec::SHUFFLE_LZ:
+            shuffle(data, nb_bytes, atom_size, shuffled);
+            compressLZ(shuffled.data(), nb_bytes, out);
+            break;
+          case Codec::ZERO_RLE:
+            encodeZeros(data, nb_bytes, out);
+            break;
+          default:
+            out.insert(out.end(), data, data + nb_bytes);
+            break;
+        }
+      }
+    }  // namespace
+
+    void
+    encode(const uint8_t* data, size_t nb_bytes, unsigned int data_type,
+           unsigned int atom_size, size_t threshold,
+           std::vector<uint8_t>& out)
+    {
+      if (atom_size == 0 || atom_size > UINT16_MAX) atom_size = 1;
+
+      // Integers are compressed as differences, other types as bytes.
+      Codec primary = Codec::SHUFFLE_LZ;
+      if (isInteger(data_type) && DataTypeToSize[data_type] == atom_size)
+        primary = Codec::DELTA_VARINT;
+
+      // Each encoding is tried on a sample, and kept if it saves at least
+      // an eighth of the bytes. Otherwise, the payload is sent raw.
+      Codec codec = Codec::RAW;
+      if (nb_bytes >= threshold && nb_bytes >= atom_size)
+      {
+        size_t sample = std::min(nb_bytes, SAMPLE_LEN);
+        sample -= sample % atom_size;
+
+        size_t best = sample - sample / 8;
+        std::vector<uint8_t> buffer;
+        for (Codec candidate : {primary, Codec::ZERO_RLE})
+        {
+          buffer.clear();
+          encodeWith(candidate, data, sample, atom_size, buffer);
+          if (buffer.size() >= best) continue;
+
+          best = buffer.size();
+          codec = candidate;
+        }
+      }
+
+      CodecHeader header;
+      std::memset(&header, 0, sizeof(CodecHeader));
+      header.data_type = data_type;
+      header.atom_size = atom_size;
+      header.raw_size = nb_bytes;
+
+      out.resize(sizeof(CodecHeader));
+      if (codec != Codec::RAW)
+      {
+        out.reserve(sizeof(CodecHeader) + nb_bytes / 2);
+        encodeWith(codec, data, nb_bytes, atom_size, out);
+        // The sample was not representative of the whole payload.
+        if (out.size() - sizeof(CodecHeader) >= nb_bytes)
+        {
+          codec = Codec::RAW;
+          out.resize(sizeof(CodecHeader));
+        }
+      }
+      if (codec == Codec::RAW) out.insert(out.end(), data, data + nb_bytes);
+
+      header.codec = codec;
+      std::memcpy(&out[0], &header, sizeof(CodecHeader));
+    }
+
+    bool
+    readHeader(const uint8_t* data, size_t nb_bytes, CodecHeader& header)
+    {
+      if (nb_bytes < sizeof(CodecHeader)) return false;
+
+      std::memcpy(&header, data, sizeof(CodecHeader));
+      return header.codec <= Codec::ZERO_RLE && header.atom_size != 0;
+    }
+
+    bool
+    decode(const uint8_t* data, size_t nb_bytes, uint8_t* out,
+           size_t out_bytes)
+    {
+      CodecHeader header;
+      if (!readHeader(data, nb_bytes, header) || header.raw_size != out_bytes)
+        return false;
+
+      const uint8_t* in = data + sizeof(CodecHeader);
+      const uint8_t* end = data + nb_bytes;
+      std::vector<uint8_t> shuffled;
+      switch (header.codec)
+      {
+        case Codec::RAW:
+          if ((size_t)(end - in) != out_bytes) return false;
+          if (out_bytes) std::memcpy(out, in, out_bytes);
+          return true;
+        case Codec::DELTA_VARINT:
+          if (header.atom_size == sizeof(uint16_t))
+            return decodeDelta<uint16_t>(in, end, out, out_bytes);
+          if (header.atom_size == sizeof(uint32_t))
+            return decodeDelta<uint32_t>(in, end, out, out_bytes);
+          if (header.atom_size == sizeof(uint64_t))
+            return decodeDelta<uint64_t>(in, end, out, out_bytes);
+          return false;
+        case Codec::SHUFFLE_LZ:
+          shuffled.resize(out_bytes);
+          if (!decompressLZ(in, end, shuffled.data(), out_bytes)) return false;
+          unshuffle(shuffled.data(), out_bytes, header.atom_size, out);
+          return true;
+        case Codec::ZERO_RLE:
+          return decodeZeros(in, end, out, out_bytes);
+        default:
+          return false;
+      }
+    }
+  }  // namespace codec
+}  // namespace algorep
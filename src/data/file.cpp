@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+
+#include <mpi/mpi.h>
+
+#include <data/file.h>
+
+namespace algorep
+{
+  namespace file
+  {
+    bool
+    readHeader(const std::string& path, FileHeader& header, size_t& size)
+    {
+      size = 0;
+      std::ifstream in(path, std::ios::binary | std::ios::ate);
+      if (!in) return false;
+
+      size = in.tellg();
+      if (size < sizeof(FileHeader)) return false;
+
+      in.seekg(0);
+      in.read(reinterpret_cast<char*>(&header), sizeof(FileHeader));
+
+      return in && std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0;
+    }
+
+    bool
+    read(const std::string& path, size_t offset, uint8_t* out,
+         size_t nb_bytes)
+    {
+      // Each slave reads its own range, independently from the others.
+      MPI_File fh;
+      if (MPI_File_open(MPI_COMM_SELF, path.c_str(), MPI_MODE_RDONLY,
+                        MPI_INFO_NULL, &fh) != MPI_SUCCESS)
+        return false;
+
+      // MPI counts are integers, large chunks are read in several calls.
+      bool success = true;
+      size_t done = 0;
+      while (success && done < nb_bytes)
+      {
+        int count = std::min<size_t>(nb_bytes - done, INT_MAX);
+        MPI_Status status;
+        success = MPI_File_read_at(fh, offset + done, out + done, count,
+                                   MPI_BYTE, &status) == MPI_SUCCESS;
+
+        int read = 0;
+        MPI_Get_count(&status, MPI_BYTE, &read);
+        success = success && (read == count);
+        done += count;
+      }
+      MPI_File_close(&fh);
+
+      return success;
+    }
+
+    bool
+    write(const std::string& path, size_t offset, const uint8_t* data,
+          size_t nb_bytes)
+    {
+      // The file is created by the master, slaves only fill their range.
+      MPI_File fh;
+      if (MPI_File_open(MPI_COMM_SELF, path.c_str(), MPI_MODE_WRONLY,
+                        MPI_INFO_NULL, &fh) != MPI_SUCCESS)
+        return false;
+
+      bool success = true;
+      size_t done = 0;
+      while (success && done < nb_bytes)
+      {
+        int count = std::min<size_t>(nb_bytes - done, INT_MAX);
+        MPI_Status status;
+        success = MPI_File_write_at(fh, offset + done,
+                                    const_cast<uint8_t*>(data) + done, count,
+                                    MPI_BYTE, &status) == MPI_SUCCESS;
+
+        int written = 0;
+        MPI_Get_count(&status, MPI_BYTE, &written);
+        success = success && (written == count);
+        done += count;
+      }
+      MPI_File_close(&fh);
+
+      return success;
+    }
+  }  // namespace file
+}  // namespace algorep
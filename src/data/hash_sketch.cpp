@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <data/hash_sketch.h>
+
+namespace algorep
+{
+  HyperLogLog::HyperLogLog(unsigned int precision)
+      : precision_{std::min(std::max(precision, 4u), 16u)},
+        registers_(size_t(1) << precision_, 0)
+  {
+  }
+
+  bool
+  HyperLogLog::merge(const HyperLogLog& other)
+  {
+    if (other.precision_ != this->precision_) return false;
+
+    for (size_t i = 0; i < this->registers_.size(); ++i)
+      this->registers_[i] = std::max(this->registers_[i], other.registers_[i]);
+    return true;
+  }
+
+  double
+  HyperLogLog::estimate() const
+  {
+    const double m = this->registers_.size();
+    double alpha = 0.7213 / (1 + 1.079 / m);
+    if (m == 16)
+      alpha = 0.673;
+    else if (m == 32)
+      alpha = 0.697;
+    else if (m == 64)
+      alpha = 0.709;
+
+    double sum = 0;
+    size_t nb_zeros = 0;
+    for (const auto& reg : this->registers_)
+    {
+      sum += std::ldexp(1.0, -reg);
+      nb_zeros += (reg == 0);
+    }
+
+    // Small cardinalities are better estimated by the empty registers.
+    const double estimate = alpha * m * m / sum;
+    if (estimate <= 2.5 * m && nb_zeros)
+      return m * std::log(m / nb_zeros);
+    return estimate;
+  }
+
+  void
+  HyperLogLog::serialize(std::vector<uint8_t>& out) const
+  {
+    // The sketch is written with this layout:
+    //  1 byte       2^precision bytes
+    // [Precision]   [...Registers...]
+    out.resize(1 + this->registers_.size());
+    out[0] = this->precision_;
+    std::memcpy(&out[1], &this->registers_[0], this->registers_.size());
+  }
+
+  bool
+  HyperLogLog::deserialize(const uint8_t* data, size_t nb_bytes)
+  {
+    if (nb_bytes < 1 || data[0] < 4 || data[0] > 16) return false;
+    if (nb_bytes != 1 + (size_t(1) << data[0])) return false;
+
+    this->precision_ = data[0];
+    this->registers_.assign(data + 1, data + nb_bytes);
+    return true;
+  }
+
+  BloomFilter::BloomFilter(size_t nb_bits, unsigned int nb_hashes)
+      : nb_hashes_{std::max(nb_hashes, 1u)},
+        bits_((std::max<size_t>(nb_bits, 1) + 63) / 64, 0)
+  {
+  }
+
+  BloomFilter
+  BloomFilter::create(size_t nb_keys, double false_positive)
+  {
+    // Sizes minimizing the false positives, see Broder & Mitzenmacher.
+    const double ln2 = std::log(2.0);
+    const double rate = std::min(std::max(false_positive, 1e-9), 0.5);
+    const double nb_bits =
+        std::ceil(-(double)std::max<size_t>(nb_keys, 1) * std::log(rate) /
+                  (ln2 * ln2));
+    const double nb_hashes =
+        std::round(nb_bits / std::max<size_t>(nb_keys, 1) * ln2);
+
+    return BloomFilter(nb_bits, std::max(nb_hashes, 1.0));
+  }
+
+  bool
+  BloomFilter::merge(const BloomFilter& other)
+  {
+    if (other.bits_.size() != this->bits_.size() ||
+        other.nb_hashes_ != this->nb_hashes_)
+      return false;
+
+    for (size_t i = 0; i < this->bits_.size(); ++i)
+      this->bits_[i] |= other.bits_[i];
+    return true;
+  }
+
+  void
+  BloomFilter::serialize(std::vector<uint8_t>& out) const
+  {
+    // The filter is written with this layout:
+    //  sizeof (uint64_t)   N * sizeof (uint64_t)
+    // [..NB_HASHES..]      [.......Bits.......]
+    const uint64_t nb_hashes = this->nb_hashes_;
+    const size_t nb_bytes = this->bits_.size() * sizeof(uint64_t);
+    out.resize(sizeof(uint64_t) + nb_bytes);
+    std::memcpy(&out[0], &nb_hashes, sizeof(uint64_t));
+    std::memcpy(&out[sizeof(uint64_t)], &this->bits_[0], nb_bytes);
+  }
+
+  bool
+  BloomFilter::deserialize(const uint8_t* data, size_t nb_bytes)
+  {
+    uint64_t nb_hashes = 0;
+    if (nb_bytes <= sizeof(uint64_t)) return false;
+    if ((nb_bytes - sizeof(uint64_t)) % sizeof(uint64_t)) return false;
+    std::memcpy(&nb_hashes, data, sizeof(uint64_t));
+    if (nb_hashes == 0 || nb_hashes > 64) return false;
+
+    this->nb_hashes_ = nb_hashes;
+    this->bits_.resize((nb_bytes - sizeof(uint64_t)) / sizeof(uint64_t));
+    std::memcpy(&this->bits_[0], data + sizeof(uint64_t),
+                nb_bytes - sizeof(uint64_t));
+    return true;
+  }
+}  // namespace algorep
@@ -1,23 +1,363 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <new>
+
+#include <fcntl.h>
+#include <malloc.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <constant/constants.h>
 #include <data/memory.h>
 
 namespace algorep
 {
   std::string
-  Memory::reserve(int node_rank, int nb_bytes)
+  Memory::reserve(int node_rank, size_t nb_bytes, bool zero)
   {
-    static unsigned long long ID = 0;
-    std::string id = std::to_string(node_rank) + "_" + std::to_string(ID++);
-
-    std::vector<uint8_t> vec(nb_bytes);
-    this->data_[id] = vec;
+    std::string id =
+        std::to_string(node_rank) + "_" + std::to_string(this->next_id_);
+    if (!this->place(id, nb_bytes, nb_bytes, zero)) return std::string();
 
+    ++this->next_id_;
     return id;
   }
 
+  bool
+  Memory::place(const std::string& id, size_t nb_bytes, size_t capacity,
+                bool zero)
+  {
+    // The slave is the only one knowing exactly how much memory is used,
+    // the master can not be trusted here.
+    if (this->max_memory_ &&
+        this->getUsed() + capacity > this->max_memory_ + this->disk_budget_)
+      return false;
+
+    auto& chunk = this->data_[id];
+    this->touch(id);
+
+    // Colder chunks are spilled to keep the new one in RAM. When they
+    // are not enough, the new chunk directly goes to disk.
+    if (!this->makeRoom(capacity, id) && !this->spill(id))
+    {
+      this->release(id);
+      return false;
+    }
+
+    try
+    {
+      // Allocates in place, to avoid copying a temporary vector.
+      chunk.reserve(capacity);
+      chunk.resize(nb_bytes, zero);
+    }
+    catch (const std::bad_alloc&)
+    {
+      this->release(id);
+      return false;
+    }
+
+    return true;
+  }
+
+  bool
+  Memory::checkpoint(const std::string& path) const
+  {
+    using namespace checkpoint;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    SlaveHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.next_id = this->next_id_;
+    header.nb_chunks = this->data_.size();
+
+    // Chunks start on a page, so that they can be mapped one by one.
+    const size_t page = sysconf(_SC_PAGESIZE);
+    const auto align = [page](size_t n) {
+      return (n + page - 1) / page * page;
+    };
+
+    std::vector<ChunkRecord> records;
+    std::vector<const Chunk*> chunks;
+    size_t offset =
+        align(sizeof(SlaveHeader) + this->data_.size() * sizeof(ChunkRecord));
+    for (const auto& pair : this->data_)
+    {
+      ChunkRecord record;
+      std::memset(&record, 0, sizeof(ChunkRecord));
+      std::memcpy(record.id, pair.first.c_str(), pair.first.length());
+      record.size = pair.second.size();
+      record.capacity = pair.second.capacity();
+      record.offset = offset;
+
+      auto it = this->history_.find(pair.first);
+      if (it != this->history_.end())
+      {
+        const auto& old_pack = std::get<0>(it->second);
+        const auto& new_pack = std::get<1>(it->second);
+        record.old_clock = std::get<0>(old_pack);
+        record.old_size = std::get<1>(old_pack);
+        record.new_clock = std::get<0>(new_pack);
+        record.new_size = std::get<1>(new_pack);
+      }
+
+      auto sparse = this->sparse_.find(pair.first);
+      if (sparse != this->sparse_.end())
+      {
+        record.sparse = 1;
+        record.nb_values = sparse->second;
+      }
+
+      records.push_back(record);
+      chunks.push_back(&pair.second);
+      offset = align(offset + record.size);
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(SlaveHeader));
+    if (records.size())
+      out.write(reinterpret_cast<const char*>(&records[0]),
+                records.size() * sizeof(ChunkRecord));
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+      out.seekp(records[i].offset);
+      out.write(reinterpret_cast<const char*>(chunks[i]->data()),
+                records[i].size);
+    }
+
+    return !!out;
+  }
+
+  bool
+  Memory::restore(const std::string& path)
+  {
+    using namespace checkpoint;
+
+    if (this->data_.size()) return false;
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) return false;
+
+    struct stat st;
+    size_t size = (fstat(fd, &st) == 0) ? st.st_size : 0;
+    void* map = (size >= sizeof(SlaveHeader))
+                    ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0)
+                    : MAP_FAILED;
+    close(fd);
+    if (map == MAP_FAILED) return false;
+
+    // Chunks are copied one after another, the kernel can read ahead.
+    madvise(map, size, MADV_SEQUENTIAL);
+    const auto* base = static_cast<const uint8_t*>(map);
+
+    SlaveHeader header;
+    std::memcpy(&header, base, sizeof(SlaveHeader));
+    const size_t table_end =
+        sizeof(SlaveHeader) + header.nb_chunks * sizeof(ChunkRecord);
+    bool success = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                   table_end <= size;
+
+    for (size_t i = 0; success && i < header.nb_chunks; ++i)
+    {
+      ChunkRecord record;
+      const size_t position = sizeof(SlaveHeader) + i * sizeof(ChunkRecord);
+      std::memcpy(&record, base + position, sizeof(ChunkRecord));
+      record.id[constant::ID_LEN - 1] = '\0';
+      std::string id(record.id);
+
+      success = record.offset + record.size <= size &&
+                this->place(id, record.size,
+                            std::max(record.size, record.capacity));
+      if (!success) break;
+
+      if (record.size)
+        std::memcpy(this->data_[id].data(), base + record.offset, record.size);
+      this->history_[id] = std::make_tuple(
+          std::make_tuple(record.old_clock, (int)record.old_size),
+          std::make_tuple(record.new_clock, (int)record.new_size));
+      if (record.sparse) this->sparse_[id] = record.nb_values;
+    }
+    munmap(map, size);
+
+    if (!success)
+    {
+      this->release();
+      return false;
+    }
+    this->next_id_ =
+        std::max(this->next_id_, (unsigned long long)header.next_id);
+
+    return true;
+  }
+
+  bool
+  Memory::resize(const std::string& id, size_t nb_bytes, size_t capacity)
+  {
+    if (!this->data_.count(id)) return false;
+
+    auto& var = this->data_[id];
+    size_t new_capacity = std::max({capacity, nb_bytes, var.capacity()});
+    size_t extra = new_capacity - var.capacity();
+    if (this->max_memory_ &&
+        this->getUsed() + extra > this->max_memory_ + this->disk_budget_)
+      return false;
+    this->touch(id);
+
+    if (!var.isSpilled() && !this->makeRoom(extra, id) && !this->spill(id))
+      return false;
+
+    try
+    {
+      // Reserving the capacity first makes the growth geometric,
+      // the chunk is not reallocated at each append.
+      var.reserve(capacity);
+      var.resize(nb_bytes);
+    }
+    catch (const std::bad_alloc&)
+    {
+      return false;
+    }
+
+    return true;
+  }
+
+  bool
+  Memory::configure(const NodeConfig& config)
+  {
+    std::string dir(config.scratch_dir,
+                    strnlen(config.scratch_dir, constant::PATH_LEN));
+    if (config.disk_budget && access(dir.c_str(), W_OK) != 0) return false;
+
+    this->disk_budget_ = config.disk_budget;
+    this->scratch_dir_ = dir;
+
+    return true;
+  }
+
+  Chunk&
+  Memory::fetch(const std::string& id, bool sequential)
+  {
+    auto& chunk = this->get(id);
+    if (chunk.isSpilled() && this->makeRoom(chunk.capacity(), id))
+      chunk.load();
+
+    // The kernel reads ahead, and drops the pages already accessed.
+    if (sequential) chunk.advise(MADV_SEQUENTIAL);
+
+    return chunk;
+  }
+
+  void
+  Memory::touch(const std::string& id)
+  {
+    auto it = this->lru_pos_.find(id);
+    if (it != this->lru_pos_.end())
+      this->lru_.splice(this->lru_.begin(), this->lru_, it->second);
+    else
+    {
+      this->lru_.push_front(id);
+      this->lru_pos_[id] = this->lru_.begin();
+    }
+  }
+
+  bool
+  Memory::makeRoom(size_t nb_bytes, const std::string& id)
+  {
+    if (this->max_memory_ == 0) return true;
+
+    size_t in_ram = this->getUsed() - this->getSpilled();
+
+    // Walks from the least recently used chunk.
+    for (auto it = this->lru_.rbegin();
+         it != this->lru_.rend() && in_ram + nb_bytes > this->max_memory_; ++it)
+    {
+      if (*it == id) continue;
+
+      const auto& chunk = this->data_[*it];
+      size_t bytes = chunk.capacity();
+      if (chunk.isSpilled() || bytes == 0 || !this->spill(*it)) continue;
+
+      in_ram -= bytes;
+    }
+
+    return in_ram + nb_bytes <= this->max_memory_;
+  }
+
+  bool
+  Memory::spill(const std::string& id)
+  {
+    if (this->scratch_dir_.empty()) return false;
+
+    // The process identifier avoids collisions between runs sharing
+    // the same directory.
+    std::string path = this->scratch_dir_ + "/algorep_" +
+                       std::to_string(getpid()) + "_" + id + ".chunk";
+
+    return this->data_[id].spill(path);
+  }
+
+  size_t
+  Memory::getSpilled() const
+  {
+    size_t spilled = 0;
+    for (const auto& pair : this->data_)
+      if (pair.second.isSpilled()) spilled += pair.second.capacity();
+
+    return spilled;
+  }
+
+  size_t
+  Memory::getUsed() const
+  {
+    size_t used = 0;
+    for (const auto& pair : this->data_) used += pair.second.capacity();
+
+    return used;
+  }
+
+  NodeStatus
+  Memory::getStatus(bool success) const
+  {
+    NodeStatus status;
+    status.status = (success) ? constant::SUCCESS : constant::FAIL;
+    status.nb_chunks = this->data_.size();
+    status.used = 0;
+    status.slack = 0;
+    for (const auto& pair : this->data_)
+    {
+      status.used += pair.second.capacity();
+      status.slack += pair.second.capacity() - pair.second.size();
+    }
+    status.spilled = this->getSpilled();
+
+    // The second value of `statm' is the number of resident pages.
+    status.resident = 0;
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0;
+    if (statm >> pages >> pages)
+      status.resident = pages * sysconf(_SC_PAGESIZE);
+
+    status.arena_free = 0;
+#if defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    status.arena_free = mallinfo2().fordblks;
+#endif
+
+    return status;
+  }
+
   void
   Memory::release()
   {
     for (auto& pair : this->data_) pair.second.clear();
+    this->data_.clear();
+    this->history_.clear();
+    this->sparse_.clear();
+    this->tables_.clear();
+    this->lru_.clear();
+    this->lru_pos_.clear();
   }
 
   void
@@ -28,5 +368,15 @@ namespace algorep
       this->data_[id].clear();
       this->data_.erase(id);
     }
+    this->history_.erase(id);
+    this->sparse_.erase(id);
+    this->tables_.erase(id);
+
+    auto it = this->lru_pos_.find(id);
+    if (it != this->lru_pos_.end())
+    {
+      this->lru_.erase(it->second);
+      this->lru_pos_.erase(it);
+    }
   }
 }  // namespace algorep
@@ -0,0 +1,49 @@
+#include <cstring>
+
+#include <constant/constants.h>
+#include <data/operation.h>
+
+namespace algorep
+{
+  Operation::~Operation()
+  {
+    for (auto& req : this->sends_) MPI_Request_free(&req);
+    for (auto& req : this->recvs_) MPI_Request_free(&req);
+    for (auto& type : this->types_) MPI_Type_free(&type);
+  }
+
+  void
+  Operation::start()
+  {
+    // A write has to be sent with a new clock each time, otherwise
+    // slaves would consider the message as an old one.
+    if (this->clock_)
+    {
+      for (auto& header : this->headers_)
+        std::memcpy(&header[0] + constant::ID_LEN, this->clock_,
+                    sizeof(size_t));
+      (*this->clock_)++;
+    }
+
+    // Receives are posted first, so that the acknowledges
+    // never have to be buffered by the MPI implementation.
+    if (this->recvs_.size())
+      MPI_Startall(this->recvs_.size(), &this->recvs_[0]);
+    if (this->sends_.size())
+      MPI_Startall(this->sends_.size(), &this->sends_[0]);
+  }
+
+  bool
+  Operation::wait()
+  {
+    if (this->sends_.size())
+      MPI_Waitall(this->sends_.size(), &this->sends_[0], MPI_STATUSES_IGNORE);
+    if (this->recvs_.size())
+      MPI_Waitall(this->recvs_.size(), &this->recvs_[0], MPI_STATUSES_IGNORE);
+
+    for (const auto& ack : this->acks_)
+      if (ack != constant::SUCCESS) return false;
+
+    return true;
+  }
+}  // namespace algorep
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#include <data/sketch.h>
+
+namespace algorep
+{
+  QuantileSketch::QuantileSketch(size_t accuracy)
+      : accuracy_{std::max<size_t>(accuracy, 2)}, count_{0}, levels_(1),
+        odd_{false}
+  {
+  }
+
+  void
+  QuantileSketch::add(double value, uint64_t count)
+  {
+    this->count_ += count;
+
+    // Copies are spread on the levels, following the bits of their number.
+    bool full = false;
+    for (size_t level = 0; count; ++level, count >>= 1)
+    {
+      if (!(count & 1)) continue;
+      if (level >= this->levels_.size()) this->levels_.resize(level + 1);
+      this->levels_[level].push_back(value);
+      full = full || this->levels_[level].size() > this->capacity(level);
+    }
+
+    if (full) this->compress();
+  }
+
+  void
+  QuantileSketch::merge(const QuantileSketch& other)
+  {
+    if (other.levels_.size() > this->levels_.size())
+      this->levels_.resize(other.levels_.size());
+
+    for (size_t level = 0; level < other.levels_.size(); ++level)
+    {
+      const auto& values = other.levels_[level];
+      this->levels_[level].insert(this->levels_[level].end(), values.begin(),
+                                  values.end());
+    }
+    this->count_ += other.count_;
+    this->compress();
+  }
+
+  double
+  QuantileSketch::quantile(double q) const
+  {
+    if (this->count_ == 0) return 0;
+
+    std::vector<std::pair<double, uint64_t>> weighted;
+    weighted.reserve(this->getSize());
+    for (size_t level = 0; level < this->levels_.size(); ++level)
+    {
+      for (const auto& value : this->levels_[level])
+        weighted.emplace_back(value, uint64_t(1) << level);
+    }
+    std::sort(weighted.begin(), weighted.end());
+
+    // Looks for the first value whose rank reaches the quantile.
+    const double rank = std::min(std::max(q, 0.0), 1.0) * this->count_;
+    uint64_t cumulated = 0;
+    for (const auto& item : weighted)
+    {
+      cumulated += item.second;
+      if (cumulated > rank) return item.first;
+    }
+
+    return weighted.back().first;
+  }
+
+  size_t
+  QuantileSketch::getSize() const
+  {
+    size_t size = 0;
+    for (const auto& level : this->levels_) size += level.size();
+    return size;
+  }
+
+  void
+  QuantileSketch::serialize(std::vector<uint8_t>& out) const
+  {
+    // The sketch is written with this layout:
+    //  sizeof (uint64_t) * 3           L * sizeof (uint64_t)   N * 8
+    // [Accuracy, Count, NB_LEVELS]     [....Level sizes....]   [Values]
+    std::vector<uint64_t> header = {this->accuracy_, this->count_,
+                                    this->levels_.size()};
+    for (const auto& level : this->levels_) header.push_back(level.size());
+
+    out.resize(header.size() * sizeof(uint64_t) +
+               this->getSize() * sizeof(double));
+    std::memcpy(&out[0], &header[0], header.size() * sizeof(uint64_t));
+
+    uint8_t* values = &out[0] + header.size() * sizeof(uint64_t);
+    for (const auto& level : this->levels_)
+    {
+      if (level.empty()) continue;
+      std::memcpy(values, &level[0], level.size() * sizeof(double));
+      values += level.size() * sizeof(double);
+    }
+  }
+
+  bool
+  QuantileSketch::deserialize(const uint8_t* data, size_t nb_bytes)
+  {
+    uint64_t header[3];
+    if (nb_bytes < sizeof(header)) return false;
+    std::memcpy(header, data, sizeof(header));
+
+    // A sketch never has more levels than bits in its count.
+    const uint64_t nb_levels = header[2];
+    if (nb_levels == 0 || nb_levels > 64) return false;
+
+    const size_t sizes_len = sizeof(header) + nb_levels * sizeof(uint64_t);
+    if (nb_bytes < sizes_len) return false;
+    std::vector<uint64_t> sizes(nb_levels);
+    std::memcpy(&sizes[0], data + sizeof(header),
+                nb_levels * sizeof(uint64_t));
+
+    size_t nb_values = 0;
+    for (const auto& size : sizes) nb_values += size;
+    if (nb_bytes != sizes_len + nb_values * sizeof(double)) return false;
+
+    this->accuracy_ = std::max<size_t>(header[0], 2);
+    this->count_ = header[1];
+    this->levels_.assign(nb_levels, std::vector<double>());
+
+    const uint8_t* values = data + sizes_len;
+    for (size_t level = 0; level < nb_levels; ++level)
+    {
+      this->levels_[level].resize(sizes[level]);
+      if (sizes[level] == 0) continue;
+      std::memcpy(&this->levels_[level][0], values,
+                  sizes[level] * sizeof(double));
+      values += sizes[level] * sizeof(double);
+    }
+
+    return true;
+  }
+
+  size_t
+  QuantileSketch::capacity(size_t level) const
+  {
+    // Each level holds two thirds of the values of the level above it.
+    const size_t depth = this->levels_.size() - 1 - level;
+    const double capacity = this->accuracy_ * std::pow(2. / 3., depth);
+    return std::max<size_t>(std::ceil(capacity), 2);
+  }
+
+  void
+  QuantileSketch::compress()
+  {
+    for (size_t level = 0; level < this->levels_.size(); ++level)
+    {
+      if (this->levels_[level].size() <= this->capacity(level)) continue;
+      if (level + 1 == this->levels_.size())
+        this->levels_.resize(this->levels_.size() + 1);
+
+      // An odd value out stays on its level, so that the total weight
+      // is kept exactly.
+      auto& values = this->levels_[level];
+      std::sort(values.begin(), values.end());
+      double leftover = 0;
+      const bool has_leftover = values.size() % 2;
+      if (has_leftover)
+      {
+        leftover = values.back();
+        values.pop_back();
+      }
+
+      auto& next = this->levels_[level + 1];
+      for (size_t i = this->odd_; i < values.size(); i += 2)
+        next.push_back(values[i]);
+      this->odd_ = !this->odd_;
+
+      values.clear();
+      if (has_leftover) values.push_back(leftover);
+    }
+  }
+}  // namespace algorep
@@ -0,0 +1,88 @@
+#include <algorithm>
+
+#include <data/table.h>
+
+namespace algorep
+{
+  constexpr uint64_t TableIndex::NONE;
+
+  void
+  TableIndex::build(const uint8_t* keys, size_t key_size, size_t nb_keys)
+  {
+    size_t nb_slots = 16;
+    while (nb_slots < 2 * nb_keys) nb_slots *= 2;
+
+    this->slots_.assign(nb_slots, Slot{0, NONE});
+    this->nb_keys_ = 0;
+    for (size_t i = 0; i < nb_keys; ++i)
+      this->set(table::keyBits(keys + i * key_size, key_size), i);
+  }
+
+  uint64_t
+  TableIndex::find(uint64_t key) const
+  {
+    if (this->slots_.empty()) return NONE;
+    return this->slots_[this->probe(key)].position;
+  }
+
+  void
+  TableIndex::set(uint64_t key, uint64_t position)
+  {
+    if (2 * (this->nb_keys_ + 1) > this->slots_.size())
+      this->rehash(std::max<size_t>(16, 2 * this->slots_.size()));
+
+    auto& slot = this->slots_[this->probe(key)];
+    if (slot.position == NONE) ++this->nb_keys_;
+    slot.key = key;
+    slot.position = position;
+  }
+
+  void
+  TableIndex::erase(uint64_t key)
+  {
+    if (this->slots_.empty()) return;
+
+    size_t hole = this->probe(key);
+    if (this->slots_[hole].position == NONE) return;
+
+    // Slots following the hole move back into it, unless their probe
+    // starts after the hole.
+    const size_t mask = this->slots_.size() - 1;
+    for (size_t i = (hole + 1) & mask; this->slots_[i].position != NONE;
+         i = (i + 1) & mask)
+    {
+      const size_t start = hashing::hash(this->slots_[i].key) & mask;
+      const bool stays = (hole < i) ? (start > hole && start <= i)
+                                    : (start > hole || start <= i);
+      if (stays) continue;
+
+      this->slots_[hole] = this->slots_[i];
+      hole = i;
+    }
+
+    this->slots_[hole].position = NONE;
+    --this->nb_keys_;
+  }
+
+  size_t
+  TableIndex::probe(uint64_t key) const
+  {
+    const size_t mask = this->slots_.size() - 1;
+    size_t i = hashing::hash(key) & mask;
+    while (this->slots_[i].position != NONE && this->slots_[i].key != key)
+      i = (i + 1) & mask;
+    return i;
+  }
+
+  void
+  TableIndex::rehash(size_t nb_slots)
+  {
+    std::vector<Slot> slots(nb_slots, Slot{0, NONE});
+    slots.swap(this->slots_);
+    this->nb_keys_ = 0;
+    for (const auto& slot : slots)
+    {
+      if (slot.position != NONE) this->set(slot.key, slot.position);
+    }
+  }
+}  // namespace algorep
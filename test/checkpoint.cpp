@@ -0,0 +1,108 @@
+#include <algorep.h>
+#include <cstdio>
+#include <iostream>
+
+#include <unistd.h>
+
+#include "utils/utils.h"
+
+using namespace algorep::callback;
+
+namespace
+{
+  constexpr size_t MAX_MEMORY = 64;
+
+  bool
+  check_values(Allocator& allocator, algorep::BaseElement* elt,
+               const std::vector<int>& expected)
+  {
+    auto* var = allocator.view<int>(elt);
+    int* read = allocator.read<int>(var);
+    bool success = (elt->getNbValues() == expected.size());
+    for (size_t i = 0; success && i < expected.size(); ++i)
+      success = (read[i] == expected[i]);
+
+    delete[] read;
+    allocator.free(var);
+    return success;
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+  const std::string dir = "/tmp/algorep_ckpt_" + std::to_string(getpid());
+
+  std::vector<int> ints(30);
+  for (size_t i = 0; i < ints.size(); ++i) ints[i] = i * 7 - 50;
+  std::vector<int> small = {4, 8, 15, 16, 23};
+
+  // Elements restore would not rebuild are refused.
+  auto* sparse = allocator->reserveSparse<int>(10, {2}, &small[0]);
+  bool refused = sparse && !allocator->checkpoint(dir);
+  if (sparse) allocator->free(sparse);
+  auto* mat = allocator->reserveMatrix<int>(2, 2, &small[0]);
+  refused = refused && mat && !allocator->checkpoint(dir);
+  if (mat) allocator->free(mat);
+  tests_passed += refused && access(dir.c_str(), F_OK) != 0;
+
+  // The second element has a partially filled last chunk.
+  auto* first = allocator->reserve<int>(ints.size(), &ints[0]);
+  auto* second = allocator->reserve<int>(small.size(), &small[0]);
+  allocator->append<int>(second, &ints[0], 3);
+  small.insert(small.end(), ints.begin(), ints.begin() + 3);
+
+  tests_passed += allocator->checkpoint(dir);
+  allocator->free(first);
+  allocator->free(second);
+
+  auto elements = allocator->restore(dir);
+  bool success = (elements.size() == 2);
+  success = success && check_values(*allocator, elements[0], ints);
+  success = success && check_values(*allocator, elements[1], small);
+  tests_passed += success;
+
+  // Restored chunks are written as usual.
+  if (elements.size() == 2)
+  {
+    auto* var = allocator->view<int>(elements[0]);
+    std::vector<int> expected(ints.rbegin(), ints.rend());
+    bool written = allocator->write<int>(var, &expected[0]);
+    allocator->free(var);
+    tests_passed += written && check_values(*allocator, elements[0], expected);
+  }
+
+  // Elements are already allocated.
+  tests_passed += allocator->restore(dir).empty();
+  for (auto* elt : elements) allocator->free(elt);
+
+  // The checkpoint does not exist.
+  tests_passed += allocator->restore(dir + "_missing").empty();
+
+  std::remove(algorep::checkpoint::getPath(dir, 0).c_str());
+  for (int rank = 1; rank <= allocator->getNbNodes(); ++rank)
+    std::remove(algorep::checkpoint::getPath(dir, rank).c_str());
+  rmdir(dir.c_str());
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 6, "> Checkpoint <");
+}
+
+int
+main(int argc, char** argv)
+{
+  algorep::init(argc, argv);
+
+  const auto& callback = std::function<void()>(run);
+  // Small memory per slave, to split the data on several slaves.
+  algorep::run(callback, MAX_MEMORY);
+
+  // This is in charge of liberating some allocated
+  // memory.
+  algorep::terminate();
+}
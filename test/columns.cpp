@@ -0,0 +1,203 @@
+#include <algorep.h>
+#include <iostream>
+
+#include "utils/utils.h"
+
+using namespace algorep::callback;
+
+namespace
+{
+  constexpr size_t MAX_MEMORY = 1024;
+
+  // Padded to 24 bytes, stored as 14 bytes per record.
+  struct Student
+  {
+    int age;
+    double grade;
+    short year;
+  };
+}
+
+ALGOREP_FIELDS(Student, &Student::age, &Student::grade, &Student::year)
+
+namespace
+{
+  constexpr size_t NB_STUDENTS = 150;
+  constexpr size_t RECORD_SIZE = sizeof(int) + sizeof(double) + sizeof(short);
+
+  std::vector<Student>
+  make_students()
+  {
+    std::vector<Student> students(NB_STUDENTS);
+    for (size_t i = 0; i < students.size(); ++i)
+    {
+      students[i].age = 18 + i % 10;
+      students[i].grade = i * 0.5;
+      students[i].year = 2000 + i;
+    }
+    return students;
+  }
+
+  bool
+  equals(const Student& a, const Student& b)
+  {
+    return a.age == b.age && a.grade == b.grade && a.year == b.year;
+  }
+
+  unsigned int
+  check_layout()
+  {
+    const auto& fields = algorep::fields::layout<Student>();
+    bool success = fields.size() == 3;
+    success = success && algorep::fields::recordSize(fields) == RECORD_SIZE;
+    success = success && algorep::fields::findColumn(&Student::age) == 0;
+    success = success && algorep::fields::findColumn(&Student::year) ==
+                             sizeof(int) + sizeof(double);
+
+    // Columns are rebuilt into the same records.
+    const auto& students = make_students();
+    std::vector<uint8_t> columns(students.size() * RECORD_SIZE);
+    algorep::fields::toColumns(&students[0], students.size(), &columns[0]);
+    std::vector<Student> out(students.size());
+    algorep::fields::fromColumns(&columns[0], out.size(), &out[0]);
+    for (size_t i = 0; success && i < out.size(); ++i)
+      success = equals(out[i], students[i]);
+
+    // The second column starts with the grade of the first record.
+    double grade = -1;
+    std::memcpy(&grade, &columns[students.size() * sizeof(int)],
+                sizeof(double));
+    return success && grade == students[0].grade;
+  }
+
+  unsigned int
+  check_reserve(Allocator& allocator)
+  {
+    const auto& students = make_students();
+    auto* var = allocator.reserveColumns<Student>(students.size(),
+                                                  &students[0]);
+    if (var == nullptr) return 0;
+
+    // Records are split on several slaves, without their padding.
+    size_t used = 0;
+    for (const auto& status : allocator.queryMemoryStatus())
+      used += status.used;
+    bool success = var->getIds().size() > 1;
+    success = success && used == students.size() * RECORD_SIZE;
+
+    Student* read = allocator.read<Student>(var);
+    for (size_t i = 0; success && i < students.size(); ++i)
+      success = equals(read[i], students[i]);
+
+    return finishTest(success, allocator, var, read);
+  }
+
+  unsigned int
+  check_read_field(Allocator& allocator)
+  {
+    const auto& students = make_students();
+    auto* var = allocator.reserveColumns<Student>(students.size(),
+                                                  &students[0]);
+    if (var == nullptr) return 0;
+
+    short* years = allocator.readField(var, &Student::year);
+    bool success = years != nullptr;
+    for (size_t i = 0; success && i < students.size(); ++i)
+      success = (years[i] == students[i].year);
+    delete[] years;
+
+    // Records stored as is have no column.
+    auto* dense = allocator.reserve<Student>(2, &students[0]);
+    success = success && allocator.readField(dense, &Student::age) == nullptr;
+    allocator.free(dense);
+
+    return finishTest<Student>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_map_field(Allocator& allocator)
+  {
+    const auto& students = make_students();
+    auto* var = allocator.reserveColumns<Student>(students.size(),
+                                                  &students[0]);
+    if (var == nullptr) return 0;
+
+    // Only the ages are negated.
+    allocator.mapField(var, &Student::age, MapID::I_NEGATE);
+
+    Student* read = allocator.read<Student>(var);
+    bool success = true;
+    for (size_t i = 0; success && i < students.size(); ++i)
+    {
+      Student expected = students[i];
+      expected.age = -expected.age;
+      success = equals(read[i], expected);
+    }
+
+    return finishTest(success, allocator, var, read);
+  }
+
+  unsigned int
+  check_reduce_field(Allocator& allocator)
+  {
+    const auto& students = make_students();
+    auto* var = allocator.reserveColumns<Student>(students.size(),
+                                                  &students[0]);
+    if (var == nullptr) return 0;
+
+    double expected_grade = 0;
+    int expected_age = 0;
+    for (const auto& student : students)
+    {
+      expected_grade += student.grade;
+      expected_age += student.age;
+    }
+
+    double* grade = allocator.reduceField(var, &Student::grade,
+                                          ReduceID::D_SUM);
+    int* age = allocator.reduceField(var, &Student::age, ReduceID::I_SUM);
+    bool success = grade && *grade == expected_grade;
+    success = success && age && *age == expected_age;
+    delete grade;
+    delete age;
+
+    // Dense operations are not available on records stored by columns.
+    success = success && !allocator.write<Student>(var, &students[0]);
+    success = success && allocator.view<Student>(var) == nullptr;
+
+    return finishTest<Student>(success, allocator, var, nullptr);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  tests_passed += check_layout();
+  tests_passed += check_reserve(*allocator);
+  tests_passed += check_read_field(*allocator);
+  tests_passed += check_map_field(*allocator);
+  tests_passed += check_reduce_field(*allocator);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 5, "> Columns <");
+}
+
+int
+main(int argc, char** argv)
+{
+  algorep::init(argc, argv);
+
+  const auto& callback = std::function<void()>(run);
+  // Small slaves, so that records are split on several of them.
+  algorep::run(callback, MAX_MEMORY);
+
+  // This is in charge of liberating some allocated
+  // memory.
+  algorep::terminate();
+}
@@ -0,0 +1,134 @@
+#include <algorep.h>
+#include <cstdlib>
+#include <iostream>
+
+#include "utils/utils.h"
+
+using namespace algorep::callback;
+
+namespace
+{
+  constexpr size_t MAX_MEMORY = 8192;
+
+  template <typename T>
+  size_t
+  encoded_size(const std::vector<T>& in, unsigned int& codec)
+  {
+    std::vector<uint8_t> out;
+    algorep::codec::encode(reinterpret_cast<const uint8_t*>(&in[0]),
+                           in.size() * sizeof(T),
+                           algorep::file::HeaderType<T>::value, sizeof(T), 0,
+                           out);
+
+    // Every payload can be decoded, whatever its encoding.
+    std::vector<T> decoded(in.size());
+    bool success = algorep::codec::decode(
+        &out[0], out.size(), reinterpret_cast<uint8_t*>(&decoded[0]),
+        decoded.size() * sizeof(T));
+    if (!success || decoded != in) return 0;
+
+    algorep::codec::CodecHeader header;
+    algorep::codec::readHeader(&out[0], out.size(), header);
+    codec = header.codec;
+    return out.size();
+  }
+
+  template <typename T>
+  unsigned int
+  check_ratio(const std::vector<T>& in, unsigned int expected)
+  {
+    unsigned int codec = algorep::codec::RAW;
+    size_t size = encoded_size(in, codec);
+
+    // Several times fewer bytes go on the wire.
+    return size != 0 && codec == expected &&
+           size * 3 < in.size() * sizeof(T);
+  }
+
+  template <typename T>
+  unsigned int
+  check_transfer(Allocator& allocator, const std::vector<T>& in)
+  {
+    auto* var = allocator.reserve<T>(in.size(), &in[0]);
+    if (var == nullptr) return 0;
+
+    // Every chunk is written back in reverse order.
+    std::vector<T> reversed(in.rbegin(), in.rend());
+    bool success = allocator.write<T>(var, &reversed[0]);
+
+    T* read = allocator.read<T>(var);
+    success = success && read != nullptr;
+    for (size_t i = 0; success && i < in.size(); ++i)
+      success = (read[i] == reversed[i]);
+
+    return finishTest(success, allocator, var, read);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  // Sorted identifiers, with small gaps.
+  std::vector<int> ids(2000);
+  for (size_t i = 0; i < ids.size(); ++i) ids[i] = 1000 + i * 3 + (i % 5);
+  // A sparse array, mostly made of zeros.
+  std::vector<long> sparse(2000, 0);
+  for (size_t i = 0; i < sparse.size(); i += 97) sparse[i] = i * 123456789;
+  // Smooth values, sharing their exponents.
+  std::vector<double> smooth(2000);
+  for (size_t i = 0; i < smooth.size(); ++i) smooth[i] = 1.0 + (i % 64) / 8.;
+  // Noise does not compress, and is sent raw.
+  std::vector<unsigned int> noise(2000);
+  for (size_t i = 0; i < noise.size(); ++i) noise[i] = std::rand();
+
+  tests_passed += check_ratio(ids, algorep::codec::DELTA_VARINT);
+  tests_passed += check_ratio(sparse, algorep::codec::ZERO_RLE);
+  tests_passed += check_ratio(smooth, algorep::codec::SHUFFLE_LZ);
+
+  unsigned int codec = algorep::codec::DELTA_VARINT;
+  size_t size = encoded_size(noise, codec);
+  tests_passed += (codec == algorep::codec::RAW) &&
+                  (size == sizeof(algorep::codec::CodecHeader) +
+                               noise.size() * sizeof(unsigned int));
+
+  // A truncated payload is rejected.
+  std::vector<uint8_t> out;
+  algorep::codec::encode(reinterpret_cast<const uint8_t*>(&ids[0]),
+                         ids.size() * sizeof(int), algorep::DataType::INT,
+                         sizeof(int), 0, out);
+  std::vector<int> decoded(ids.size());
+  tests_passed += !algorep::codec::decode(
+      &out[0], out.size() / 2, reinterpret_cast<uint8_t*>(&decoded[0]),
+      decoded.size() * sizeof(int));
+
+  // Payloads of the allocator are compressed transparently.
+  allocator->setCompression(64);
+  tests_passed += check_transfer<int>(*allocator, ids);
+  tests_passed += check_transfer<long>(*allocator, sparse);
+  tests_passed += check_transfer<double>(*allocator, smooth);
+  tests_passed += check_transfer<unsigned int>(*allocator, noise);
+  allocator->setCompression(0);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 9, "> Compression <");
+}
+
+int
+main(int argc, char** argv)
+{
+  algorep::init(argc, argv);
+
+  const auto& callback = std::function<void()>(run);
+  // Chunks of a few kilobytes, to split the data on several slaves.
+  algorep::run(callback, MAX_MEMORY);
+
+  // This is in charge of liberating some allocated
+  // memory.
+  algorep::terminate();
+}
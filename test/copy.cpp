@@ -0,0 +1,113 @@
+#include <algorep.h>
+#include <iostream>
+
+#include "utils/utils.h"
+
+namespace
+{
+  constexpr size_t MAX_MEMORY = 96;
+
+  unsigned long long
+  free_memory(const Allocator& allocator)
+  {
+    unsigned long long total = 0;
+    for (const auto& bytes : allocator.getMemoryStatus()) total += bytes;
+    return total;
+  }
+
+  template <typename T>
+  bool
+  check_content(Allocator& allocator, const algorep::Element<T>* var,
+                const std::vector<T>& expected)
+  {
+    T* read = allocator.read<T>(var);
+    size_t i = 0;
+    for (; i < expected.size(); ++i)
+    {
+      if (read[i] != expected[i]) break;
+    }
+    delete[] read;
+
+    return i == expected.size();
+  }
+
+  unsigned int
+  check_copy(Allocator& allocator, const std::vector<int>& in)
+  {
+    auto* src = allocator.reserve<int>(in.size(), &in[0]);
+    auto* dst = allocator.reserveUninitialized<int>(in.size() + 2);
+
+    // Layouts are different, fragments are cut at each bound.
+    bool success = src->getIds().size() != dst->getIds().size();
+    success = allocator.copy<int>(src, dst) && success;
+    success = success && check_content<int>(allocator, src, in);
+
+    int* read = allocator.read<int>(dst);
+    for (size_t i = 0; i < in.size(); ++i)
+      success = success && (read[i] == in[i]);
+    delete[] read;
+
+    // Too large for the destination.
+    success = success && !allocator.copy<int>(dst, src);
+
+    allocator.free(src);
+    allocator.free(dst);
+
+    return success;
+  }
+
+  unsigned int
+  check_repartition(Allocator& allocator, const std::vector<double>& in)
+  {
+    auto* var = allocator.reserve<double>(in.size(), &in[0]);
+    unsigned long long free_bytes = free_memory(allocator);
+
+    bool success = allocator.repartition(var, algorep::Layout::BALANCED);
+    success = success && (var->getIds().size() == 3);
+    success = success && check_content<double>(allocator, var, in);
+
+    success = allocator.repartition(var, algorep::Layout::PACKED) && success;
+    success = success && (var->getIds().size() == 1);
+    success = success && check_content<double>(allocator, var, in);
+
+    success = success && (free_memory(allocator) == free_bytes);
+    allocator.free(var);
+
+    return success;
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  std::vector<int> ints(20);
+  for (size_t i = 0; i < ints.size(); ++i) ints[i] = i * 7 - 30;
+  std::vector<double> doubles(9);
+  for (size_t i = 0; i < doubles.size(); ++i) doubles[i] = i * 1.5;
+
+  tests_passed += check_copy(*allocator, ints);
+  tests_passed += check_repartition(*allocator, doubles);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 2, "> Copy and repartition <");
+}
+
+int
+main(int argc, char** argv)
+{
+  algorep::init(argc, argv);
+
+  const auto& callback = std::function<void()>(run);
+  // Small memory per slave, to split the data on several slaves.
+  algorep::run(callback, MAX_MEMORY);
+
+  // This is in charge of liberating some allocated
+  // memory.
+  algorep::terminate();
+}
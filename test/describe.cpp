@@ -0,0 +1,160 @@
+#include <algorep.h>
+#include <cmath>
+#include <iostream>
+
+#include "utils/utils.h"
+
+namespace
+{
+  struct Sample
+  {
+    short id;
+    float value;
+  };
+}
+
+ALGOREP_FIELDS(Sample, &Sample::id, &Sample::value)
+
+namespace
+{
+  template <typename T>
+  algorep::Statistics
+  expected(const std::vector<T>& in)
+  {
+    algorep::Statistics stats = algorep::Statistics();
+    stats.count = in.size();
+    stats.min = *std::min_element(in.begin(), in.end());
+    stats.max = *std::max_element(in.begin(), in.end());
+    for (const auto& v : in) stats.sum += v;
+    stats.mean = stats.sum / in.size();
+    for (const auto& v : in) stats.m2 += (v - stats.mean) * (v - stats.mean);
+    return stats;
+  }
+
+  bool
+  near(double a, double b)
+  {
+    return std::abs(a - b) <= 1e-9 * std::max(1.0, std::abs(b));
+  }
+
+  bool
+  matches(const algorep::Statistics& a, const algorep::Statistics& b)
+  {
+    return a.count == b.count && a.min == b.min && a.max == b.max &&
+           near(a.sum, b.sum) && near(a.mean, b.mean) && near(a.m2, b.m2);
+  }
+
+  template <typename T>
+  unsigned int
+  check_describe(Allocator& allocator, const std::vector<T>& in)
+  {
+    auto* var = allocator.reserve<T>(in.size(), &in[0]);
+    if (var == nullptr) return 0;
+
+    const auto& stats = allocator.describe(var);
+    bool success = matches(stats, expected(in));
+
+    return finishTest<T>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_merge()
+  {
+    // Merging partial statistics gives the statistics of the whole set.
+    std::vector<double> in;
+    for (size_t i = 0; i < 100; ++i) in.push_back(std::sin(i) * i);
+    auto stats = expected(std::vector<double>(in.begin(), in.begin() + 3));
+    algorep::statistics::merge(
+        stats, expected(std::vector<double>(in.begin() + 3, in.end())));
+    algorep::statistics::merge(stats, algorep::Statistics());
+
+    return matches(stats, expected(in)) &&
+           near(stats.variance(), expected(in).m2 / in.size()) &&
+           near(stats.variance(true), expected(in).m2 / (in.size() - 1));
+  }
+
+  unsigned int
+  check_sparse(Allocator& allocator)
+  {
+    std::vector<size_t> indices({3, 500, 1999});
+    std::vector<int> values({-4, 10, 7});
+    auto* var = allocator.reserveSparse<int>(2000, indices, &values[0]);
+    if (var == nullptr) return 0;
+
+    // Implicit zeros are described as well.
+    std::vector<int> dense(2000, 0);
+    for (size_t i = 0; i < indices.size(); ++i) dense[indices[i]] = values[i];
+    bool success = matches(allocator.describe(var), expected(dense));
+
+    return finishTest<int>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_field(Allocator& allocator)
+  {
+    std::vector<Sample> samples(300);
+    std::vector<float> values(samples.size());
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+      samples[i].id = i;
+      samples[i].value = values[i] = (i % 17) * 0.25f;
+    }
+    auto* var = allocator.reserveColumns<Sample>(samples.size(), &samples[0]);
+    if (var == nullptr) return 0;
+
+    bool success =
+        matches(allocator.describeField(var, &Sample::value), expected(values));
+
+    return finishTest<Sample>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_empty(Allocator& allocator)
+  {
+    auto* var = allocator.reserve<double>(0, nullptr);
+    if (var == nullptr) return 0;
+
+    const auto& stats = allocator.describe(var);
+    bool success = stats.count == 0 && stats.variance() == 0;
+
+    return finishTest<double>(success, allocator, var, nullptr);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  std::vector<double> doubles(3000);
+  for (size_t i = 0; i < doubles.size(); ++i)
+    doubles[i] = std::cos(i * 0.1) * 100 - 3;
+  // Large values with a small spread lose the variance when computed
+  // with the sum of squares.
+  std::vector<double> shifted(1500);
+  for (size_t i = 0; i < shifted.size(); ++i)
+    shifted[i] = 1e9 + (i % 7) * 0.5;
+  std::vector<int> ints(2500);
+  for (size_t i = 0; i < ints.size(); ++i) ints[i] = (i * 37) % 101 - 50;
+
+  tests_passed += check_merge();
+  tests_passed += check_describe<double>(*allocator, doubles);
+  tests_passed += check_describe<double>(*allocator, shifted);
+  tests_passed += check_describe<int>(*allocator, ints);
+  tests_passed += check_sparse(*allocator);
+  tests_passed += check_field(*allocator);
+  tests_passed += check_empty(*allocator);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 7, "> Describe <");
+}
+
+int
+main(int argc, char** argv)
+{
+  return runSplit(argc, argv, run);
+}
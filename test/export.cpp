@@ -0,0 +1,114 @@
+#include <algorep.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include <unistd.h>
+
+#include "utils/utils.h"
+
+using namespace algorep::callback;
+
+namespace
+{
+  constexpr size_t MAX_MEMORY = 64;
+
+  std::string
+  temp_path(const std::string& name)
+  {
+    return "/tmp/algorep_" + std::to_string(getpid()) + "_" + name + ".bin";
+  }
+
+  template <typename T>
+  unsigned int
+  check_export(Allocator& allocator, const std::vector<T>& in)
+  {
+    auto path = temp_path("export");
+    auto* var = allocator.reserve<T>(in.size(), &in[0]);
+    bool success = allocator.writeToFile<T>(var, path);
+    allocator.free(var);
+
+    // The header describes the elements following it.
+    algorep::FileHeader header;
+    size_t size = 0;
+    success = success && algorep::file::readHeader(path, header, size);
+    success = success && (header.nb_values == in.size());
+    success = success && (header.atom_size == sizeof(T));
+    success = success &&
+              (header.data_type == algorep::file::HeaderType<T>::value);
+    success = success && (size == sizeof(header) + in.size() * sizeof(T));
+
+    // The file can be read back by the slaves.
+    var = allocator.reserveFromFile<T>(path);
+    std::remove(path.c_str());
+    if (var == nullptr) return 0;
+
+    T* read = allocator.read<T>(var);
+    for (size_t i = 0; i < in.size(); ++i)
+      success = success && (read[i] == in[i]);
+
+    return finishTest(success, allocator, var, read);
+  }
+
+  unsigned int
+  check_raw(Allocator& allocator, const std::vector<int>& in)
+  {
+    auto path = temp_path("raw");
+    auto* var = allocator.reserve<int>(in.size(), &in[0]);
+    allocator.map<int>(var, MapID::I_NEGATE);
+    bool success = allocator.writeToFile<int>(var, path, false);
+    allocator.free(var);
+
+    // A flat array, readable without the library.
+    std::vector<int> out(in.size() + 1);
+    std::ifstream file(path, std::ios::binary);
+    file.read(reinterpret_cast<char*>(&out[0]), out.size() * sizeof(int));
+    success = success && (size_t)file.gcount() == in.size() * sizeof(int);
+    for (size_t i = 0; i < in.size(); ++i)
+      success = success && (out[i] == -in[i]);
+    std::remove(path.c_str());
+
+    return success;
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  std::vector<int> ints(35);
+  for (size_t i = 0; i < ints.size(); ++i) ints[i] = i * 13 - 200;
+  std::vector<double> doubles(10);
+  for (size_t i = 0; i < doubles.size(); ++i) doubles[i] = i * -0.75;
+
+  tests_passed += check_export<int>(*allocator, ints);
+  tests_passed += check_export<double>(*allocator, doubles);
+  tests_passed += check_raw(*allocator, ints);
+
+  // The directory does not exist.
+  auto* var = allocator->reserve<int>(ints.size(), &ints[0]);
+  tests_passed += !allocator->writeToFile<int>(var, "/nonexistent/a.bin");
+  allocator->free(var);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 4, "> File export <");
+}
+
+int
+main(int argc, char** argv)
+{
+  algorep::init(argc, argv);
+
+  const auto& callback = std::function<void()>(run);
+  // Small memory per slave, to split the data on several slaves.
+  algorep::run(callback, MAX_MEMORY);
+
+  // This is in charge of liberating some allocated
+  // memory.
+  algorep::terminate();
+}
@@ -0,0 +1,104 @@
+#include <algorep.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include <unistd.h>
+
+#include "utils/utils.h"
+
+namespace
+{
+  constexpr size_t MAX_MEMORY = 64;
+
+  template <typename T>
+  std::string
+  write_file(const std::string& name, const std::vector<T>& values,
+             bool header)
+  {
+    std::string path =
+        "/tmp/algorep_" + std::to_string(getpid()) + "_" + name + ".bin";
+    std::ofstream out(path, std::ios::binary);
+    if (header)
+    {
+      algorep::FileHeader h;
+      std::memcpy(h.magic, algorep::file::MAGIC, sizeof(h.magic));
+      h.data_type = algorep::file::HeaderType<T>::value;
+      h.atom_size = sizeof(T);
+      h.nb_values = values.size();
+      out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    }
+    out.write(reinterpret_cast<const char*>(&values[0]),
+              values.size() * sizeof(T));
+
+    return path;
+  }
+
+  template <typename T>
+  unsigned int
+  check_ingest(Allocator& allocator, const std::vector<T>& in, bool header,
+               size_t offset, size_t count)
+  {
+    auto path = write_file<T>("ingest", in, header);
+    auto* var = allocator.reserveFromFile<T>(path, offset, count);
+    std::remove(path.c_str());
+    if (var == nullptr) return 0;
+
+    // Zero reads every element following the offset.
+    if (count == 0) count = in.size() - offset;
+    bool success = (var->getNbValues() == count);
+
+    T* read = allocator.read<T>(var);
+    for (size_t i = 0; success && i < count; ++i)
+      success = (read[i] == in[offset + i]);
+
+    return finishTest(success, allocator, var, read);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  std::vector<int> ints(30);
+  for (size_t i = 0; i < ints.size(); ++i) ints[i] = i * 11 - 99;
+  std::vector<double> doubles(12);
+  for (size_t i = 0; i < doubles.size(); ++i) doubles[i] = i / 4.0;
+
+  tests_passed += check_ingest<int>(*allocator, ints, false, 0, 0);
+  tests_passed += check_ingest<int>(*allocator, ints, false, 7, 18);
+  tests_passed += check_ingest<double>(*allocator, doubles, true, 0, 0);
+  tests_passed += check_ingest<double>(*allocator, doubles, true, 3, 5);
+
+  // Atom size does not match the header, and reading out of the file.
+  auto path = write_file<double>("invalid", doubles, true);
+  bool success = (allocator->reserveFromFile<int>(path) == nullptr);
+  success = success &&
+            (allocator->reserveFromFile<double>(path, 10, 5) == nullptr);
+  success = success &&
+            (allocator->reserveFromFile<double>("/nonexistent") == nullptr);
+  std::remove(path.c_str());
+  tests_passed += success;
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 5, "> File ingest <");
+}
+
+int
+main(int argc, char** argv)
+{
+  algorep::init(argc, argv);
+
+  const auto& callback = std::function<void()>(run);
+  // Small memory per slave, to split the data on several slaves.
+  algorep::run(callback, MAX_MEMORY);
+
+  // This is in charge of liberating some allocated
+  // memory.
+  algorep::terminate();
+}
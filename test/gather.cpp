@@ -0,0 +1,83 @@
+#include <algorep.h>
+#include <iostream>
+
+#include "utils/utils.h"
+
+namespace
+{
+  template <typename T>
+  unsigned int
+  check_gather(Allocator& allocator, const std::vector<T>& in,
+               const std::vector<size_t>& indices)
+  {
+    auto* var = allocator.reserve<T>(in.size(), &in[0]);
+    T* read = allocator.gather<T>(var, indices);
+
+    bool success = true;
+    for (size_t i = 0; i < indices.size(); ++i)
+      success = success && (read[i] == in[indices[i]]);
+
+    return finishTest(success, allocator, var, read);
+  }
+
+  template <typename T>
+  unsigned int
+  check_scatter(Allocator& allocator, std::vector<T> in,
+                const std::vector<size_t>& indices,
+                const std::vector<T>& values)
+  {
+    auto* var = allocator.reserve<T>(in.size(), &in[0]);
+    bool success = allocator.scatter<T>(var, indices, &values[0]);
+    for (size_t i = 0; i < indices.size(); ++i) in[indices[i]] = values[i];
+
+    T* read = allocator.read<T>(var);
+    for (size_t i = 0; i < in.size(); ++i)
+      success = success && (read[i] == in[i]);
+
+    return finishTest(success, allocator, var, read);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  std::vector<int> ints(40);
+  for (size_t i = 0; i < ints.size(); ++i) ints[i] = i * i - 100;
+  std::vector<double> doubles(20);
+  for (size_t i = 0; i < doubles.size(); ++i) doubles[i] = i * 0.25;
+
+  tests_passed += check_gather<int>(*allocator, ints, {39, 0, 17, 16, 17, 2});
+  tests_passed += check_gather<double>(*allocator, doubles, {19, 7, 8, 0});
+  tests_passed += check_scatter<int>(*allocator, ints, {3, 38, 20, 21, 0},
+                                     {-1, -2, -3, -4, -5});
+  tests_passed +=
+      check_scatter<double>(*allocator, doubles, {15, 1}, {100.5, -0.5});
+
+  // Out of bounds.
+  auto* var = allocator->reserve<int>(ints.size(), &ints[0]);
+  tests_passed += (allocator->gather<int>(var, {1, 40}) == nullptr);
+  allocator->free(var);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 5, "> Gather / Scatter <");
+}
+
+int
+main(int argc, char** argv)
+{
+  algorep::init(argc, argv);
+
+  const auto& callback = std::function<void()>(run);
+  // Small memory per slave, to split the data on several slaves.
+  algorep::run(callback, 64);
+
+  // This is in charge of liberating some allocated
+  // memory.
+  algorep::terminate();
+}
@@ -0,0 +1,115 @@
+#include <algorep.h>
+#include <iostream>
+
+#include "utils/utils.h"
+
+using namespace algorep::callback;
+
+namespace
+{
+  constexpr size_t MAX_MEMORY = 64;
+
+  bool
+  memory_is_free(const Allocator& allocator)
+  {
+    for (const auto& bytes : allocator.getMemoryStatus())
+      if (bytes != MAX_MEMORY) return false;
+    return true;
+  }
+
+  bool
+  memory_is_bounded(const Allocator& allocator)
+  {
+    for (const auto& bytes : allocator.getMemoryStatus())
+      if (bytes > MAX_MEMORY) return false;
+    return true;
+  }
+
+  unsigned int
+  check_append(Allocator& allocator)
+  {
+    std::vector<int> expected({1, 2});
+    auto* var = allocator.reserve<int>(expected.size(), &expected[0]);
+
+    // Grows one element at a time, until spilling on every slave.
+    bool success = true;
+    for (int i = 0; i < 38; ++i)
+    {
+      int value = i * 3 - 20;
+      expected.push_back(value);
+      success = allocator.append<int>(var, &value, 1) && success;
+      // Spare capacity never wraps the estimate of a slave around.
+      success = success && memory_is_bounded(allocator);
+    }
+    // Several values at once.
+    std::vector<int> batch({7, 8, 9, 10});
+    success = allocator.append<int>(var, &batch[0], batch.size()) && success;
+    expected.insert(expected.end(), batch.begin(), batch.end());
+
+    success = success && (var->getNbValues() == expected.size());
+    success = success && (var->getIds().size() > 1);
+
+    allocator.map<int>(var, MapID::I_NEGATE);
+    int* read = allocator.read<int>(var);
+    for (size_t i = 0; i < expected.size(); ++i)
+      success = success && (read[i] == -expected[i]);
+
+    finishTest(success, allocator, var, read);
+    return success && memory_is_free(allocator);
+  }
+
+  unsigned int
+  check_resize(Allocator& allocator)
+  {
+    std::vector<long> in({5, 6, 7});
+    auto* var = allocator.reserve<long>(in.size(), &in[0]);
+
+    bool success = allocator.resize<long>(var, 20);
+    long* sum = allocator.reduce<long>(var, ReduceID::L_SUM);
+    success = success && (*sum == 18);
+    delete[] sum;
+
+    // Shrinks below the first chunk, the other ones are freed.
+    success = allocator.resize<long>(var, 2) && success;
+    success = success && (var->getIds().size() == 1);
+    long* read = allocator.read<long>(var);
+    success = success && (read[0] == 5 && read[1] == 6);
+
+    // Too large for the network.
+    success = success && !allocator.resize<long>(var, 1000);
+    success = success && (var->getNbValues() == 2);
+
+    finishTest(success, allocator, var, read);
+    return success && memory_is_free(allocator);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  tests_passed += check_append(*allocator);
+  tests_passed += check_resize(*allocator);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 2, "> Growable elements <");
+}
+
+int
+main(int argc, char** argv)
+{
+  algorep::init(argc, argv);
+
+  const auto& callback = std::function<void()>(run);
+  // Small memory per slave, to split the data on several slaves.
+  algorep::run(callback, MAX_MEMORY);
+
+  // This is in charge of liberating some allocated
+  // memory.
+  algorep::terminate();
+}
@@ -0,0 +1,149 @@
+#include <algorep.h>
+#include <cmath>
+#include <iostream>
+
+#include "utils/utils.h"
+
+namespace
+{
+  unsigned int
+  check_distinct(Allocator& allocator)
+  {
+    std::vector<int> in(6000);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = (i * 7919) % 1500 - 700;
+    auto* var = allocator.reserve<int>(in.size(), &in[0]);
+    if (var == nullptr) return 0;
+
+    // 1500 distinct values, estimated within 5%.
+    bool success = var->getIds().size() > 1;
+    const double estimate = allocator.distinctCount(var).estimate();
+    success = success && std::abs(estimate - 1500) < 75;
+
+    return finishTest<int>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_distinct_sparse(Allocator& allocator)
+  {
+    std::vector<size_t> indices({10, 20, 400, 999});
+    std::vector<long> values({5, 5, -7, 5});
+    auto* var = allocator.reserveSparse<long>(1000, indices, &values[0]);
+    if (var == nullptr) return 0;
+
+    // Zeros count as a single value.
+    const double estimate = allocator.distinctCount(var).estimate();
+    bool success = std::abs(estimate - 3) < 0.5;
+
+    return finishTest<long>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_sketches()
+  {
+    // Two sketches merged after being sent.
+    algorep::HyperLogLog a(10);
+    algorep::HyperLogLog b(10);
+    for (uint64_t i = 0; i < 20000; ++i)
+      ((i % 2) ? a : b).add(algorep::hashing::hash(i % 10000));
+
+    std::vector<uint8_t> bytes;
+    b.serialize(bytes);
+    algorep::HyperLogLog received;
+    bool success = received.deserialize(&bytes[0], bytes.size());
+    success = success && !received.deserialize(&bytes[0], bytes.size() - 1);
+    success = success && a.merge(received);
+    success = success && !a.merge(algorep::HyperLogLog(12));
+    success = success && std::abs(a.estimate() - 10000) < 10000 * 0.1;
+
+    // Filters only merge when their sizes match.
+    algorep::BloomFilter f(1024, 3);
+    f.add(algorep::hashing::hash(42));
+    f.serialize(bytes);
+    algorep::BloomFilter g;
+    success = success && g.deserialize(&bytes[0], bytes.size());
+    success = success && g.containsKey(42) && g.getNbHashes() == 3;
+    success = success && !g.merge(algorep::BloomFilter(2048, 3));
+    return success && algorep::HyperLogLog().estimate() == 0;
+  }
+
+  unsigned int
+  check_bloom(Allocator& allocator)
+  {
+    std::vector<long> in(3000);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = 2 * i * 7;
+    auto* var = allocator.reserve<long>(in.size(), &in[0]);
+    if (var == nullptr) return 0;
+
+    // Every value is found, about 1% of the others are.
+    const auto& filter = allocator.bloom(var, 0.01);
+    bool success = var->getIds().size() > 1;
+    for (const auto& value : in) success = success && filter.containsKey(value);
+    size_t nb_false = 0;
+    for (long value = 1; value < 20000; value += 2)
+      nb_false += filter.containsKey(value);
+    success = success && nb_false < 10000 * 0.03;
+
+    return finishTest<long>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_filter(Allocator& allocator)
+  {
+    std::vector<int> keys(1000);
+    for (size_t i = 0; i < keys.size(); ++i) keys[i] = 3 * i;
+    auto* key_var = allocator.reserve<int>(keys.size(), &keys[0]);
+    if (key_var == nullptr) return 0;
+    const auto& filter = allocator.bloom(key_var, 0.001);
+    allocator.free(key_var);
+
+    std::vector<int> in(2500);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = i;
+    auto* var = allocator.reserve<int>(in.size(), &in[0]);
+    if (var == nullptr) return 0;
+
+    // Results are placed with the tested chunks.
+    auto* mask = allocator.filter(var, filter);
+    if (mask == nullptr) return finishTest<int>(false, allocator, var, nullptr);
+    bool success = mask->getBounds() == var->getBounds();
+    success = success && mask->getIntIds() == var->getIntIds();
+
+    auto* read = allocator.read(mask);
+    size_t nb_false = 0;
+    for (size_t i = 0; success && i < in.size(); ++i)
+    {
+      const bool is_key = (i % 3 == 0);
+      success = !is_key || read[i] == 1;
+      nb_false += !is_key && read[i];
+    }
+    success = success && nb_false < 20;
+    delete[] read;
+    allocator.free(mask);
+
+    return finishTest<int>(success, allocator, var, nullptr);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  tests_passed += check_distinct(*allocator);
+  tests_passed += check_distinct_sparse(*allocator);
+  tests_passed += check_sketches();
+  tests_passed += check_bloom(*allocator);
+  tests_passed += check_filter(*allocator);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 5, "> Distinct count and Bloom filters <");
+}
+
+int
+main(int argc, char** argv)
+{
+  return runSplit(argc, argv, run);
+}
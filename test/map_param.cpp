@@ -0,0 +1,123 @@
+#include <algorep.h>
+#include <cmath>
+#include <iostream>
+
+#include "utils/utils.h"
+
+using namespace algorep::callback;
+
+namespace
+{
+  template <typename T, typename F>
+  unsigned int
+  check_kernel(Allocator& allocator, const std::vector<T>& in,
+               unsigned int kernel_id, const std::vector<T>& params,
+               F expected)
+  {
+    auto* var = allocator.reserve<T>(in.size(), &in[0]);
+    if (var == nullptr) return 0;
+
+    bool success = allocator.mapParam(var, kernel_id, params) != nullptr;
+    auto* read = allocator.read(var);
+    for (size_t i = 0; success && i < in.size(); ++i)
+      success = read[i] == expected(in[i]);
+
+    return finishTest<T>(success, allocator, var, read);
+  }
+
+  unsigned int
+  check_affine(Allocator& allocator)
+  {
+    std::vector<double> in(4000);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = i * 0.25 - 100;
+
+    return check_kernel<double>(allocator, in, MapParamID::AFFINE, {3.5, 1},
+                                [](double a) { return 3.5 * a + 1; });
+  }
+
+  unsigned int
+  check_clamp(Allocator& allocator)
+  {
+    std::vector<int> in(5000);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = (i * 37) % 101 - 50;
+
+    return check_kernel<int>(
+        allocator, in, MapParamID::CLAMP, {-10, 10},
+        [](int a) { return std::min(std::max(a, -10), 10); });
+  }
+
+  unsigned int
+  check_threshold(Allocator& allocator)
+  {
+    std::vector<float> in({-2.5, 0, 0.5, 1, 8});
+
+    return check_kernel<float>(allocator, in, MapParamID::THRESHOLD,
+                               {0.5, 1}, [](float a) { return a >= 0.5f; });
+  }
+
+  unsigned int
+  check_power(Allocator& allocator)
+  {
+    std::vector<long> in({-3, -1, 0, 2, 7, 10});
+    bool success = check_kernel<long>(allocator, in, MapParamID::POWER, {3},
+                                      [](long a) { return a * a * a; });
+
+    // Negative exponents give 1 for integers.
+    success = success &&
+              check_kernel<long>(allocator, in, MapParamID::POWER, {-1},
+                                 [](long) { return 1; });
+
+    std::vector<double> floats({0.5, 4, 9});
+    success = success && check_kernel<double>(
+                             allocator, floats, MapParamID::POWER, {0.5},
+                             [](double a) { return std::sqrt(a); });
+    return success;
+  }
+
+  unsigned int
+  check_sparse(Allocator& allocator)
+  {
+    std::vector<size_t> indices({3, 50, 99});
+    std::vector<float> values({1, -2, 4});
+    auto* var = allocator.reserveSparse<float>(100, indices, &values[0]);
+    if (var == nullptr) return 0;
+
+    // Zeros are kept by a scale, not by an offset.
+    bool success =
+        allocator.mapParam<float>(var, MapParamID::AFFINE, {2, 1}) == nullptr;
+    success = allocator.mapParam<float>(var, MapParamID::AFFINE, {2}) &&
+              success;
+    std::vector<size_t> out_indices;
+    std::vector<float> out_values;
+    allocator.readSparse(var, out_indices, out_values);
+    success = success && out_indices == indices;
+    success = success && out_values == std::vector<float>({2, -4, 8});
+
+    return finishTest<float>(success, allocator, var, nullptr);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  tests_passed += check_affine(*allocator);
+  tests_passed += check_clamp(*allocator);
+  tests_passed += check_threshold(*allocator);
+  tests_passed += check_power(*allocator);
+  tests_passed += check_sparse(*allocator);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 5, "> Parameterized mappings <");
+}
+
+int
+main(int argc, char** argv)
+{
+  return runSplit(argc, argv, run);
+}
@@ -0,0 +1,159 @@
+#include <algorep.h>
+#include <cmath>
+#include <iostream>
+
+#include "utils/utils.h"
+
+using namespace algorep::callback;
+
+namespace
+{
+  /**
+   * @brief Check that every chunk of a matrix holds whole rows.
+   */
+  template <typename T>
+  bool
+  holdsRows(const algorep::Matrix<T>* mat)
+  {
+    bool success = mat->getBounds().size() > 1;
+    for (const auto& bounds : mat->getBounds())
+    {
+      success = success && std::get<0>(bounds) % mat->getNbCols() == 0;
+      success = success && (std::get<1>(bounds) + 1) % mat->getNbCols() == 0;
+    }
+    return success;
+  }
+
+  unsigned int
+  check_matvec(Allocator& allocator)
+  {
+    const size_t nb_rows = 300;
+    const size_t nb_cols = 11;
+    std::vector<int> in(nb_rows * nb_cols);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = (i * 31) % 17 - 8;
+    std::vector<int> x(nb_cols);
+    for (size_t i = 0; i < nb_cols; ++i) x[i] = i - 5;
+
+    auto* mat = allocator.reserveMatrix<int>(nb_rows, nb_cols, &in[0]);
+    auto* vec = allocator.reserve<int>(nb_cols, &x[0]);
+    if (mat == nullptr || vec == nullptr) return 0;
+    bool success = holdsRows(mat);
+
+    // Values of the result are next to their rows.
+    auto* y = allocator.matvec(mat, vec);
+    success = success && y != nullptr && y->getIntIds() == mat->getIntIds();
+    auto* read = (y) ? allocator.read(y) : nullptr;
+    for (size_t r = 0; success && r < nb_rows; ++r)
+    {
+      int expected = 0;
+      for (size_t c = 0; c < nb_cols; ++c)
+        expected += in[r * nb_cols + c] * x[c];
+      success = read[r] == expected;
+    }
+    delete[] read;
+    if (y) allocator.free(y);
+    allocator.free(vec);
+
+    return finishTest<int>(success, allocator, mat, nullptr);
+  }
+
+  unsigned int
+  check_transposed(Allocator& allocator)
+  {
+    const size_t nb_rows = 200;
+    const size_t nb_cols = 7;
+    std::vector<double> in(nb_rows * nb_cols);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = std::sin(i * 0.1);
+    std::vector<double> x(nb_rows);
+    for (size_t i = 0; i < nb_rows; ++i) x[i] = 1.0 / (i + 1);
+
+    auto* mat = allocator.reserveMatrix<double>(nb_rows, nb_cols, &in[0]);
+    auto* vec = allocator.reserve<double>(nb_rows, &x[0]);
+    if (mat == nullptr || vec == nullptr) return 0;
+    bool success = holdsRows(mat);
+
+    auto* y = allocator.matvecTransposed(mat, vec);
+    success = success && y != nullptr && y->getNbValues() == nb_cols;
+    auto* read = (y) ? allocator.read(y) : nullptr;
+    for (size_t c = 0; success && c < nb_cols; ++c)
+    {
+      double expected = 0;
+      for (size_t r = 0; r < nb_rows; ++r)
+        expected += in[r * nb_cols + c] * x[r];
+      success = std::abs(read[c] - expected) < 1e-9;
+    }
+    delete[] read;
+    if (y) allocator.free(y);
+    allocator.free(vec);
+
+    return finishTest<double>(success, allocator, mat, nullptr);
+  }
+
+  unsigned int
+  check_reduce_rows(Allocator& allocator)
+  {
+    const size_t nb_rows = 250;
+    const size_t nb_cols = 6;
+    std::vector<long> in(nb_rows * nb_cols);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = i;
+
+    auto* mat = allocator.reserveMatrix<long>(nb_rows, nb_cols, &in[0]);
+    if (mat == nullptr) return 0;
+
+    auto* sums = allocator.reduceRows(mat, ReduceID::L_SUM, 100L);
+    bool success = sums != nullptr && sums->getNbValues() == nb_rows;
+    auto* read = (sums) ? allocator.read(sums) : nullptr;
+    for (size_t r = 0; success && r < nb_rows; ++r)
+    {
+      // Sum of r * nb_cols, ..., r * nb_cols + nb_cols - 1.
+      const long first = r * nb_cols;
+      success = read[r] == 100 + (long)nb_cols * first + 15;
+    }
+    delete[] read;
+    if (sums) allocator.free(sums);
+
+    return finishTest<long>(success, allocator, mat, nullptr);
+  }
+
+  unsigned int
+  check_invalid(Allocator& allocator)
+  {
+    std::vector<float> in(40 * 5, 1);
+    auto* mat = allocator.reserveMatrix<float>(40, 5, &in[0]);
+    auto* vec = allocator.reserve<float>(6, &in[0]);
+    if (mat == nullptr || vec == nullptr) return 0;
+
+    // Vectors have to match the rows or the columns.
+    bool success = allocator.matvec(mat, vec) == nullptr;
+    success = success && allocator.matvecTransposed(mat, vec) == nullptr;
+    success = success && allocator.reserveMatrix<float>(4, 0, &in[0]) ==
+                             nullptr;
+    allocator.free(vec);
+
+    return finishTest<float>(success, allocator, mat, nullptr);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  tests_passed += check_matvec(*allocator);
+  tests_passed += check_transposed(*allocator);
+  tests_passed += check_reduce_rows(*allocator);
+  tests_passed += check_invalid(*allocator);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 4, "> Matrix <");
+}
+
+int
+main(int argc, char** argv)
+{
+  return runSplit(argc, argv, run);
+}
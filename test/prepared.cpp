@@ -0,0 +1,109 @@
+#include <algorep.h>
+#include <iostream>
+
+#include "utils/utils.h"
+
+using namespace algorep::callback;
+
+namespace
+{
+  constexpr unsigned int NB_RUNS = 5;
+
+  unsigned int
+  check_prepared_map(Allocator& allocator, std::vector<int> in)
+  {
+    auto* var = allocator.reserve<int>(in.size(), &in[0]);
+    auto* op = allocator.prepareMap<int>(var, MapID::I_NEGATE);
+
+    bool success = true;
+    for (unsigned int i = 0; i < NB_RUNS; ++i)
+    {
+      op->start();
+      success = op->wait() && success;
+    }
+    delete op;
+
+    int* read = allocator.read<int>(var);
+    for (size_t i = 0; i < in.size(); ++i)
+      success = success && (read[i] == -in[i]);
+
+    return finishTest(success, allocator, var, read);
+  }
+
+  unsigned int
+  check_prepared_reduce(Allocator& allocator, std::vector<long> in)
+  {
+    auto* var = allocator.reserve<long>(in.size(), &in[0]);
+    auto* op = allocator.prepareReduce<long>(var, ReduceID::L_SUM, 10);
+
+    long expected = 10;
+    for (const auto& v : in) expected += v;
+
+    bool success = true;
+    for (unsigned int i = 0; i < NB_RUNS; ++i)
+    {
+      op->start();
+      op->wait();
+      success = success && (*op->getResult<long>() == expected);
+    }
+    delete op;
+
+    allocator.free(var);
+    return !!success;
+  }
+
+  unsigned int
+  check_prepared_write(Allocator& allocator, std::vector<double> in)
+  {
+    auto* var = allocator.reserve<double>(in.size(), &in[0]);
+    auto* op = allocator.prepareWrite<double>(var, &in[0]);
+
+    bool success = true;
+    for (unsigned int i = 0; i < NB_RUNS; ++i)
+    {
+      for (auto& v : in) v += 1.5;
+      op->start();
+      success = op->wait() && success;
+    }
+    delete op;
+
+    double* read = allocator.read<double>(var);
+    for (size_t i = 0; i < in.size(); ++i)
+      success = success && (read[i] == in[i]);
+
+    return finishTest(success, allocator, var, read);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  tests_passed += check_prepared_map(
+      *allocator, {5, -4, 3, 2, 1, -1, 0, 100, 7, -8, 9, 10});
+  tests_passed +=
+      check_prepared_reduce(*allocator, {1000, -4, 3, 2, 1, -1, 0, 1993});
+  tests_passed += check_prepared_write(*allocator, {0.5, 1.0, 1.1, 2.0, 9.5});
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 3, "> Prepared operations <");
+}
+
+int
+main(int argc, char** argv)
+{
+  algorep::init(argc, argv);
+
+  const auto& callback = std::function<void()>(run);
+  // Small memory per slave, to split the data on several slaves.
+  algorep::run(callback, 32);
+
+  // This is in charge of liberating some allocated
+  // memory.
+  algorep::terminate();
+}
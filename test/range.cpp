@@ -0,0 +1,155 @@
+#include <algorep.h>
+#include <iostream>
+
+#include "utils/utils.h"
+
+namespace
+{
+  /**
+   * @brief Positions of the values in [low, high], computed on the master.
+   */
+  template <typename T>
+  std::vector<size_t>
+  expected(const std::vector<T>& values, const T& low, const T& high)
+  {
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      if (values[i] >= low && values[i] <= high) indices.push_back(i);
+    }
+    return indices;
+  }
+
+  /**
+   * @brief Check a range query against the values, with and without a
+   * zone map.
+   */
+  template <typename T>
+  bool
+  checkRange(Allocator& allocator, const algorep::Element<T>* var,
+             const std::vector<T>& in, const T& low, const T& high,
+             const algorep::ZoneMap<T>* zones)
+  {
+    const auto& ref = expected(in, low, high);
+    bool success = allocator.rangeCount(var, low, high, zones) == ref.size();
+    success = success && allocator.rangeCount(var, low, high) == ref.size();
+
+    std::vector<size_t> indices;
+    std::vector<T> values;
+    allocator.rangeRead(var, low, high, indices, values, zones);
+    success = success && indices == ref;
+    for (size_t i = 0; success && i < ref.size(); ++i)
+      success = values[i] == in[ref[i]];
+    return success;
+  }
+
+  unsigned int
+  check_sorted(Allocator& allocator)
+  {
+    std::vector<int> in(3000);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = i / 3 - 200;
+    auto* var = reserveSplit(allocator, in);
+    if (var == nullptr) return 0;
+
+    const auto& zones = allocator.zoneMap(var);
+    bool success = var->getIds().size() > 1 && zones.describes(var);
+    success = success && zones.isSorted();
+    for (size_t i = 0; success && i < zones.getZones().size(); ++i)
+    {
+      const auto& bounds = var->getBounds()[i];
+      const auto& zone = zones.getZones()[i];
+      success = zone.sorted && zone.min == in[std::get<0>(bounds)] &&
+                zone.max == in[std::get<1>(bounds)];
+    }
+
+    // Ranges inside a chunk, across chunks, covering everything.
+    success = success && checkRange(allocator, var, in, 10, 20, &zones);
+    success = success && checkRange(allocator, var, in, 100, 700, &zones);
+    success = success && checkRange(allocator, var, in, -1000, 1000, &zones);
+    success = success && checkRange(allocator, var, in, 2000, 3000, &zones);
+
+    return finishTest<int>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_unsorted(Allocator& allocator)
+  {
+    std::vector<double> in(1800);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = (i * 7919) % 1000 * 0.5;
+    auto* var = reserveSplit(allocator, in);
+    if (var == nullptr) return 0;
+
+    const auto& zones = allocator.zoneMap(var);
+    bool success = var->getIds().size() > 1 && !zones.isSorted();
+    success = success && checkRange(allocator, var, in, 10.0, 20.0, &zones);
+    success = success && checkRange(allocator, var, in, 0.0, 499.5, &zones);
+    success = success && checkRange(allocator, var, in, 40.25, 40.25, &zones);
+
+    return finishTest<double>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_stale(Allocator& allocator)
+  {
+    std::vector<long> in(1000);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = i;
+    auto* var = allocator.reserve<long>(in.size(), &in[0]);
+    if (var == nullptr) return 0;
+
+    // Chunks added after the zone map are still queried.
+    const auto& zones = allocator.zoneMap(var);
+    std::vector<long> more(1500, 5);
+    allocator.append(var, &more[0], more.size());
+    in.insert(in.end(), more.begin(), more.end());
+
+    bool success = !zones.describes(var);
+    success = success && checkRange(allocator, var, in, 0L, 10L, &zones);
+    success = success && checkRange(allocator, var, in, 5L, 5L, &zones);
+
+    return finishTest<long>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_invalid(Allocator& allocator)
+  {
+    std::vector<float> in({3, 1, 2});
+    auto* var = allocator.reserve<float>(in.size(), &in[0]);
+    auto* sparse = allocator.reserveSparse<float>(100, {4}, &in[0]);
+    if (var == nullptr || sparse == nullptr) return 0;
+
+    // Empty ranges, and elements which are not dense.
+    const auto& zones = allocator.zoneMap(var);
+    bool success = !zones.isSorted();
+    success = success && allocator.rangeCount(var, 2.0f, 1.0f, &zones) == 0;
+    success = success && allocator.rangeCount(var, 4.0f, 9.0f, &zones) == 0;
+    success = success && allocator.rangeCount(sparse, 0.0f, 9.0f) == 0;
+    success = success && !allocator.zoneMap(sparse).describes(sparse);
+    allocator.free(sparse);
+
+    return finishTest<float>(success, allocator, var, nullptr);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  tests_passed += check_sorted(*allocator);
+  tests_passed += check_unsorted(*allocator);
+  tests_passed += check_stale(*allocator);
+  tests_passed += check_invalid(*allocator);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 4, "> Range queries <");
+}
+
+int
+main(int argc, char** argv)
+{
+  return runSplit(argc, argv, run);
+}
@@ -0,0 +1,71 @@
+#include <algorep.h>
+#include <iostream>
+
+#include "utils/utils.h"
+
+namespace
+{
+  constexpr size_t MAX_MEMORY = 96;
+
+  unsigned int
+  check_rebalance(Allocator& allocator)
+  {
+    std::vector<int> in(20);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = i * 3 + 1;
+
+    // The first slave is filled, and the second element is thus split
+    // on the first and second slaves.
+    auto* first = allocator.reserve<int>(in.size(), &in[0]);
+    auto* second = allocator.reserve<int>(in.size(), &in[0]);
+    bool success = (second->getIds().size() == 2);
+
+    // Once the first element is freed, the second one can fit
+    // on a single slave.
+    allocator.free(first);
+    success = success && (allocator.rebalance() == 1);
+    success = success && (second->getIds().size() == 1);
+    success = success && (second->getIntIds()[0] == 3);
+
+    // Nothing left to improve.
+    success = success && (allocator.rebalance() == 0);
+
+    int* read = allocator.read<int>(second);
+    for (size_t i = 0; i < in.size(); ++i)
+      success = success && (read[i] == in[i]);
+
+    return finishTest(success, allocator, second, read);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  tests_passed += check_rebalance(*allocator);
+
+  unsigned long long total = 0;
+  for (const auto& bytes : allocator->getMemoryStatus()) total += bytes;
+  tests_passed += (total == 3 * MAX_MEMORY);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 2, "> Rebalance <");
+}
+
+int
+main(int argc, char** argv)
+{
+  algorep::init(argc, argv);
+
+  const auto& callback = std::function<void()>(run);
+  // Small memory per slave, to split the data on several slaves.
+  algorep::run(callback, MAX_MEMORY);
+
+  // This is in charge of liberating some allocated
+  // memory.
+  algorep::terminate();
+}
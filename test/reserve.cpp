@@ -0,0 +1,81 @@
+#include <algorep.h>
+#include <iostream>
+
+#include "utils/utils.h"
+
+namespace
+{
+  template <typename T>
+  unsigned int
+  check_filled(Allocator& allocator, size_t size, T value)
+  {
+    auto* var = allocator.reserveFilled<T>(size, value);
+    if (!var) return 0;
+
+    T* read = allocator.read<T>(var);
+    size_t i = 0;
+    for (; i < size; ++i)
+    {
+      if (read[i] != value) break;
+    }
+
+    return finishTest(i == size, allocator, var, read);
+  }
+
+  template <typename T>
+  unsigned int
+  check_uninitialized(Allocator& allocator, const std::vector<T>& in)
+  {
+    auto* var = allocator.reserveUninitialized<T>(in.size());
+    if (!var) return 0;
+
+    bool success = allocator.write<T>(var, &in[0]);
+    T* read = allocator.read<T>(var);
+    for (size_t i = 0; i < in.size(); ++i)
+      success = success && (read[i] == in[i]);
+
+    return finishTest(success, allocator, var, read);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  tests_passed += check_filled<int>(*allocator, 30, -7);
+  tests_passed += check_filled<double>(*allocator, 20, 3.25);
+  tests_passed += check_filled<unsigned short>(*allocator, 1, 9);
+  tests_passed += check_uninitialized<float>(
+      *allocator, {1.5f, 2.0f, -3.0f, 4.0f, 0.0f, 10.0f, 9.0f, 8.0f, 7.0f});
+
+  // Does not fit in the network.
+  auto* too_large = allocator->reserveFilled<long>(1000, 1);
+  tests_passed += (too_large == nullptr);
+
+  // Empty elements are still valid.
+  auto* empty = allocator->reserve<int>(0, nullptr);
+  tests_passed += (empty != nullptr && empty->getNbValues() == 0);
+  if (empty) allocator->free(empty);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 6, "> Reserve without payload <");
+}
+
+int
+main(int argc, char** argv)
+{
+  algorep::init(argc, argv);
+
+  const auto& callback = std::function<void()>(run);
+  // Small memory per slave, to split the data on several slaves.
+  algorep::run(callback, 64);
+
+  // This is in charge of liberating some allocated
+  // memory.
+  algorep::terminate();
+}
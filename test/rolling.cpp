@@ -0,0 +1,169 @@
+#include <algorep.h>
+#include <cmath>
+#include <iostream>
+
+#include "utils/utils.h"
+
+using namespace algorep::callback;
+
+namespace
+{
+  /**
+   * @brief Compute a rolling aggregate on the master.
+   */
+  template <typename T>
+  std::vector<T>
+  expected(const std::vector<T>& values, size_t window, unsigned int kind)
+  {
+    std::vector<T> out(values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      const size_t first = (i + 1 >= window) ? i + 1 - window : 0;
+      T acc = values[first];
+      T sum = 0;
+      for (size_t j = first; j <= i; ++j)
+      {
+        sum += values[j];
+        acc = (kind == ROLLING_MAX) ? std::max(acc, values[j])
+                                    : std::min(acc, values[j]);
+      }
+      if (kind == ROLLING_SUM) acc = sum;
+      if (kind == ROLLING_MEAN) acc = sum / (T)(i - first + 1);
+      out[i] = acc;
+    }
+    return out;
+  }
+
+  template <typename T>
+  bool
+  check_kind(Allocator& allocator, const algorep::Element<T>* var,
+             const std::vector<T>& in, size_t window, unsigned int kind)
+  {
+    auto* out = allocator.rolling(var, window, kind);
+    if (out == nullptr) return false;
+
+    bool success = out->getBounds() == var->getBounds();
+    const auto& ref = expected(in, window, kind);
+    auto* read = allocator.read(out);
+    for (size_t i = 0; success && i < in.size(); ++i)
+      success = std::abs((double)read[i] - (double)ref[i]) < 1e-9;
+    delete[] read;
+    allocator.free(out);
+
+    return success;
+  }
+
+  unsigned int
+  check_sum(Allocator& allocator)
+  {
+    std::vector<int> in(3000);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = (i * 7919) % 101 - 50;
+    auto* var = reserveSplit(allocator, in);
+    if (var == nullptr) return 0;
+
+    bool success = var->getIds().size() > 1;
+    success = success && check_kind<int>(allocator, var, in, 50, ROLLING_SUM);
+    // A window of one value copies the element.
+    success = success && check_kind<int>(allocator, var, in, 1, ROLLING_SUM);
+
+    return finishTest<int>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_mean(Allocator& allocator)
+  {
+    std::vector<double> in(1500);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = std::sin(i * 0.05);
+    auto* var = reserveSplit(allocator, in);
+    if (var == nullptr) return 0;
+
+    bool success = var->getIds().size() > 1;
+    success = success &&
+              check_kind<double>(allocator, var, in, 7, ROLLING_MEAN);
+
+    return finishTest<double>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_min_max(Allocator& allocator)
+  {
+    std::vector<long> in(1200);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = (i * 37) % 1009;
+    auto* var = reserveSplit(allocator, in);
+    if (var == nullptr) return 0;
+
+    // Windows as long as a chunk reach the previous one.
+    const size_t window = std::get<1>(var->getBounds()[0]) + 1;
+    bool success = var->getIds().size() > 1;
+    success = success &&
+              check_kind<long>(allocator, var, in, window, ROLLING_MAX);
+    success = success &&
+              check_kind<long>(allocator, var, in, window, ROLLING_MIN);
+    success = success && check_kind<long>(allocator, var, in, 3, ROLLING_MAX);
+
+    return finishTest<long>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_long_windows(Allocator& allocator)
+  {
+    std::vector<int> in(900);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = (i * 53) % 97 - 40;
+    auto* var = reserveSplit(allocator, in);
+    if (var == nullptr) return 0;
+
+    // Chunks are shorter than the windows, which reach over several of
+    // them.
+    const size_t len = std::get<1>(var->getBounds()[0]) + 1;
+    bool success = var->getIds().size() > 2;
+    success = success &&
+              check_kind<int>(allocator, var, in, len + 2, ROLLING_SUM);
+    success = success &&
+              check_kind<int>(allocator, var, in, in.size(), ROLLING_MAX);
+    success = success && check_kind<int>(allocator, var, in, 2 * len + 10,
+                                         ROLLING_MIN);
+
+    return finishTest<int>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_invalid(Allocator& allocator)
+  {
+    std::vector<float> in(900, 1);
+    auto* var = reserveSplit(allocator, in);
+    std::vector<size_t> indices({3, 50});
+    auto* sparse = allocator.reserveSparse<float>(100, indices, &in[0]);
+    if (var == nullptr || sparse == nullptr) return 0;
+
+    bool success = allocator.rolling(var, 0, ROLLING_SUM) == nullptr;
+    success = success && allocator.rolling(sparse, 2, ROLLING_SUM) == nullptr;
+    allocator.free(sparse);
+
+    return finishTest<float>(success, allocator, var, nullptr);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  tests_passed += check_sum(*allocator);
+  tests_passed += check_mean(*allocator);
+  tests_passed += check_min_max(*allocator);
+  tests_passed += check_long_windows(*allocator);
+  tests_passed += check_invalid(*allocator);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 5, "> Rolling aggregates <");
+}
+
+int
+main(int argc, char** argv)
+{
+  return runSplit(argc, argv, run);
+}
@@ -0,0 +1,183 @@
+#include <algorep.h>
+#include <iostream>
+
+#include "utils/utils.h"
+
+using namespace algorep::callback;
+
+namespace
+{
+  constexpr size_t MAX_MEMORY = 4096;
+
+  // One value out of 20 is not zero. The dense array would not fit.
+  constexpr size_t NB_VALUES = 10000;
+  constexpr size_t STEP = 20;
+
+  void
+  make_sparse(std::vector<size_t>& indices, std::vector<int>& values)
+  {
+    for (size_t i = 3; i < NB_VALUES; i += STEP)
+    {
+      indices.push_back(i);
+      values.push_back(i % 7 + 1);
+    }
+  }
+
+  unsigned int
+  check_reserve(Allocator& allocator)
+  {
+    std::vector<size_t> indices;
+    std::vector<int> values;
+    make_sparse(indices, values);
+
+    // The dense array does not fit on the slaves.
+    std::vector<int> dense(NB_VALUES, 0);
+    for (size_t i = 0; i < indices.size(); ++i) dense[indices[i]] = values[i];
+    bool success = allocator.reserve<int>(dense.size(), &dense[0]) == nullptr;
+
+    auto* var = allocator.reserveSparse<int>(NB_VALUES, indices, &values[0]);
+    success = success && var != nullptr && var->getNbValues() == NB_VALUES;
+    if (var == nullptr) return 0;
+
+    // Chunks only hold positions and values.
+    size_t used = 0;
+    for (const auto& status : allocator.queryMemoryStatus())
+      used += status.used;
+    success = success &&
+              used == indices.size() * (sizeof(uint64_t) + sizeof(int));
+
+    int* read = allocator.read<int>(var);
+    for (size_t i = 0; success && i < NB_VALUES; ++i)
+      success = (read[i] == dense[i]);
+
+    return finishTest(success, allocator, var, read);
+  }
+
+  unsigned int
+  check_read_sparse(Allocator& allocator)
+  {
+    std::vector<size_t> indices;
+    std::vector<int> values;
+    make_sparse(indices, values);
+    auto* var = allocator.reserveSparse<int>(NB_VALUES, indices, &values[0]);
+    if (var == nullptr) return 0;
+
+    std::vector<size_t> out_indices;
+    std::vector<int> out_values;
+    allocator.readSparse<int>(var, out_indices, out_values);
+    bool success = (out_indices == indices) && (out_values == values);
+
+    // Dense elements are filtered by the master.
+    std::vector<int> dense({0, 4, 0, 0, -2, 0});
+    auto* dense_var = allocator.reserve<int>(dense.size(), &dense[0]);
+    out_indices.clear();
+    out_values.clear();
+    allocator.readSparse<int>(dense_var, out_indices, out_values);
+    success = success && (out_indices == std::vector<size_t>({1, 4}));
+    success = success && (out_values == std::vector<int>({4, -2}));
+    allocator.free(dense_var);
+
+    return finishTest<int>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_reduce(Allocator& allocator)
+  {
+    std::vector<size_t> indices;
+    std::vector<int> values;
+    make_sparse(indices, values);
+    auto* var = allocator.reserveSparse<int>(NB_VALUES, indices, &values[0]);
+    if (var == nullptr) return 0;
+
+    int expected = 0;
+    for (const auto& v : values) expected += v;
+
+    int* result = allocator.reduce<int>(var, ReduceID::I_SUM);
+    bool success = (result != nullptr) && (*result == expected);
+    delete result;
+
+    return finishTest<int>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_map(Allocator& allocator)
+  {
+    std::vector<size_t> indices;
+    std::vector<int> values;
+    make_sparse(indices, values);
+    auto* var = allocator.reserveSparse<int>(NB_VALUES, indices, &values[0]);
+    if (var == nullptr) return 0;
+
+    // Zeros stay zeros, only the stored values are negated.
+    bool success = allocator.map<int>(var, MapID::I_NEGATE) != nullptr;
+
+    std::vector<size_t> out_indices;
+    std::vector<int> out_values;
+    allocator.readSparse<int>(var, out_indices, out_values);
+    success = success && (out_indices == indices);
+    for (size_t i = 0; success && i < values.size(); ++i)
+      success = (out_values[i] == -values[i]);
+
+    return finishTest<int>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_rejected(Allocator& allocator)
+  {
+    std::vector<size_t> indices({2, 5, 9});
+    std::vector<int> values({1, 2, 3});
+
+    // Positions have to be increasing, and in bounds.
+    std::vector<size_t> unordered({5, 2, 9});
+    bool success =
+        allocator.reserveSparse<int>(10, unordered, &values[0]) == nullptr;
+    success = success &&
+              allocator.reserveSparse<int>(9, indices, &values[0]) == nullptr;
+
+    // Dense operations are not available on sparse elements.
+    auto* var = allocator.reserveSparse<int>(10, indices, &values[0]);
+    if (var == nullptr) return 0;
+    std::vector<int> dense(10, 1);
+    success = success && !allocator.write<int>(var, &dense[0]);
+    success = success && allocator.view<int>(var) == nullptr;
+
+    int* read = allocator.read<int>(var);
+    success = success && read[2] == 1 && read[5] == 2 && read[9] == 3;
+    success = success && read[0] == 0 && read[8] == 0;
+
+    return finishTest(success, allocator, var, read);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  tests_passed += check_reserve(*allocator);
+  tests_passed += check_read_sparse(*allocator);
+  tests_passed += check_reduce(*allocator);
+  tests_passed += check_map(*allocator);
+  tests_passed += check_rejected(*allocator);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 5, "> Sparse elements <");
+}
+
+int
+main(int argc, char** argv)
+{
+  algorep::init(argc, argv);
+
+  const auto& callback = std::function<void()>(run);
+  // Small slaves, which can not hold the dense array.
+  algorep::run(callback, MAX_MEMORY);
+
+  // This is in charge of liberating some allocated
+  // memory.
+  algorep::terminate();
+}
@@ -0,0 +1,108 @@
+#include <algorep.h>
+#include <iostream>
+
+#include "utils/utils.h"
+
+using namespace algorep::callback;
+
+namespace
+{
+  constexpr size_t MAX_MEMORY = 64;
+  constexpr size_t DISK_BUDGET = 256;
+
+  unsigned int
+  check_spill(Allocator& allocator)
+  {
+    std::vector<int> in(200);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = i * 2 - 150;
+
+    // 800 bytes do not fit in the RAM of the slaves.
+    bool success = (allocator.reserve<int>(in.size(), &in[0]) == nullptr);
+    success = allocator.configureSpill("/tmp", DISK_BUDGET) && success;
+    auto* var = allocator.reserve<int>(in.size(), &in[0]);
+    if (var == nullptr) return 0;
+
+    size_t spilled = 0;
+    for (const auto& status : allocator.queryMemoryStatus())
+      spilled += status.spilled;
+    success = success && (spilled > 0);
+
+    // Spilled chunks are read back for the map and the reduce.
+    allocator.map<int>(var, MapID::I_NEGATE);
+    int* sum = allocator.reduce<int>(var, ReduceID::I_SUM);
+    long expected = 0;
+    for (const auto& v : in) expected -= v;
+    success = success && (*sum == expected);
+    delete[] sum;
+
+    int* read = allocator.read<int>(var);
+    for (size_t i = 0; i < in.size(); ++i)
+      success = success && (read[i] == -in[i]);
+
+    return finishTest(success, allocator, var, read);
+  }
+
+  unsigned int
+  check_lru(Allocator& allocator)
+  {
+    // Each element fills the RAM of the first slave, the older one
+    // is spilled when the second one is allocated.
+    std::vector<long> in(MAX_MEMORY / sizeof(long), 3);
+    auto* first = allocator.reserve<long>(in.size(), &in[0]);
+    auto* second = allocator.reserve<long>(in.size(), &in[0]);
+
+    bool success = (first->getIntIds()[0] == 1);
+    success = success && (second->getIntIds()[0] == 1);
+    success = success && (allocator.queryMemoryStatus()[0].spilled ==
+                          MAX_MEMORY);
+
+    // Reading the first element brings it back in RAM.
+    long* read = allocator.read<long>(first);
+    for (size_t i = 0; i < in.size(); ++i)
+      success = success && (read[i] == 3);
+    delete[] read;
+
+    allocator.free(first);
+    read = allocator.read<long>(second);
+    for (size_t i = 0; i < in.size(); ++i)
+      success = success && (read[i] == 3);
+
+    return finishTest(success, allocator, second, read);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  tests_passed += check_spill(*allocator);
+  tests_passed += check_lru(*allocator);
+
+  // Nothing is left on disk.
+  bool success = true;
+  for (const auto& status : allocator->queryMemoryStatus())
+    success = success && (status.used == 0) && (status.spilled == 0);
+  tests_passed += success;
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 3, "> Spill to disk <");
+}
+
+int
+main(int argc, char** argv)
+{
+  algorep::init(argc, argv);
+
+  const auto& callback = std::function<void()>(run);
+  // Small memory per slave, to split the data on several slaves.
+  algorep::run(callback, MAX_MEMORY);
+
+  // This is in charge of liberating some allocated
+  // memory.
+  algorep::terminate();
+}
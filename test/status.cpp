@@ -0,0 +1,97 @@
+#include <algorep.h>
+#include <iostream>
+
+#include "utils/utils.h"
+
+namespace
+{
+  constexpr size_t MAX_MEMORY = 64;
+
+  unsigned int
+  check_usage(Allocator& allocator)
+  {
+    std::vector<int> in(20);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = i - 5;
+
+    // 80 bytes: the first slave is full, the second one holds 16 bytes.
+    auto* var = allocator.reserve<int>(in.size(), &in[0]);
+    const auto& status = allocator.queryMemoryStatus();
+
+    bool success = (status.size() == 3);
+    success = success && (status[0].nb_chunks == 1);
+    success = success && (status[0].used == MAX_MEMORY);
+    success = success && (status[1].used == 16);
+    success = success && (status[2].nb_chunks == 0);
+    success = success && (status[0].resident > 0);
+
+    // The estimate of the master matches what slaves reported.
+    const auto& available = allocator.getMemoryStatus();
+    for (size_t i = 0; i < status.size(); ++i)
+      success = success && (available[i] == MAX_MEMORY - status[i].used);
+
+    int* read = allocator.read<int>(var);
+    return finishTest(success, allocator, var, read);
+  }
+
+  unsigned int
+  check_slack(Allocator& allocator)
+  {
+    std::vector<long> in({1, 2, 3, 4});
+    auto* var = allocator.reserve<long>(in.size(), &in[0]);
+
+    // The chunk is truncated, but keeps its capacity.
+    bool success = allocator.resize<long>(var, 1);
+    const auto& status = allocator.queryMemoryStatus();
+    success = success && (status[0].used == 4 * sizeof(long));
+    success = success && (status[0].slack == 3 * sizeof(long));
+
+    long* read = allocator.read<long>(var);
+    success = success && (read[0] == 1);
+
+    return finishTest(success, allocator, var, read);
+  }
+
+  unsigned int
+  check_free(Allocator& allocator)
+  {
+    // Replies to `free' already updated the status of every slave.
+    bool success = true;
+    for (const auto& status : allocator.getNodeStatus())
+      success = success && (status.nb_chunks == 0) && (status.used == 0);
+    for (const auto& bytes : allocator.getMemoryStatus())
+      success = success && (bytes == MAX_MEMORY);
+
+    return success;
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  tests_passed += check_usage(*allocator);
+  tests_passed += check_slack(*allocator);
+  tests_passed += check_free(*allocator);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 3, "> Memory status <");
+}
+
+int
+main(int argc, char** argv)
+{
+  algorep::init(argc, argv);
+
+  const auto& callback = std::function<void()>(run);
+  // Small memory per slave, to split the data on several slaves.
+  algorep::run(callback, MAX_MEMORY);
+
+  // This is in charge of liberating some allocated
+  // memory.
+  algorep::terminate();
+}
@@ -0,0 +1,139 @@
+#include <algorep.h>
+#include <cmath>
+#include <iostream>
+
+#include "utils/utils.h"
+
+namespace
+{
+  /**
+   * @brief Apply a stencil on the master, repeating the bounds.
+   */
+  template <typename T>
+  std::vector<T>
+  expected(std::vector<T> values, const std::vector<T>& weights,
+           size_t nb_steps)
+  {
+    const long h = weights.size() / 2;
+    const long n = values.size();
+    for (size_t step = 0; step < nb_steps; ++step)
+    {
+      std::vector<T> next(n);
+      for (long i = 0; i < n; ++i)
+      {
+        T acc = 0;
+        for (long k = 0; k < (long)weights.size(); ++k)
+          acc += weights[k] * values[std::min(std::max(i + k - h, 0L), n - 1)];
+        next[i] = acc;
+      }
+      values.swap(next);
+    }
+    return values;
+  }
+
+  unsigned int
+  check_in_place(Allocator& allocator)
+  {
+    std::vector<int> in(6000);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = (i * 7919) % 101 - 50;
+    auto* var = allocator.reserve<int>(in.size(), &in[0]);
+    if (var == nullptr) return 0;
+
+    const std::vector<int> weights({1, -2, 1});
+    bool success = var->getIds().size() > 1;
+    success = success && allocator.stencil(var, weights, 3);
+    auto* read = allocator.read(var);
+    success = success && std::vector<int>(read, read + in.size()) ==
+                             expected(in, weights, 3);
+
+    return finishTest<int>(success, allocator, var, read);
+  }
+
+  unsigned int
+  check_smoothing(Allocator& allocator)
+  {
+    std::vector<double> in(2000);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = (i % 100 < 50) ? 1 : -1;
+    // Split, so that every slave has room for its output chunk.
+    auto* var = reserveSplit(allocator, in);
+    if (var == nullptr) return 0;
+    auto* out = allocator.reserveLike<double>(var);
+    if (out == nullptr) return 0;
+
+    // Wide stencils exchange as many values as their half width.
+    const std::vector<double> weights({0.1, 0.2, 0.4, 0.2, 0.1});
+    bool success = var->getIds().size() > 1;
+    success = success && allocator.stencil(var, weights, 10, out);
+    const auto& ref = expected(in, weights, 10);
+    auto* read = allocator.read(out);
+    for (size_t i = 0; success && i < in.size(); ++i)
+      success = std::abs(read[i] - ref[i]) < 1e-12;
+    delete[] read;
+    allocator.free(out);
+
+    // The element read is left untouched.
+    read = allocator.read(var);
+    success = success && std::vector<double>(read, read + in.size()) == in;
+
+    return finishTest<double>(success, allocator, var, read);
+  }
+
+  unsigned int
+  check_single_chunk(Allocator& allocator)
+  {
+    std::vector<float> in({4, 8, 0, 2});
+    auto* var = allocator.reserve<float>(in.size(), &in[0]);
+    if (var == nullptr) return 0;
+
+    const std::vector<float> weights({0.5, 0, 0.5});
+    bool success = allocator.stencil(var, weights);
+    auto* read = allocator.read(var);
+    success = success && std::vector<float>(read, read + in.size()) ==
+                             std::vector<float>({6, 2, 5, 1});
+
+    return finishTest<float>(success, allocator, var, read);
+  }
+
+  unsigned int
+  check_invalid(Allocator& allocator)
+  {
+    std::vector<long> in(1500, 1);
+    auto* var = allocator.reserve<long>(in.size(), &in[0]);
+    auto* other = allocator.reserve<long>(in.size(), &in[0]);
+    if (var == nullptr || other == nullptr) return 0;
+
+    // Even number of weights, halo longer than a chunk, other slaves.
+    bool success = !allocator.stencil(var, std::vector<long>({1, 1}));
+    success = success && !allocator.stencil(
+                             var, std::vector<long>(2 * in.size() + 3, 1));
+    success = success && var->getIntIds() != other->getIntIds();
+    success = success && !allocator.stencil(var, {1, 1, 1}, 1, other);
+    allocator.free(other);
+
+    return finishTest<long>(success, allocator, var, nullptr);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  tests_passed += check_in_place(*allocator);
+  tests_passed += check_smoothing(*allocator);
+  tests_passed += check_single_chunk(*allocator);
+  tests_passed += check_invalid(*allocator);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 4, "> Stencil <");
+}
+
+int
+main(int argc, char** argv)
+{
+  return runSplit(argc, argv, run);
+}
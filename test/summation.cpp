@@ -0,0 +1,117 @@
+#include <algorep.h>
+#include <cmath>
+#include <iostream>
+
+#include "utils/utils.h"
+
+namespace
+{
+  unsigned int
+  check_reproducible(Allocator& allocator)
+  {
+    std::vector<double> in(2500);
+    for (size_t i = 0; i < in.size(); ++i)
+      in[i] = std::pow(10.0, (int)(i * 7 % 31) - 15) * ((i % 3) ? 1 : -1);
+
+    auto* var = allocator.reserve<double>(in.size(), &in[0]);
+    if (var == nullptr) return 0;
+    const double first = allocator.sum(var);
+    const auto bounds = var->getBounds();
+    allocator.free(var);
+
+    // The same values, split elsewhere, give the same bits.
+    auto* shift = allocator.reserveFilled<double>(700, 0);
+    var = allocator.reserve<double>(in.size(), &in[0]);
+    if (shift == nullptr || var == nullptr) return 0;
+    bool success = bounds.size() > 1 && var->getBounds() != bounds;
+    const double second = allocator.sum(var);
+    success = success && std::memcmp(&first, &second, sizeof(double)) == 0;
+    allocator.free(shift);
+
+    return finishTest<double>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_cancellation(Allocator& allocator)
+  {
+    std::vector<double> in(3000);
+    for (size_t i = 0; i < in.size(); i += 3)
+    {
+      in[i] = 1e16;
+      in[i + 1] = 1;
+      in[i + 2] = -1e16;
+    }
+    auto* var = allocator.reserve<double>(in.size(), &in[0]);
+    if (var == nullptr) return 0;
+
+    // A reduce loses every 1.
+    bool success = allocator.sum(var) == 1000;
+
+    return finishTest<double>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_float(Allocator& allocator)
+  {
+    std::vector<float> in(8000, 1e-8f);
+    in[0] = 1;
+    auto* var = allocator.reserve<float>(in.size(), &in[0]);
+    if (var == nullptr) return 0;
+
+    // Values are summed in double.
+    const double expected = 1 + 7999 * (double)1e-8f;
+    bool success = std::abs(allocator.sum(var) - expected) < 1e-7;
+
+    return finishTest<float>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_sparse(Allocator& allocator)
+  {
+    std::vector<size_t> indices;
+    std::vector<double> values;
+    std::vector<double> dense(2000, 0);
+    for (size_t i = 0; i < dense.size(); i += 7)
+    {
+      indices.push_back(i);
+      values.push_back(1.0 / (i + 1));
+      dense[i] = values.back();
+    }
+
+    // Zeros do not change the sum, whatever the storage.
+    auto* var = allocator.reserveSparse<double>(dense.size(), indices,
+                                                &values[0]);
+    auto* dense_var = allocator.reserve<double>(dense.size(), &dense[0]);
+    if (var == nullptr || dense_var == nullptr) return 0;
+    const double sparse_sum = allocator.sum(var);
+    const double dense_sum = allocator.sum(dense_var);
+    bool success = std::memcmp(&sparse_sum, &dense_sum, sizeof(double)) == 0;
+    allocator.free(dense_var);
+
+    return finishTest<double>(success, allocator, var, nullptr);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  tests_passed += check_reproducible(*allocator);
+  tests_passed += check_cancellation(*allocator);
+  tests_passed += check_float(*allocator);
+  tests_passed += check_sparse(*allocator);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 4, "> Reproducible sum <");
+}
+
+int
+main(int argc, char** argv)
+{
+  return runSplit(argc, argv, run);
+}
@@ -0,0 +1,175 @@
+#include <algorep.h>
+#include <iostream>
+
+#include "utils/utils.h"
+
+using namespace algorep::callback;
+
+namespace
+{
+  unsigned int
+  check_put_get(Allocator& allocator)
+  {
+    auto* table = allocator.reserveTable<int, double>();
+    if (table == nullptr) return 0;
+
+    std::vector<int> keys(600);
+    std::vector<double> values(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+      keys[i] = i * 7919 - 100000;
+      values[i] = i * 0.5;
+    }
+
+    // Every partition receives some of the keys.
+    bool success = allocator.put(table, keys, values);
+    success = success && table->getNbValues() == keys.size();
+    for (const auto& bounds : table->getBounds())
+      success = success && std::get<1>(bounds) + 1 > std::get<0>(bounds);
+
+    // The slaves reported the capacity the entries grew to.
+    size_t used = 0;
+    for (const auto& status : allocator.getNodeStatus()) used += status.used;
+    success = success && used >= keys.size() * table->getAtomSize();
+
+    std::vector<double> out;
+    std::vector<bool> found;
+    success = success && allocator.get(table, keys, out, found) == keys.size();
+    success = success && out == values;
+    success = success && found == std::vector<bool>(keys.size(), true);
+
+    return finishTest<algorep::Entry<int, double>>(success, allocator, table,
+                                                   nullptr);
+  }
+
+  unsigned int
+  check_overwrite_erase(Allocator& allocator)
+  {
+    auto* table = allocator.reserveTable<long, int>();
+    if (table == nullptr) return 0;
+
+    std::vector<long> keys(300);
+    std::vector<int> values(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+      keys[i] = i;
+      values[i] = i;
+    }
+    bool success = allocator.put(table, keys, values);
+
+    // Repeated keys keep their last value.
+    success = success && allocator.put<long, int>(table, {5, 5, 401},
+                                                  {-1, -2, 40});
+    success = success && table->getNbValues() == keys.size() + 1;
+
+    // Even keys are removed, the missing ones being ignored.
+    std::vector<long> even;
+    for (long key = 0; key < 302; key += 2) even.push_back(key);
+    success = success && allocator.erase(table, even) == 150;
+    success = success && table->getNbValues() == 151;
+
+    std::vector<int> out;
+    std::vector<bool> found;
+    keys.push_back(401);
+    success = success && allocator.get(table, keys, out, found) == 151;
+    for (size_t i = 0; success && i < keys.size(); ++i)
+    {
+      const long key = keys[i];
+      const int expected = (key == 5) ? -2 : (key == 401) ? 40 : key;
+      success = (key % 2 == 0) ? !found[i] && out[i] == 0
+                               : found[i] && out[i] == expected;
+    }
+
+    return finishTest<algorep::Entry<long, int>>(success, allocator, table,
+                                                 nullptr);
+  }
+
+  unsigned int
+  check_values(Allocator& allocator)
+  {
+    auto* table = allocator.reserveTable<unsigned int, long>();
+    if (table == nullptr) return 0;
+
+    std::vector<unsigned int> keys(200);
+    std::vector<long> values(keys.size());
+    long expected = 0;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+      keys[i] = i * 3;
+      values[i] = i % 50;
+      expected -= values[i];
+    }
+    bool success = allocator.put(table, keys, values);
+
+    // Values are a column, mapped and reduced as a field.
+    const auto& member = &algorep::Entry<unsigned int, long>::value;
+    allocator.mapField(table, member, MapID::L_NEGATE);
+    long* sum = allocator.reduceField(table, member, ReduceID::L_SUM);
+    success = success && sum && *sum == expected;
+    delete sum;
+
+    // Keys are left untouched.
+    std::vector<long> out;
+    std::vector<bool> found;
+    success = success && allocator.get(table, keys, out, found) == keys.size();
+    for (size_t i = 0; success && i < keys.size(); ++i)
+      success = out[i] == -values[i];
+
+    long* read = allocator.readField(table, member);
+    long read_sum = 0;
+    for (size_t i = 0; read && i < keys.size(); ++i) read_sum += read[i];
+    success = success && read && read_sum == expected;
+    delete[] read;
+
+    return finishTest<algorep::Entry<unsigned int, long>>(success, allocator,
+                                                          table, nullptr);
+  }
+
+  unsigned int
+  check_missing(Allocator& allocator)
+  {
+    auto* table = allocator.reserveTable<short, float>();
+    if (table == nullptr) return 0;
+
+    // Empty tables find nothing, and erase nothing.
+    std::vector<float> out;
+    std::vector<bool> found;
+    bool success = allocator.get<short, float>(table, {1, 2}, out, found) == 0;
+    success = success && found == std::vector<bool>({false, false});
+    success = success && allocator.erase<short, float>(table, {1}) == 0;
+
+    success = success && allocator.put<short, float>(table, {-3}, {1.5});
+    success = success && allocator.get<short, float>(table, {2, -3}, out,
+                                                     found) == 1;
+    success = success && out == std::vector<float>({0, 1.5});
+    success = success && found == std::vector<bool>({false, true});
+    success = success && table->getNbValues() == 1;
+
+    return finishTest<algorep::Entry<short, float>>(success, allocator, table,
+                                                    nullptr);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  tests_passed += check_put_get(*allocator);
+  tests_passed += check_overwrite_erase(*allocator);
+  tests_passed += check_values(*allocator);
+  tests_passed += check_missing(*allocator);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 4, "> Table <");
+}
+
+int
+main(int argc, char** argv)
+{
+  return runSplit(argc, argv, run);
+}
@@ -0,0 +1,153 @@
+#include <algorep.h>
+#include <algorithm>
+#include <iostream>
+
+#include "utils/utils.h"
+
+namespace
+{
+  template <typename T>
+  bool
+  check_top(Allocator& allocator, const algorep::Element<T>* var,
+            const std::vector<T>& in, size_t k, bool largest)
+  {
+    std::vector<size_t> indices;
+    std::vector<T> values;
+    allocator.topK(var, k, indices, values, largest);
+
+    // Sorting every value gives the same result, the first position
+    // winning on equal values.
+    std::vector<size_t> order(in.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return (largest) ? in[a] > in[b] : in[a] < in[b];
+    });
+
+    bool success = indices.size() == std::min(k, in.size());
+    for (size_t i = 0; success && i < indices.size(); ++i)
+      success = indices[i] == order[i] && values[i] == in[order[i]];
+    return success;
+  }
+
+  unsigned int
+  check_top_k(Allocator& allocator)
+  {
+    std::vector<int> in(6000);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = (i * 7919) % 1009 - 500;
+    auto* var = allocator.reserve<int>(in.size(), &in[0]);
+    if (var == nullptr) return 0;
+
+    // Values are repeated, ties are broken by position.
+    bool success = var->getIds().size() > 1;
+    success = success && check_top(allocator, var, in, 10, true);
+    success = success && check_top(allocator, var, in, 10, false);
+    success = success && check_top(allocator, var, in, 1, true);
+
+    return finishTest<int>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_small(Allocator& allocator)
+  {
+    std::vector<double> in({3.5, -1, 8, 2});
+    auto* var = allocator.reserve<double>(in.size(), &in[0]);
+    if (var == nullptr) return 0;
+
+    // Asking for more values than available gives every value.
+    bool success = check_top(allocator, var, in, 10, true);
+
+    std::vector<size_t> indices;
+    std::vector<double> values;
+    allocator.topK(var, 0, indices, values);
+    success = success && indices.empty() && values.empty();
+
+    return finishTest<double>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_sparse(Allocator& allocator)
+  {
+    std::vector<size_t> indices({10, 20, 400, 999});
+    std::vector<long> values({-5, 8, -2, -9});
+    auto* var = allocator.reserveSparse<long>(1000, indices, &values[0]);
+    if (var == nullptr) return 0;
+
+    // Zeros are among the largest values.
+    std::vector<long> dense(1000, 0);
+    for (size_t i = 0; i < indices.size(); ++i) dense[indices[i]] = values[i];
+    bool success = check_top(allocator, var, dense, 4, true);
+    success = success && check_top(allocator, var, dense, 3, false);
+
+    return finishTest<long>(success, allocator, var, nullptr);
+  }
+
+  unsigned int
+  check_sketch()
+  {
+    // Two sketches merged after being sent.
+    algorep::QuantileSketch a(100);
+    algorep::QuantileSketch b(100);
+    for (size_t i = 0; i < 50000; ++i) ((i % 2) ? a : b).add(i);
+    b.add(7, 3);
+
+    std::vector<uint8_t> bytes;
+    b.serialize(bytes);
+    algorep::QuantileSketch received;
+    bool success = received.deserialize(&bytes[0], bytes.size());
+    success = success && !received.deserialize(&bytes[0], bytes.size() - 1);
+    a.merge(received);
+
+    success = success && a.getCount() == 50003;
+    success = success && a.getSize() < 1000;
+    const double median = a.quantile(0.5);
+    success = success && median > 25000 - 1000 && median < 25000 + 1000;
+    success = success && a.quantile(0) >= 0 && a.quantile(1) <= 49999;
+    return success && algorep::QuantileSketch().quantile(0.5) == 0;
+  }
+
+  unsigned int
+  check_quantiles(Allocator& allocator)
+  {
+    std::vector<float> in(8000);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = (i * 4001) % in.size();
+    auto* var = allocator.reserve<float>(in.size(), &in[0]);
+    if (var == nullptr) return 0;
+
+    // Ranks are estimated within 2% of the number of values.
+    const auto& sketch = allocator.sketch(var);
+    bool success = sketch.getCount() == in.size();
+    success = success && sketch.getSize() < in.size() / 4;
+    for (double q : {0.5, 0.9, 0.99})
+    {
+      const double rank = sketch.quantile(q);
+      success = success && std::abs(rank - q * in.size()) < in.size() / 50;
+    }
+
+    return finishTest<float>(success, allocator, var, nullptr);
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  tests_passed += check_top_k(*allocator);
+  tests_passed += check_small(*allocator);
+  tests_passed += check_sparse(*allocator);
+  tests_passed += check_sketch();
+  tests_passed += check_quantiles(*allocator);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 5, "> Top-k and quantiles <");
+}
+
+int
+main(int argc, char** argv)
+{
+  return runSplit(argc, argv, run);
+}
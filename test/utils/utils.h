@@ -45,6 +45,61 @@ namespace
     allocator.free(var);
     return !!success;
   }
+
+  /**
+   * @brief Memory of the slaves of the tests splitting their elements. An
+   * array of a few thousand values spans several slaves.
+   */
+  constexpr size_t SMALL_MEMORY = 16384;
+
+  /**
+   * @brief Allocate values split evenly between the slaves, so that each
+   * one has room left for an element placed as this one.
+   *
+   * @tparam T Type of element.
+   * @param allocator Allocator of the test.
+   * @param values Values to allocate.
+   *
+   * @return Element allocated, nullptr if the network is full or if the
+   * values could not be split.
+   */
+  template <typename T>
+  algorep::Element<T>*
+  reserveSplit(Allocator& allocator, const std::vector<T>& values)
+  {
+    auto* var = allocator.reserve<T>(values.size(), &values[0]);
+    if (var == nullptr) return nullptr;
+    if (!allocator.repartition(var, algorep::Layout::BALANCED))
+    {
+      allocator.free(var);
+      return nullptr;
+    }
+    return var;
+  }
+}
+
+/**
+ * @brief Run tests on slaves having `SMALL_MEMORY`, so that elements are
+ * split on several of them.
+ *
+ * @param argc Number of arguments of the program.
+ * @param argv Arguments of the program.
+ * @param run Tests to run on the master.
+ *
+ * @return Exit code of the program.
+ */
+inline int
+runSplit(int argc, char** argv, void (*run)())
+{
+  algorep::init(argc, argv);
+
+  const auto& callback = std::function<void()>(run);
+  algorep::run(callback, SMALL_MEMORY);
+
+  // This is in charge of liberating some allocated
+  // memory.
+  algorep::terminate();
+  return 0;
 }
 
 /**
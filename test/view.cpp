@@ -0,0 +1,98 @@
+#include <algorep.h>
+#include <iostream>
+
+#include "utils/utils.h"
+
+using namespace algorep::callback;
+
+namespace
+{
+  unsigned int
+  check_typed_phases(Allocator& allocator)
+  {
+    constexpr size_t SIZE = 10;
+    auto* bytes = allocator.reserveBytes(SIZE * sizeof(double), sizeof(double));
+    if (!bytes) return 0;
+
+    // First phase, the scratch memory is used as doubles.
+    std::vector<double> doubles(SIZE);
+    for (size_t i = 0; i < SIZE; ++i) doubles[i] = i * 0.5;
+
+    auto* as_double = allocator.view<double>(bytes);
+    bool success = allocator.write<double>(as_double, &doubles[0]);
+    double* read_double = allocator.read<double>(as_double);
+    for (size_t i = 0; i < SIZE; ++i)
+      success = success && (read_double[i] == doubles[i]);
+    delete[] read_double;
+    allocator.free(as_double);
+
+    // Second phase, the same memory is used as integers.
+    std::vector<int> ints(SIZE * 2);
+    for (size_t i = 0; i < ints.size(); ++i) ints[i] = i;
+
+    auto* as_int = allocator.view<int>(bytes);
+    success = success && allocator.write<int>(as_int, &ints[0]);
+    allocator.map<int>(as_int, MapID::I_NEGATE);
+    int* read_int = allocator.read<int>(as_int);
+    for (size_t i = 0; i < ints.size(); ++i)
+      success = success && (read_int[i] == -ints[i]);
+    delete[] read_int;
+    allocator.free(as_int);
+
+    allocator.free(bytes);
+    return !!success;
+  }
+
+  unsigned int
+  check_alignment(Allocator& allocator)
+  {
+    // Shifts the free memory of the first slave by a few bytes.
+    auto* shift = allocator.reserveFilled<int>(1, 0);
+
+    auto* unaligned = allocator.reserveBytes(80, 1);
+    auto* aligned = allocator.reserveBytes(80, sizeof(double));
+
+    auto* unaligned_view = allocator.view<double>(unaligned);
+    auto* aligned_view = allocator.view<double>(aligned);
+
+    bool success = (unaligned_view == nullptr) && (aligned_view != nullptr);
+    success = success && (aligned_view->getNbValues() == 10);
+
+    if (aligned_view) allocator.free(aligned_view);
+    allocator.free(aligned);
+    allocator.free(unaligned);
+    allocator.free(shift);
+
+    return !!success;
+  }
+}
+
+void
+run()
+{
+  auto* allocator = Allocator::instance();
+  unsigned int tests_passed = 0;
+
+  tests_passed += check_typed_phases(*allocator);
+  tests_passed += check_alignment(*allocator);
+
+  // Super important call, forgeting this will make
+  // the slaves wait indefinitely.
+  algorep::finalize();
+
+  summary(tests_passed, 2, "> Byte allocation and views <");
+}
+
+int
+main(int argc, char** argv)
+{
+  algorep::init(argc, argv);
+
+  const auto& callback = std::function<void()>(run);
+  // Small memory per slave, to split the data on several slaves.
+  algorep::run(callback, 64);
+
+  // This is in charge of liberating some allocated
+  // memory.
+  algorep::terminate();
+}